@@ -96,8 +96,6 @@ if (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
 		>
 
 		/openmp	# -> enable openmp
-		/arch:AVX
-		/arch:AVX2
 		# No manual c++11 enable for MSVC as all supported MSVC versions for cmake-init have C++11 implicitly enabled (MSVC >=2013)
 	)
 endif ()
@@ -109,14 +107,37 @@ if (CMAKE_CXX_COMPILER_ID MATCHES "GNU" OR CMAKE_CXX_COMPILER_ID MATCHES "Clang"
 		-Wno-missing-braces
 		-mveclibabi=svml
 		-fopenmp
-		-mavx
-		-mavx2
 		${WARN_AS_ERROR_FLAGS}
 		-std=c++1z
-		-O0
 	)
 endif ()
 
+# Options for the AVX2 baseline. Every translation unit is compiled with them
+# except detection of the instruction set, which has to run on processors
+# without AVX2 to report that they are not supported
+set(AVX2_COMPILE_OPTIONS)
+if (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
+	set(AVX2_COMPILE_OPTIONS /arch:AVX2)
+elseif (CMAKE_CXX_COMPILER_ID MATCHES "GNU" OR CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+	set(AVX2_COMPILE_OPTIONS -mavx -mavx2 -mfma)
+endif ()
+
+# Options for translation units holding kernels of instruction sets wider
+# than the baseline. Those kernels are only called if cpuid reports support
+set(AVX512_COMPILE_FLAGS)
+if (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
+	set(AVX512_COMPILE_FLAGS /arch:AVX512)
+elseif (CMAKE_CXX_COMPILER_ID MATCHES "GNU" OR CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+	set(AVX512_COMPILE_FLAGS -mavx512f)
+endif ()
+
+set(AVX512VNNI_COMPILE_FLAGS)
+if (CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
+	set(AVX512VNNI_COMPILE_FLAGS /arch:AVX512)
+elseif (CMAKE_CXX_COMPILER_ID MATCHES "GNU" OR CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+	set(AVX512VNNI_COMPILE_FLAGS "-mavx512f -mavx512vnni")
+endif ()
+
 #
 # Linker options
 #
@@ -130,7 +151,7 @@ if (CMAKE_CXX_COMPILER_ID MATCHES "GNU" OR CMAKE_SYSTEM_NAME MATCHES "Linux")
 		-lstdc++fs
 		-mavx
 		-mavx2
+		-mfma
 		-fopenmp
-		-O0
 	)
 endif()
\ No newline at end of file
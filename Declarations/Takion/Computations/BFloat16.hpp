@@ -0,0 +1,61 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_BFLOAT16_HPP
+#define TAKION_COMPUTE_BFLOAT16_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace Takion::Compute
+{
+//! Brain floating point number stored in 16 bits
+//! Holds upper half of IEEE single precision float, so it has the range of
+//! float with 8 bits of mantissa. Used only for storage, every computation
+//! converts it to float first
+struct BFloat16
+{
+    std::uint16_t Bits = 0;
+
+    BFloat16() = default;
+
+    //! Rounds to nearest even. NaN stays NaN
+    BFloat16(float value)
+        : Bits(Round(value))
+    {
+    }
+
+    operator float() const
+    {
+        const std::uint32_t bits = static_cast<std::uint32_t>(Bits) << 16;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    static std::uint16_t Round(float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        //! Rounding could carry NaN into infinity, so its mantissa is kept
+        if ((bits & 0x7fffffffu) > 0x7f800000u)
+            return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+        bits += 0x7fffu + ((bits >> 16) & 1u);
+        return static_cast<std::uint16_t>(bits >> 16);
+    }
+};
+
+//! Type weights are stored in memory
+//! BFloat16 halves memory traffic of the weights, while computations and
+//! updates by optimizers stay in float
+enum class StorageType
+{
+    Float32,
+    BFloat16,
+};
+} // namespace Takion::Compute
+
+#endif
@@ -6,6 +6,7 @@
 
 #ifndef TAKION_DEVICE_HPP
 #define TAKION_DEVICE_HPP
+#include <Takion/Computations/InstructionSet.hpp>
 #include <string>
 
 namespace Takion::Compute
@@ -48,11 +49,25 @@ public:
         return m_padByteSize;
     }
 
+    //! Instruction set CPU kernels use for tensors on this device
+    //! Defaults to the widest one the machine supports
+    [[nodiscard]] Compute::InstructionSet InstructionSet() const
+    {
+        return m_instructionSet;
+    }
+
+    //! Overrides the instruction set of CPU device, and pads the columns of
+    //! tensors to its vector width
+    //! Tensors which are already created keep the padding of the device they
+    //! were created with
+    void SetInstructionSet(Compute::InstructionSet instructionSet);
+
 private:
     int m_id = -1;
     DeviceType m_type = DeviceType::CPU;
     std::string m_name = "Undefined";
     std::size_t m_padByteSize = 0;
+    Compute::InstructionSet m_instructionSet = Compute::InstructionSet::AVX2;
 };
 }
 
@@ -0,0 +1,66 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_CONVOLUTION_HPP
+#define TAKION_COMPUTE_CONVOLUTION_HPP
+
+#include <cstddef>
+
+namespace Takion::Compute
+{
+//! Geometry of 2D convolution over (channel, height, width) tensors
+//! Input is padded with PaddingHeight and PaddingWidth zeros on both sides,
+//! and kernel elements are Dilation apart
+struct Conv2DGeometry
+{
+    std::size_t InputChannels = 0;
+    std::size_t InputHeight = 0;
+    std::size_t InputWidth = 0;
+    std::size_t KernelHeight = 1;
+    std::size_t KernelWidth = 1;
+    std::size_t StrideHeight = 1;
+    std::size_t StrideWidth = 1;
+    std::size_t PaddingHeight = 0;
+    std::size_t PaddingWidth = 0;
+    std::size_t DilationHeight = 1;
+    std::size_t DilationWidth = 1;
+
+    //! Returns 0 if the dilated kernel does not fit in the padded input
+    [[nodiscard]] std::size_t OutputHeight() const
+    {
+        return m_outputSize(InputHeight, KernelHeight, StrideHeight,
+                            PaddingHeight, DilationHeight);
+    }
+
+    [[nodiscard]] std::size_t OutputWidth() const
+    {
+        return m_outputSize(InputWidth, KernelWidth, StrideWidth,
+                            PaddingWidth, DilationWidth);
+    }
+
+    //! Number of input elements each output pixel reads from
+    //! (rows of the im2col matrix)
+    [[nodiscard]] std::size_t PatchSize() const
+    {
+        return InputChannels * KernelHeight * KernelWidth;
+    }
+
+private:
+    static std::size_t m_outputSize(std::size_t inputSize,
+                                    std::size_t kernelSize,
+                                    std::size_t stride, std::size_t padding,
+                                    std::size_t dilation)
+    {
+        const auto paddedSize = inputSize + 2 * padding;
+        const auto dilatedKernelSize = dilation * (kernelSize - 1) + 1;
+        if (stride == 0 || kernelSize == 0 || paddedSize < dilatedKernelSize)
+            return 0;
+        return (paddedSize - dilatedKernelSize) / stride + 1;
+    }
+};
+} // namespace Takion::Compute
+
+#endif
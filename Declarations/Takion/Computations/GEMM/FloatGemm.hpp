@@ -7,11 +7,93 @@
 #ifndef TAKION_COMPUTE_FLOATGEMM_HPP
 #define TAKION_COMPUTE_FLOATGEMM_HPP
 
+#include <Takion/Computations/BFloat16.hpp>
+#include <Takion/Computations/GEMM/Convolution.hpp>
+#include <Takion/Computations/GEMM/GemmTuner.hpp>
+#include <Takion/Computations/InstructionSet.hpp>
 #include <Takion/Utils/Span.hpp>
+#include <Takion/Utils/Declarations.hpp>
 
 namespace Takion::Compute::CPU::Float
 {
 using namespace Util;
+
+//! Computes out = op(A) * op(B) for numMatrices (m x k) * (k x n) products
+//! lda, ldb and ldc are row strides of A, B and out as they are stored in
+//! memory, strideA and strideB are offsets between consecutive matrices
+//! (0 broadcasts the operand to every product)
+//! instructionSet selects the micro kernel computing the register tiles
+void GemmCpu(const Span<float> inputA, const Span<float> inputB,
+             Span<float> out, std::size_t m, std::size_t n, std::size_t k,
+             std::size_t lda, std::size_t ldb, std::size_t ldc,
+             std::size_t strideA, std::size_t strideB, std::size_t numMatrices,
+             TransposeOp op, InstructionSet instructionSet);
+
+//! Computes out = activation(op(A) * op(B) + bias) with the same layout as
+//! GemmCpu. bias is a row of n elements added to every row of out
+//! Bias and activation are applied while each tile of out is still in
+//! registers (supports Linear, Relu (leaky, as Graph::ReLU) and Sigmoid)
+void GemmBiasActivationCpu(const Span<float> inputA, const Span<float> inputB,
+                           const Span<float> bias, Span<float> out,
+                           std::size_t m, std::size_t n, std::size_t k,
+                           std::size_t lda, std::size_t ldb, std::size_t ldc,
+                           std::size_t strideA, std::size_t strideB,
+                           std::size_t numMatrices, TransposeOp op,
+                           Activation activation,
+                           InstructionSet instructionSet);
+
+//! Computes out = scale * sum of op(A) * op(B) over numMatrices products
+//! with the same layout as GemmCpu. Every product is accumulated into the
+//! single matrix out, so batches are reduced without storing the product
+//! of each matrix. Scale is applied while the last product is written back
+void GemmReduceCpu(const Span<float> inputA, const Span<float> inputB,
+                   Span<float> out, std::size_t m, std::size_t n,
+                   std::size_t k, std::size_t lda, std::size_t ldb,
+                   std::size_t ldc, std::size_t strideA, std::size_t strideB,
+                   std::size_t numMatrices, float scale, TransposeOp op,
+                   InstructionSet instructionSet);
+
+//! GemmCpu and GemmBiasActivationCpu with B stored in bfloat16
+//! B is converted to float while its panels are packed, so products are
+//! computed in float and only memory traffic of B is halved
+void GemmCpu(const Span<float> inputA, const Span<BFloat16> inputB,
+             Span<float> out, std::size_t m, std::size_t n, std::size_t k,
+             std::size_t lda, std::size_t ldb, std::size_t ldc,
+             std::size_t strideA, std::size_t strideB, std::size_t numMatrices,
+             TransposeOp op, InstructionSet instructionSet);
+
+void GemmBiasActivationCpu(const Span<float> inputA,
+                           const Span<BFloat16> inputB,
+                           const Span<float> bias, Span<float> out,
+                           std::size_t m, std::size_t n, std::size_t k,
+                           std::size_t lda, std::size_t ldb, std::size_t ldc,
+                           std::size_t strideA, std::size_t strideB,
+                           std::size_t numMatrices, TransposeOp op,
+                           Activation activation,
+                           InstructionSet instructionSet);
+
+//! Benchmarks blockings of GemmCpu on the shape class of given product and
+//! keeps the fastest one for the following products (see GemmTuner.hpp)
+//! Operands are allocated for the benchmark, so no tensor is touched
+//! Shape classes which were already tuned are not benchmarked again
+//! \param broadcastB : true if every product shares single matrix B
+//! Returns blocking the shape class uses afterwards
+GemmBlocking TuneGemmCpu(std::size_t m, std::size_t n, std::size_t k,
+                         std::size_t numMatrices, bool broadcastB,
+                         TransposeOp op, InstructionSet instructionSet);
+
+//! Converts numRow rows of numCol elements between float and bfloat16
+//! Floats are rounded to nearest even
+//! \param ldIn : distance between rows of input (padded column size)
+//! \param ldOut : distance between rows of output (padded column size)
+void ConvertToBFloat16Cpu(const Span<float> input, Span<BFloat16> output,
+                          std::size_t numRow, std::size_t numCol,
+                          std::size_t ldIn, std::size_t ldOut);
+
+void ConvertFromBFloat16Cpu(const Span<BFloat16> input, Span<float> output,
+                            std::size_t numRow, std::size_t numCol,
+                            std::size_t ldIn, std::size_t ldOut);
+
 void MultiplyCpu(const Span<float> inputA, const Span<float> inputB,
                  Span<float> out, std::size_t numRowA, std::size_t numColA,
                  std::size_t numRowB, std::size_t numColB,
@@ -23,8 +105,58 @@ void MultiplyWithBroadcastCpu(const Span<float> inputA,
                               std::size_t numRowB, std::size_t numColB,
                               std::size_t numMatrices, bool broadCastA);
 
+//! Transposes numMatrices consecutive numRow x numCol matrices
+//! Matrices are split into tiles which are transposed in parallel using
+//! 8x8 register transposes
+//! \param ldIn : distance between rows of input (padded column size)
+//! \param ldOut : distance between rows of output (padded column size)
+void TransposeCpu(const Span<float> input, Span<float> output,
+                  std::size_t numRow, std::size_t numCol, std::size_t ldIn,
+                  std::size_t ldOut, std::size_t numMatrices);
+
+//! Writes mean of input over the batch to output
+//! Columns are reduced in parallel blocks, and the batch is also split
+//! between threads if there are not enough columns
+//! \param deterministic : if true, the result is bit-identical regardless
+//! of the number of threads
 void ShrinkCpu(const Span<float> input, Span<float> output, std::size_t size,
-               std::size_t batchSize);
+               std::size_t batchSize, bool deterministic);
+
+//! Writes patches of every sample to its column matrix for convolution
+//! as GEMM. Column matrix of a sample has PatchSize rows of
+//! (OutputHeight * ldOutput) elements, and column (y * ldOutput + x) holds
+//! the patch of output pixel (y, x). Columns of the output row padding are
+//! zero, so GEMM writes zeros to the padding of the output
+//! \param ldInput : distance between rows of input (padded width)
+//! \param ldOutput : distance between rows of output (padded width)
+void Im2ColCpu(const Span<float> input, Span<float> column,
+               const Conv2DGeometry& geometry, std::size_t ldInput,
+               std::size_t ldOutput, std::size_t batchSize);
+
+//! Adds every element of the column matrices back to the input pixel it
+//! was read from, overwriting input (layout of Im2ColCpu)
+void Col2ImCpu(const Span<float> column, Span<float> input,
+               const Conv2DGeometry& geometry, std::size_t ldInput,
+               std::size_t ldOutput, std::size_t batchSize);
+
+//! Computes data = activation(data + bias[channel]) for every sample of
+//! numChannel planes with numRow rows of numCol elements ld apart
+//! (supports Linear, Relu (leaky, as Graph::ReLU) and Sigmoid)
+void ChannelBiasActivationCpu(Span<float> data, const Span<float> bias,
+                              std::size_t numChannel, std::size_t numRow,
+                              std::size_t numCol, std::size_t ld,
+                              std::size_t batchSize, Activation activation);
+
+//! Writes sum of each channel over its plane, averaged over the batch
+//! Layout is the same as ChannelBiasActivationCpu
+void ShrinkChannelCpu(const Span<float> input, Span<float> output,
+                      std::size_t numChannel, std::size_t numRow,
+                      std::size_t numCol, std::size_t ld,
+                      std::size_t batchSize);
+
+//! Sets padding after the first numCol elements of each row to zero
+void ClearPaddingCpu(Span<float> data, std::size_t numRow, std::size_t numCol,
+                     std::size_t ld);
 
 void AddCpu(const Span<float> inputA, const Span<float> inputB, Span<float> out,
             std::size_t size, std::size_t batchSize);
@@ -60,8 +192,66 @@ void ScalarMulCpu(const Span<float> input, float toMul, Span<float> out,
 void ScalarDivCpu(const Span<float> input, float toDiv, Span<float> out,
                          std::size_t size, std::size_t batchSize);
 
+//! Applies SGD update to size elements of tensor in a single pass
+//! update is the descent direction (negative gradient) computed by units
+//! With weight decay, descent direction becomes (update - weightDecay * w)
+//! velocity is read and written only if momentum is not 0
+void SgdUpdateCpu(Span<float> tensor, const Span<float> update,
+                  Span<float> velocity, std::size_t size, float learningRate,
+                  float momentum, bool nesterov, float weightDecay);
+
+//! Applies Adam update to size elements of tensor in a single pass, reading
+//! the update and both moments once and writing the tensor and the moments
+//! once
+//! \param step : number of updates including this one, for bias correction
+//! \param decoupledWeightDecay : if true, weight decay is applied to the
+//! tensor directly (AdamW), otherwise it is added to the gradient
+void AdamUpdateCpu(Span<float> tensor, const Span<float> update,
+                   Span<float> firstMoment, Span<float> secondMoment,
+                   std::size_t size, float learningRate, float beta1,
+                   float beta2, float epsilon, float weightDecay,
+                   bool decoupledWeightDecay, std::size_t step);
+
 void SetCpu(Span<float> data, float toSet, std::size_t size,
             std::size_t batchSize);
+
+//! Elementwise transcendental functions evaluated with Compute::Vector
+//! (see VectorMath.hpp for their error bounds)
+void ExpCpu(const Span<float> input, Span<float> out, std::size_t size,
+            std::size_t batchSize);
+
+void LogCpu(const Span<float> input, Span<float> out, std::size_t size,
+            std::size_t batchSize);
+
+void SigmoidCpu(const Span<float> input, Span<float> out, std::size_t size,
+                std::size_t batchSize);
+
+void TanhCpu(const Span<float> input, Span<float> out, std::size_t size,
+             std::size_t batchSize);
+
+//! Computes softmax over every batch, which holds numRow rows of numCol
+//! elements stored colSize apart
+//! Maximum of the batch is subtracted before exponentiation
+void SoftMaxCpu(const Span<float> input, Span<float> out, std::size_t numCol,
+                std::size_t colSize, std::size_t numRow, std::size_t batchSize);
+
+//! Computes probability = softmax(logit) over every batch and returns
+//! cross entropy -sum(label * log(probability)) summed over the batch
+//! Each batch holds numRow rows of numCol elements stored colSize apart
+//! Log-sum-exp is computed after subtracting maximum of the batch, so large
+//! logits do not overflow
+float SoftMaxCrossEntropyCpu(const Span<float> logit, const Span<float> label,
+                             Span<float> probability, std::size_t numCol,
+                             std::size_t colSize, std::size_t numRow,
+                             std::size_t batchSize);
+
+//! Computes out = label - sum(label) * probability for every batch with the
+//! layout of SoftMaxCrossEntropyCpu
+//! (negative gradient of the cross entropy with respect to the logits)
+void SoftMaxCrossEntropyGradientCpu(const Span<float> probability,
+                                    const Span<float> label, Span<float> out,
+                                    std::size_t numCol, std::size_t colSize,
+                                    std::size_t numRow, std::size_t batchSize);
 }
 
 #endif
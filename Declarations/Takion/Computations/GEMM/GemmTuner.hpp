@@ -0,0 +1,81 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_GEMMTUNER_HPP
+#define TAKION_COMPUTE_GEMMTUNER_HPP
+
+#include <Takion/Computations/InstructionSet.hpp>
+#include <Takion/Utils/Declarations.hpp>
+#include <cstddef>
+#include <string>
+
+//! Blocking parameters of float GEMM tuned for each class of shapes
+//! Tuned blockings are kept for the whole process and can be stored in a
+//! cache file, so later runs on the same processor skip the benchmarks
+//! Shapes which were never tuned use the default blocking
+namespace Takion::Compute::CPU::Float
+{
+//! Cache blocking and thread partitioning of float GEMM
+//! MC and NC should be multiples of MR and NR of the micro kernel, otherwise
+//! the default blocking is used instead
+struct GemmBlocking
+{
+    std::size_t MC = 96;
+    std::size_t KC = 256;
+    std::size_t NC = 4096;
+    //! If true, independent products of a batch are distributed between
+    //! threads, otherwise every product is computed by all threads
+    bool ParallelOverMatrices = false;
+};
+
+//! Shapes sharing blocking parameters
+//! Dimensions are rounded up to power of two, and stored as its exponent
+struct GemmShapeClass
+{
+    InstructionSet TargetInstructionSet = InstructionSet::AVX2;
+    TransposeOp Op = TransposeOp::NN;
+    std::size_t LogM = 0;
+    std::size_t LogN = 0;
+    std::size_t LogK = 0;
+    std::size_t LogNumMatrices = 0;
+
+    bool operator<(const GemmShapeClass& other) const;
+    bool operator==(const GemmShapeClass& other) const;
+};
+
+GemmShapeClass ClassifyGemm(std::size_t m, std::size_t n, std::size_t k,
+                            std::size_t numMatrices, TransposeOp op,
+                            InstructionSet instructionSet);
+
+//! Blocking used for shapes which were not tuned
+//! Batches are distributed between threads if every thread gets a product
+GemmBlocking DefaultGemmBlocking(std::size_t numMatrices);
+
+//! Returns tuned blocking of the shape class, or the default blocking if
+//! it was not tuned
+GemmBlocking GetGemmBlocking(const GemmShapeClass& shapeClass,
+                             std::size_t numMatrices);
+
+bool IsGemmTuned(const GemmShapeClass& shapeClass);
+
+void SetGemmBlocking(const GemmShapeClass& shapeClass,
+                     const GemmBlocking& blocking);
+
+//! Removes every tuned blocking
+void ClearGemmBlocking();
+
+//! Reads blockings tuned on this processor with the current number of
+//! OpenMP threads from the cache file
+//! Entries of other processors or thread counts are ignored
+//! Returns number of blockings read, 0 if the file does not exist
+std::size_t LoadGemmTuningCache(const std::string& path);
+
+//! Writes every tuned blocking to the cache file under this processor and
+//! number of threads, keeping entries of the others
+void SaveGemmTuningCache(const std::string& path);
+} // namespace Takion::Compute::CPU::Float
+
+#endif
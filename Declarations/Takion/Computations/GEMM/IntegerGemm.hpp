@@ -7,12 +7,22 @@
 #ifndef TAKION_COMPUTE_INTEGERGEMM_HPP
 #define TAKION_COMPUTE_INTEGERGEMM_HPP
 #include <Takion/Utils/Span.hpp>
+#include <Takion/Utils/Declarations.hpp>
 
 
 namespace Takion::Compute::CPU::Int
 {
 using namespace Util;
 
+//! Computes out = op(A) * op(B) for numMatrices (m x k) * (k x n) products
+//! lda, ldb and ldc are row strides of A, B and out as they are stored in
+//! memory, strideA and strideB are offsets between consecutive matrices
+//! (0 broadcasts the operand to every product)
+void GemmCpu(const Span<int> inputA, const Span<int> inputB, Span<int> out,
+             std::size_t m, std::size_t n, std::size_t k, std::size_t lda,
+             std::size_t ldb, std::size_t ldc, std::size_t strideA,
+             std::size_t strideB, std::size_t numMatrices, TransposeOp op);
+
 void MultiplyCpu(const Span<int> inputA, const Util::Span<int> inputB,
                  Span<int> out,
                  std::size_t numRowA, std::size_t numColA, std::size_t numRowB,
@@ -24,10 +34,14 @@ void MultiplyWithBroadcastCpu(const Span<int> inputA, const Span<int> inputB,
                               std::size_t numColB, std::size_t numMatrices,
                               bool broadCastA);
 
-void CpuTranspose(const Span<int> input, Span<int> output,
-                  std::size_t numRowInput, std::size_t numColInput,
-                  std::size_t batchSize);
+//! Transposes numMatrices consecutive numRow x numCol matrices
+//! \param ldIn : distance between rows of input (padded column size)
+//! \param ldOut : distance between rows of output (padded column size)
+void TransposeCpu(const Span<int> input, Span<int> output,
+                  std::size_t numRow, std::size_t numCol, std::size_t ldIn,
+                  std::size_t ldOut, std::size_t numMatrices);
 
+//! Writes mean of input over the batch to output
 void ShrinkCpu(const Span<int> input, Span<int> output, std::size_t size,
                std::size_t batchSize);
 
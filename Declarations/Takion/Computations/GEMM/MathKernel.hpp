@@ -9,177 +9,407 @@
 
 #include <Takion/Computations/GEMM/FloatGemm.hpp>
 #include <Takion/Computations/GEMM/IntegerGemm.hpp>
+#include <Takion/Computations/GEMM/QuantizedGemm.hpp>
+#include <Takion/Computations/Vector/Packet.hpp>
 #include <Takion/Tensors/Tensor.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <type_traits>
+#include <utility>
 
 namespace Takion::Compute
 {
-template <typename T>
-void MultiplyAdd(const Tensor<T>& A, const Tensor<T>& B, const Tensor<T>& C,
-                 Tensor<T>& out)
+//! Dimensions and strides of batched matrix product passed to GEMM backends
+struct GemmDimension
 {
-    const auto device = out.Device;
-    const auto outputShape = out.TensorShape;
+    std::size_t M = 0;
+    std::size_t N = 0;
+    std::size_t K = 0;
+    std::size_t StrideA = 0;
+    std::size_t StrideB = 0;
+    std::size_t NumMatrices = 0;
+};
+
+//! Resolves dimensions of out = op(A) * op(B)
+//! A or B is broadcasted if its batch size is 1
+//! If out has batch size 1 while B is batched, batches are stacked along the
+//! shared dimension and multiplied as single matrix, so the result is reduced
+//! over the batch (rows of B for NN, rows of both A and B for TN)
+//! Operands may have different element types (and thus padded column size)
+template <typename TA, typename TB, typename TOut>
+GemmDimension GetGemmDimension(const Tensor<TA>& A, const Tensor<TB>& B,
+                               const Tensor<TOut>& out, TransposeOp op)
+{
+    const auto transA = op == TransposeOp::TN;
+    const auto transB = op == TransposeOp::NT;
     const auto inputShapeA = A.TensorShape;
     const auto inputShapeB = B.TensorShape;
+    const auto foldBatch = out.BatchSize == 1 && B.BatchSize > 1;
 
-    if (device.Type() == DeviceType::CPU)
-    {
-        if (A.BatchSize == B.BatchSize)
-        {
-            if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
-            {
-                CPU::Float::MultiplyCpu(
-                    A.Data, B.Data, out.Data, inputShapeA.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix());
+    if (foldBatch && (transB || (transA ? A.BatchSize != B.BatchSize
+                                        : A.BatchSize != 1)))
+        throw std::invalid_argument(
+            "Batch size mismatch while multiplying batch as single matrix");
 
-                CPU::Float::AddCpu(out.Data, C.Data, out.Data,
-                                   out.ElementSize(), out.BatchSize);
-            }
-            else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
-            {
-                CPU::Int::MultiplyCpu(
-                    A.Data, B.Data, out.Data, inputShapeA.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix());
+    const auto numRowA = foldBatch && transA
+                             ? inputShapeA.NumRow() * A.NumMatrix()
+                             : inputShapeA.NumRow();
+    const auto numRowB = foldBatch ? inputShapeB.NumRow() * B.NumMatrix()
+                                   : inputShapeB.NumRow();
 
-                CPU::Int::AddCpu(out.Data, C.Data, out.Data,
-                                 out.ElementSize(), out.BatchSize);
-            }
-        }
-        else if (A.BatchSize == 1)
-        {
-            if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
-            {
-                CPU::Float::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), true);
-
-                CPU::Int::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), true);
-            }
-            else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
-            {
-                CPU::Int::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), true);
+    GemmDimension dimension;
+    dimension.M = transA ? inputShapeA.NumCol() : numRowA;
+    dimension.K = transA ? numRowA : inputShapeA.NumCol();
+    dimension.N = transB ? numRowB
+                         : std::min(B.ColumnElementSize(),
+                                    out.ColumnElementSize());
 
-                CPU::Int::AddWithBroadcastCpu(out.Data, C.Data, out.Data,
-                                              out.ElementSize(), out.BatchSize,
-                                              true);
-            }
-        }
-        else if (B.BatchSize == 1)
-        {
-            if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
-            {
-                CPU::Float::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), false);
+    if (dimension.K != (transB ? inputShapeB.NumCol() : numRowB) ||
+        dimension.M != out.TensorShape.NumRow())
+        throw std::invalid_argument("Shape mismatch while multiplying");
 
-                CPU::Float::AddWithBroadcastCpu(out.Data, C.Data, out.Data,
-                                                out.ElementSize(),
-                                                out.BatchSize, false);
-            }
-            else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
-            {
-                CPU::Int::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), false);
+    const auto matrixStride = [&out, foldBatch](const auto& tensor) {
+        if (foldBatch)
+            return std::size_t{ 0 };
+        if (tensor.BatchSize == out.BatchSize)
+            return tensor.TensorShape.NumRow() * tensor.ColumnElementSize();
+        if (tensor.BatchSize == 1)
+            return std::size_t{ 0 };
+        throw std::invalid_argument(
+            "Batch size mismatch between given tensors");
+    };
 
-                CPU::Int::AddWithBroadcastCpu(out.Data, C.Data, out.Data,
-                                              out.ElementSize(), out.BatchSize,
-                                              false);
-            }
-        }
-        else
-        {
-            throw std::invalid_argument(
-                "Batch size mismatch between given tensors");
-        }
+    dimension.StrideA = matrixStride(A);
+    dimension.StrideB = matrixStride(B);
+    dimension.NumMatrices = foldBatch ? 1 : out.NumMatrix();
+    return dimension;
+}
+
+//! Computes out = op(A) * op(B) for each batch without materializing
+//! transposed operands (op is selected by TransposeOp)
+//! Batches are broadcasted or reduced as described in GetGemmDimension
+template <typename T>
+void Multiply(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out,
+              TransposeOp op)
+{
+    const auto device = out.Device;
+    if (device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    const auto dim = GetGemmDimension(A, B, out, op);
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        CPU::Float::GemmCpu(A.Data, B.Data, out.Data, dim.M, dim.N, dim.K,
+                            A.ColumnElementSize(), B.ColumnElementSize(),
+                            out.ColumnElementSize(), dim.StrideA, dim.StrideB,
+                            dim.NumMatrices, op, device.InstructionSet());
+    else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
+        CPU::Int::GemmCpu(A.Data, B.Data, out.Data, dim.M, dim.N, dim.K,
+                          A.ColumnElementSize(), B.ColumnElementSize(),
+                          out.ColumnElementSize(), dim.StrideA, dim.StrideB,
+                          dim.NumMatrices, op);
+}
+
+//! Computes out = scale * op(A) * op(B) for products whose batch is reduced
+//! into out of batch size 1 (see GetGemmDimension)
+//! Float products apply scale in the epilogue of the GEMM, so gradients are
+//! averaged over the batch without another pass over out
+template <typename T>
+void MultiplyReduce(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out,
+                    TransposeOp op, T scale)
+{
+    const auto device = out.Device;
+    if (device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+    if (out.BatchSize != 1)
+        throw std::invalid_argument(
+            "Output of reduced product should have batch size 1");
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+        const auto dim = GetGemmDimension(A, B, out, op);
+        CPU::Float::GemmReduceCpu(
+            A.Data, B.Data, out.Data, dim.M, dim.N, dim.K,
+            A.ColumnElementSize(), B.ColumnElementSize(),
+            out.ColumnElementSize(), dim.StrideA, dim.StrideB,
+            dim.NumMatrices, scale, op, device.InstructionSet());
     }
     else
     {
-        std::runtime_error("Not implemented");
+        Multiply(A, B, out, op);
+        const auto size = static_cast<long>(out.TotalElementSize());
+#pragma omp parallel for schedule(static)
+        for (long i = 0; i < size; ++i)
+            out.Data[static_cast<std::size_t>(i)] *= scale;
+    }
+}
+
+//! Tunes GEMM blocking of the shape Multiply computes for given operands
+//! Later products of the same shape class use the tuned blocking (see
+//! CPU::Float::TuneGemmCpu). Only float products have tunable blockings
+template <typename TA, typename TB, typename TOut>
+void TuneMultiply(const Tensor<TA>& A, const Tensor<TB>& B,
+                  const Tensor<TOut>& out, TransposeOp op)
+{
+    if constexpr (std::is_same_v<TOut, float>)
+    {
+        if (out.Device.Type() != DeviceType::CPU)
+            return;
+
+        const auto dim = GetGemmDimension(A, B, out, op);
+        CPU::Float::TuneGemmCpu(dim.M, dim.N, dim.K, dim.NumMatrices,
+                                dim.StrideB == 0, op,
+                                out.Device.InstructionSet());
     }
 }
 
+//! Applies activation to single value
+//! Relu is leaky ReLU with 0.1 slope below zero, identical to Graph::ReLU
 template <typename T>
-void Multiply(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+T ActivationForward(T value, Activation activation)
+{
+    switch (activation)
+    {
+        case Activation::Linear:
+            return value;
+        case Activation::Relu:
+            return value > static_cast<T>(0)
+                       ? value
+                       : static_cast<T>(0.1f * value);
+        case Activation::Sigmoid:
+            return static_cast<T>(static_cast<T>(1) / (1 + std::exp(-value)));
+        default:
+            throw std::invalid_argument("Unsupported activation");
+    }
+}
+
+//! Computes derivative of activation from its output
+//! (for both supported activations it is a function of the output alone)
+template <typename T>
+T ActivationDerivative(T output, Activation activation)
+{
+    switch (activation)
+    {
+        case Activation::Linear:
+            return static_cast<T>(1);
+        case Activation::Relu:
+            return output > static_cast<T>(0) ? static_cast<T>(1)
+                                              : static_cast<T>(0.1f);
+        case Activation::Sigmoid:
+            return static_cast<T>(output * (1 - output));
+        default:
+            throw std::invalid_argument("Unsupported activation");
+    }
+}
+
+//! Computes out = activation(A * B + bias) for each batch
+//! bias has single row which is added to every row of the product
+//! On float tensors bias and activation are fused into the GEMM epilogue,
+//! so out is written only once
+template <typename T>
+void MultiplyBiasActivation(const Tensor<T>& A, const Tensor<T>& B,
+                            const Tensor<T>& bias, Tensor<T>& out,
+                            Activation activation)
 {
     const auto device = out.Device;
-    const auto outputShape = out.TensorShape;
-    const auto inputShapeA = A.TensorShape;
-    const auto inputShapeB = B.TensorShape;;
+    if (device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
 
-    if (device.Type() == DeviceType::CPU)
+    if (bias.BatchSize != 1 ||
+        bias.TensorShape.NumCol() != out.TensorShape.NumCol() ||
+        bias.NumMatrix() * bias.TensorShape.NumRow() != 1)
+        throw std::invalid_argument(
+            "Bias should be single row with same columns as output");
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
     {
-        if (A.BatchSize == B.BatchSize)
-        {
-            if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
-                CPU::Float::MultiplyCpu(
-                    A.Data, B.Data, out.Data, inputShapeA.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix());
-            else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
-                CPU::Int::MultiplyCpu(
-                    A.Data, B.Data, out.Data, inputShapeA.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix());
-        }
-        else if (A.BatchSize == 1)
-        {
-            if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
-                CPU::Float::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), true);
-            else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
-                CPU::Int::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), true);
-        }
-        else if (B.BatchSize == 1)
-        {
-            if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
-                CPU::Float::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), false);
-            else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
-                CPU::Int::MultiplyWithBroadcastCpu(
-                    A.Data, B.Data, out.Data, outputShape.NumRow(),
-                    A.ColumnElementSize(), inputShapeB.NumRow(),
-                    B.ColumnElementSize(), out.NumMatrix(), false);
-        }
-        else
-        {
-            throw std::invalid_argument(
-                "Batch size mismatch between given tensors");
-        }
+        const auto dim = GetGemmDimension(A, B, out, TransposeOp::NN);
+        CPU::Float::GemmBiasActivationCpu(
+            A.Data, B.Data, bias.Data, out.Data, dim.M, dim.N, dim.K,
+            A.ColumnElementSize(), B.ColumnElementSize(),
+            out.ColumnElementSize(), dim.StrideA, dim.StrideB,
+            dim.NumMatrices, TransposeOp::NN, activation,
+            out.Device.InstructionSet());
     }
     else
     {
+        Multiply(A, B, out, TransposeOp::NN);
+
+        const auto numRows = out.NumMatrix() * out.TensorShape.NumRow();
+        const auto numCol = out.TensorShape.NumCol();
+        const auto colSize = out.ColumnElementSize();
+#pragma omp parallel for schedule(static) default(shared)
+        for (long rowIdx = 0; static_cast<std::size_t>(rowIdx) < numRows;
+             ++rowIdx)
+            for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+            {
+                auto& value = out.Data[colSize * rowIdx + colIdx];
+                value = ActivationForward(
+                    static_cast<T>(value + bias.Data[colIdx]), activation);
+            }
+    }
+}
+
+//! Multiply with B stored in bfloat16 (see CPU::Float::GemmCpu)
+inline void Multiply(const Tensor<float>& A, const Tensor<BFloat16>& B,
+                     Tensor<float>& out, TransposeOp op)
+{
+    if (out.Device.Type() != DeviceType::CPU)
         throw std::runtime_error("Not implemented");
+
+    const auto dim = GetGemmDimension(A, B, out, op);
+    CPU::Float::GemmCpu(A.Data, B.Data, out.Data, dim.M, dim.N, dim.K,
+                        A.ColumnElementSize(), B.ColumnElementSize(),
+                        out.ColumnElementSize(), dim.StrideA, dim.StrideB,
+                        dim.NumMatrices, op, out.Device.InstructionSet());
+}
+
+//! MultiplyBiasActivation with B stored in bfloat16
+inline void MultiplyBiasActivation(const Tensor<float>& A,
+                                   const Tensor<BFloat16>& B,
+                                   const Tensor<float>& bias,
+                                   Tensor<float>& out, Activation activation)
+{
+    if (out.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if (bias.BatchSize != 1 ||
+        bias.TensorShape.NumCol() != out.TensorShape.NumCol() ||
+        bias.NumMatrix() * bias.TensorShape.NumRow() != 1)
+        throw std::invalid_argument(
+            "Bias should be single row with same columns as output");
+
+    const auto dim = GetGemmDimension(A, B, out, TransposeOp::NN);
+    CPU::Float::GemmBiasActivationCpu(
+        A.Data, B.Data, bias.Data, out.Data, dim.M, dim.N, dim.K,
+        A.ColumnElementSize(), B.ColumnElementSize(), out.ColumnElementSize(),
+        dim.StrideA, dim.StrideB, dim.NumMatrices, TransposeOp::NN,
+        activation, out.Device.InstructionSet());
+}
+
+//! Converts float tensor to bfloat16 rounding to nearest even, or back
+//! Tensors should have same shape and batch size
+template <typename TIn, typename TOut>
+void Convert(const Tensor<TIn>& input, Tensor<TOut>& output)
+{
+    static_assert(
+        (std::is_same_v<TIn, float> && std::is_same_v<TOut, BFloat16>) ||
+            (std::is_same_v<TIn, BFloat16> && std::is_same_v<TOut, float>),
+        "Only conversions between float and bfloat16 are supported");
+
+    if (output.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if (input.TensorShape != output.TensorShape ||
+        input.BatchSize != output.BatchSize)
+        throw std::invalid_argument(
+            "Shape mismatch between converted tensors");
+
+    const auto numRow = input.TotalElementSize() / input.ColumnElementSize();
+    if constexpr (std::is_same_v<TOut, BFloat16>)
+        CPU::Float::ConvertToBFloat16Cpu(
+            input.Data, output.Data, numRow, input.TensorShape.NumCol(),
+            input.ColumnElementSize(), output.ColumnElementSize());
+    else
+        CPU::Float::ConvertFromBFloat16Cpu(
+            input.Data, output.Data, numRow, input.TensorShape.NumCol(),
+            input.ColumnElementSize(), output.ColumnElementSize());
+}
+
+//! Computes out = activation(A * weight + bias) for each batch using int8
+//! GEMM (see CPU::Int8). A is quantized with inputRange before the product
+//! and out is computed in float
+inline void QuantizedMultiplyBiasActivation(
+    const Tensor<float>& A, const CPU::Int8::QuantizedMatrix& weight,
+    CPU::Int8::QuantizationRange inputRange, const Tensor<float>& bias,
+    Tensor<float>& out, Activation activation)
+{
+    if (out.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if (A.TensorShape.NumCol() != weight.NumRow ||
+        out.TensorShape.NumCol() != weight.NumCol ||
+        A.TensorShape.NumRow() != out.TensorShape.NumRow() ||
+        A.NumMatrix() != out.NumMatrix())
+        throw std::invalid_argument(
+            "Shape mismatch while multiplying quantized matrix");
+
+    if (bias.TensorShape.NumCol() != weight.NumCol)
+        throw std::invalid_argument(
+            "Bias should be single row with same columns as output");
+
+    //! Rows of every batch are ColumnElementSize apart, so the batch is
+    //! multiplied as single matrix
+    CPU::Int8::QuantizedGemmBiasActivationCpu(
+        A.Data, weight, inputRange, bias.Data, out.Data,
+        A.NumMatrix() * A.TensorShape.NumRow(), A.ColumnElementSize(),
+        out.ColumnElementSize(), activation, out.Device.InstructionSet());
+}
+
+//! Multiplies delta by derivative of the activation in place
+//! Derivative is evaluated from activationOutput (output of forward pass)
+template <typename T>
+void ActivationGradient(const Tensor<T>& activationOutput, Tensor<T>& delta,
+                        Activation activation)
+{
+    if (activation == Activation::Linear)
+        return;
+
+    const auto size = delta.ElementSize();
+    const auto batchSize = delta.BatchSize;
+#pragma omp parallel for schedule(static) default(shared)
+    for (long batchIdx = 0; batchIdx < static_cast<long>(batchSize); batchIdx++)
+    {
+        const auto batchOffset = size * batchIdx;
+        for (std::size_t i = 0; i < size; ++i)
+            delta.Data[batchOffset + i] *= ActivationDerivative(
+                activationOutput.Data[batchOffset + i], activation);
     }
 }
 
+//! Computes out = A * B for each batch
+//! A or B is broadcasted if its batch size is 1
+//! If out has batch size 1 while B is batched, batches of B are stacked along
+//! the rows and multiplied as single matrix, so the result is reduced over
+//! the batch (A should have batch size * rows of B as its columns)
+template <typename T>
+void Multiply(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
+{
+    Multiply(A, B, out, TransposeOp::NN);
+}
+
+//! Transposes each matrix of the tensor
+//! If out has batch size 1 while in is batched, batches of in are stacked
+//! along the rows and transposed as single matrix
 template <typename T>
 void Transpose(const Tensor<T>& in, Tensor<T>& out)
 {
-    const auto matSize = out.NumMatrix();
+    const auto foldBatch = out.BatchSize == 1 && in.BatchSize > 1;
+    const auto matSize = foldBatch ? 1 : out.NumMatrix();
     const auto inputShape = in.TensorShape;
-    const auto numRow = inputShape.NumRow();
+    const auto numRow = foldBatch ? inputShape.NumRow() * in.NumMatrix()
+                                  : inputShape.NumRow();
     const auto numCol = inputShape.NumCol();
 
+    if (out.Device.Type() == DeviceType::CPU)
+    {
+        if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        {
+            CPU::Float::TransposeCpu(in.Data, out.Data, numRow, numCol,
+                                     in.ColumnElementSize(),
+                                     out.ColumnElementSize(), matSize);
+            return;
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
+        {
+            CPU::Int::TransposeCpu(in.Data, out.Data, numRow, numCol,
+                                   in.ColumnElementSize(),
+                                   out.ColumnElementSize(), matSize);
+            return;
+        }
+    }
+
 #pragma omp parallel for schedule(static) default(shared)
     for (long matIdx = 0; static_cast<std::size_t>(matIdx) < matSize; ++matIdx)
     {
@@ -187,14 +417,18 @@ void Transpose(const Tensor<T>& in, Tensor<T>& out)
         for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
             for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
             {
-                out.At(matOffset + numCol * rowIdx + colIdx) =
-                    in.At(matOffset + numRow * colIdx + rowIdx);
+                out.At(matOffset + numRow * colIdx + rowIdx) =
+                    in.At(matOffset + numCol * rowIdx + colIdx);
             }
     }
 }
 
+//! Writes mean of input over the batch to output, whose batch size is 1
+//! \param deterministic : if true, floating point results are bit-identical
+//! regardless of the number of threads
 template <typename T>
-void Shrink(const Tensor<T>& input, Tensor<T>& output)
+void Shrink(const Tensor<T>& input, Tensor<T>& output,
+            bool deterministic = false)
 {
     const auto device = output.Device;
     const auto size = output.ElementSize();
@@ -202,7 +436,7 @@ void Shrink(const Tensor<T>& input, Tensor<T>& output)
     {
         if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
             CPU::Float::ShrinkCpu(input.Data, output.Data, size,
-                                  input.BatchSize);
+                                  input.BatchSize, deterministic);
         else if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
             CPU::Int::ShrinkCpu(input.Data, output.Data, size,
                                 input.BatchSize);
@@ -211,6 +445,117 @@ void Shrink(const Tensor<T>& input, Tensor<T>& output)
         throw std::runtime_error("Not implemented");
 }
 
+//! Computes out = activation(conv2d(input, weight) + bias) for each batch
+//! through im2col and batched GEMM
+//! input is (channel, height, width), weight is (filters x PatchSize) and
+//! out is (filters, OutputHeight, OutputWidth). column receives im2col
+//! matrix of each sample (see CPU::Float::Im2ColCpu), which is read again by
+//! Conv2DWeightGradient
+//! Row padding of out is a part of the GEMM columns, so the product is
+//! written to out in its own layout
+template <typename T>
+void Conv2D(const Tensor<T>& input, const Tensor<T>& weight,
+            const Tensor<T>& bias, Tensor<T>& column, Tensor<T>& out,
+            const Conv2DGeometry& geometry, Activation activation)
+{
+    if (out.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if constexpr (!std::is_same_v<T, float>)
+    {
+        throw std::runtime_error("Convolution is only implemented for float");
+    }
+    else
+    {
+        const auto numFilter = out.TensorShape.At(0);
+        const auto ldOutput = out.ColumnElementSize();
+        const auto numPixel = geometry.OutputHeight() * ldOutput;
+
+        CPU::Float::Im2ColCpu(input.Data, column.Data, geometry,
+                              input.ColumnElementSize(), ldOutput,
+                              out.BatchSize);
+        CPU::Float::GemmCpu(weight.Data, column.Data, out.Data, numFilter,
+                            numPixel, geometry.PatchSize(),
+                            weight.ColumnElementSize(), numPixel, numPixel, 0,
+                            column.ElementSize(), out.BatchSize,
+                            TransposeOp::NN, out.Device.InstructionSet());
+        CPU::Float::ChannelBiasActivationCpu(
+            out.Data, bias.Data, numFilter, geometry.OutputHeight(),
+            geometry.OutputWidth(), ldOutput, out.BatchSize, activation);
+    }
+}
+
+//! Computes gradient of the convolution input from delta (gradient of the
+//! output), using columnGradient as scratch for the column matrices
+//! Padding of delta should be zero (see CPU::Float::ClearPaddingCpu)
+template <typename T>
+void Conv2DInputGradient(const Tensor<T>& delta, const Tensor<T>& weight,
+                         Tensor<T>& columnGradient, Tensor<T>& inputGradient,
+                         const Conv2DGeometry& geometry)
+{
+    if (delta.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if constexpr (!std::is_same_v<T, float>)
+    {
+        throw std::runtime_error("Convolution is only implemented for float");
+    }
+    else
+    {
+        const auto numFilter = delta.TensorShape.At(0);
+        const auto ldOutput = delta.ColumnElementSize();
+        const auto numPixel = geometry.OutputHeight() * ldOutput;
+
+        //! (filters x PatchSize)^T * (filters x pixels) for each sample
+        CPU::Float::GemmCpu(weight.Data, delta.Data, columnGradient.Data,
+                            geometry.PatchSize(), numPixel, numFilter,
+                            weight.ColumnElementSize(), numPixel, numPixel, 0,
+                            delta.ElementSize(), delta.BatchSize,
+                            TransposeOp::TN, delta.Device.InstructionSet());
+        CPU::Float::Col2ImCpu(columnGradient.Data, inputGradient.Data,
+                              geometry, inputGradient.ColumnElementSize(),
+                              ldOutput, delta.BatchSize);
+    }
+}
+
+//! Computes gradients of weight and bias averaged over the batch from delta
+//! and the column matrices written by Conv2D
+//! Product of each sample is accumulated into weightGradient, so the
+//! gradient of each sample is never stored
+//! Padding of delta should be zero as in Conv2DInputGradient
+template <typename T>
+void Conv2DWeightGradient(const Tensor<T>& delta, const Tensor<T>& column,
+                          Tensor<T>& weightGradient, Tensor<T>& biasGradient,
+                          const Conv2DGeometry& geometry)
+{
+    if (delta.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if constexpr (!std::is_same_v<T, float>)
+    {
+        throw std::runtime_error("Convolution is only implemented for float");
+    }
+    else
+    {
+        const auto numFilter = delta.TensorShape.At(0);
+        const auto ldOutput = delta.ColumnElementSize();
+        const auto numPixel = geometry.OutputHeight() * ldOutput;
+
+        //! (filters x pixels) * (PatchSize x pixels)^T summed over samples
+        CPU::Float::GemmReduceCpu(
+            delta.Data, column.Data, weightGradient.Data, numFilter,
+            geometry.PatchSize(), numPixel, numPixel, numPixel,
+            weightGradient.ColumnElementSize(), delta.ElementSize(),
+            column.ElementSize(), delta.BatchSize,
+            1.0f / static_cast<float>(delta.BatchSize), TransposeOp::NT,
+            delta.Device.InstructionSet());
+        CPU::Float::ShrinkChannelCpu(delta.Data, biasGradient.Data,
+                                     numFilter, geometry.OutputHeight(),
+                                     geometry.OutputWidth(), ldOutput,
+                                     delta.BatchSize);
+    }
+}
+
 template <typename T>
 void Add(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
 {
@@ -288,6 +633,16 @@ void Add(const Tensor<T>& A, Tensor<T>& out)
         throw std::runtime_error("Not implemented");
 }
 
+//! Computes out = A * B + C
+//! C is broadcasted if its batch size is 1
+template <typename T>
+void MultiplyAdd(const Tensor<T>& A, const Tensor<T>& B, const Tensor<T>& C,
+                 Tensor<T>& out)
+{
+    Multiply(A, B, out);
+    Add(out, C, out);
+}
+
 template <typename T>
 void Sub(const Tensor<T>& A, const Tensor<T>& B, Tensor<T>& out)
 {
@@ -574,20 +929,369 @@ void Set(Tensor<T>& tensor, T toSet)
         throw std::runtime_error("Not implemented");
 }
 
+//! True if function can be evaluated on Vector::Packet of every input
+//! Such functions are evaluated 8 floats at a time
+template <typename T, typename Function, typename... Inputs>
+constexpr bool IsVectorizable()
+{
+    if constexpr (std::is_same_v<T, float>)
+        return std::is_invocable_r_v<
+            Vector::Packet, Function,
+            std::conditional_t<true, Vector::Packet, Inputs>...>;
+    else
+        return false;
+}
+
+template <typename T, typename... Inputs>
+void CheckElementWiseArguments(const Tensor<T>& output,
+                               const Inputs&... inputs)
+{
+    if (output.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+    if (((inputs.TensorShape != output.TensorShape ||
+          inputs.BatchSize != output.BatchSize) || ...))
+        throw std::invalid_argument("Shape mismatch between input and output");
+}
+
+//! Evaluates output = function(inputs...) element by element in single
+//! parallel pass, including paddings of the rows
+//! If function is generic lambda built from operators and functions of
+//! Compute::Vector, float tensors are evaluated with AVX2
+//! ex) Map([](auto x, auto y) { return x * y + 1; }, output, lhs, rhs)
+template <typename T, typename Function, typename... Inputs>
+void Map(Function function, Tensor<T>& output, const Inputs&... inputs)
+{
+    CheckElementWiseArguments(output, inputs...);
+
+    const auto size = output.TotalElementSize();
+    std::size_t scalarBegin = 0;
+
+    if constexpr (IsVectorizable<T, Function, Inputs...>())
+    {
+        const auto numVectors = static_cast<long>(size / 8);
+#pragma omp parallel for schedule(static)
+        for (long vecIdx = 0; vecIdx < numVectors; ++vecIdx)
+        {
+            const auto offset = static_cast<std::size_t>(vecIdx) * 8;
+            const Vector::Packet result =
+                function(Vector::Packet::Load(inputs.Data.Address(offset))...);
+            result.Store(output.Data.Address(offset));
+        }
+        scalarBegin = static_cast<std::size_t>(numVectors) * 8;
+    }
+
+    const auto numScalars = static_cast<long>(size - scalarBegin);
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < numScalars; ++i)
+    {
+        const auto idx = scalarBegin + static_cast<std::size_t>(i);
+        output.Data[idx] = static_cast<T>(function(inputs.Data[idx]...));
+    }
+}
+
+//! Evaluates output = function(inputs...) like Map, and returns sum of the
+//! results in the same pass
+//! Paddings are neither written nor summed
+//! ex) MapReduce([](auto x) { return x * x; }, output, input) writes
+//! squares to output and returns squared norm of input
+template <typename T, typename Function, typename... Inputs>
+T MapReduce(Function function, Tensor<T>& output, const Inputs&... inputs)
+{
+    CheckElementWiseArguments(output, inputs...);
+
+    const auto numCol = output.TensorShape.NumCol();
+    const auto colSize = output.ColumnElementSize();
+    const auto numRows = static_cast<long>(output.TotalElementSize() / colSize);
+
+    T sum = static_cast<T>(0);
+#pragma omp parallel for schedule(static) reduction(+ : sum)
+    for (long rowIdx = 0; rowIdx < numRows; ++rowIdx)
+    {
+        const auto rowOffset = static_cast<std::size_t>(rowIdx) * colSize;
+        std::size_t colIdx = 0;
+        T rowSum = static_cast<T>(0);
+
+        if constexpr (IsVectorizable<T, Function, Inputs...>())
+        {
+            Vector::Packet vectorSum(0.0f);
+            for (; colIdx + 8 <= numCol; colIdx += 8)
+            {
+                const auto offset = rowOffset + colIdx;
+                const Vector::Packet result = function(
+                    Vector::Packet::Load(inputs.Data.Address(offset))...);
+                result.Store(output.Data.Address(offset));
+                vectorSum += result;
+            }
+            rowSum = Vector::HorizontalSum(vectorSum);
+        }
+
+        for (; colIdx < numCol; ++colIdx)
+        {
+            const auto offset = rowOffset + colIdx;
+            const auto result =
+                static_cast<T>(function(inputs.Data[offset]...));
+            output.Data[offset] = result;
+            rowSum += result;
+        }
+        sum += rowSum;
+    }
+
+    return sum;
+}
+
+//! Returns smallest and largest element of the tensor
+//! Paddings are not included
+template <typename T>
+std::pair<T, T> MinMax(const Tensor<T>& tensor)
+{
+    if (tensor.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    const auto numCol = tensor.TensorShape.NumCol();
+    const auto colSize = tensor.ColumnElementSize();
+    const auto numRows = static_cast<long>(tensor.TotalElementSize() / colSize);
+
+    T min = std::numeric_limits<T>::max();
+    T max = std::numeric_limits<T>::lowest();
+#pragma omp parallel for schedule(static) reduction(min : min) \
+    reduction(max : max)
+    for (long rowIdx = 0; rowIdx < numRows; ++rowIdx)
+    {
+        const auto rowOffset = static_cast<std::size_t>(rowIdx) * colSize;
+        for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+        {
+            const auto value = tensor.Data[rowOffset + colIdx];
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+    }
+
+    return { min, max };
+}
+
 template <typename T, typename Function>
 void Apply(const Tensor<T>& input, Tensor<T>& output, Function lambda)
 {
-    const auto device = input.Device;
-    const auto size = output.ElementSize();
+    Map(lambda, output, input);
+}
+
+//! Computes e^x of each element
+//! Float tensors are evaluated with AVX2 kernels of Compute::Vector
+template <typename T>
+void Exp(const Tensor<T>& input, Tensor<T>& output)
+{
+    if (output.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        CPU::Float::ExpCpu(input.Data, output.Data, output.ElementSize(),
+                          output.BatchSize);
+    else
+        Apply(input, output,
+              [](T value) { return static_cast<T>(std::exp(value)); });
+}
+
+//! Computes natural logarithm of each element
+//! Float tensors are evaluated with AVX2 kernels of Compute::Vector
+template <typename T>
+void Log(const Tensor<T>& input, Tensor<T>& output)
+{
+    if (output.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        CPU::Float::LogCpu(input.Data, output.Data, output.ElementSize(),
+                          output.BatchSize);
+    else
+        Apply(input, output,
+              [](T value) { return static_cast<T>(std::log(value)); });
+}
+
+//! Computes 1 / (1 + e^-x) of each element
+//! Float tensors are evaluated with AVX2 kernels of Compute::Vector
+template <typename T>
+void Sigmoid(const Tensor<T>& input, Tensor<T>& output)
+{
+    if (output.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        CPU::Float::SigmoidCpu(input.Data, output.Data, output.ElementSize(),
+                          output.BatchSize);
+    else
+        Apply(input, output, [](T value) {
+            return static_cast<T>(static_cast<T>(1) / (1 + std::exp(-value)));
+        });
+}
+
+//! Computes hyperbolic tangent of each element
+//! Float tensors are evaluated with AVX2 kernels of Compute::Vector
+template <typename T>
+void Tanh(const Tensor<T>& input, Tensor<T>& output)
+{
+    if (output.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        CPU::Float::TanhCpu(input.Data, output.Data, output.ElementSize(),
+                          output.BatchSize);
+    else
+        Apply(input, output,
+              [](T value) { return static_cast<T>(std::tanh(value)); });
+}
+
+//! Computes softmax of each batch
+//! Maximum of the batch is subtracted before exponentiation, so the result
+//! stays finite for large inputs
+template <typename T>
+void SoftMax(const Tensor<T>& input, Tensor<T>& output)
+{
+    if (output.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+    if (input.TensorShape != output.TensorShape ||
+        input.BatchSize != output.BatchSize)
+        throw std::invalid_argument("Shape mismatch between input and output");
+
+    const auto numCol = output.TensorShape.NumCol();
+    const auto colSize = output.ColumnElementSize();
+    const auto numRow = output.ElementSize() / colSize;
     const auto batchSize = output.BatchSize;
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        CPU::Float::SoftMaxCpu(input.Data, output.Data, numCol, colSize,
+                               numRow, batchSize);
+    else
+    {
 #pragma omp parallel for schedule(static) default(shared)
-    for (long batchIdx = 0; batchIdx < static_cast<long>(batchSize); batchIdx++)
+        for (long batchIdx = 0; batchIdx < static_cast<long>(batchSize);
+             ++batchIdx)
+        {
+            const auto batchOffset = numRow * colSize * batchIdx;
+            const auto forEach = [&](const auto& function) {
+                for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+                    for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+                        function(batchOffset + colSize * rowIdx + colIdx);
+            };
+
+            T max = std::numeric_limits<T>::lowest();
+            forEach([&](std::size_t idx) {
+                max = std::max(max, input.Data[idx]);
+            });
+
+            T expSum = static_cast<T>(0);
+            forEach([&](std::size_t idx) {
+                output.Data[idx] =
+                    static_cast<T>(std::exp(input.Data[idx] - max));
+                expSum += output.Data[idx];
+            });
+
+            forEach([&](std::size_t idx) { output.Data[idx] /= expSum; });
+        }
+    }
+}
+
+//! Computes probability = softmax(logit) over each batch and returns cross
+//! entropy between probability and label summed over the batch
+//! Maximum of the batch is subtracted before exponentiation, so the result
+//! stays finite for large logits
+template <typename T>
+T SoftMaxCrossEntropy(const Tensor<T>& logit, const Tensor<T>& label,
+                      Tensor<T>& probability)
+{
+    if (probability.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+    if (logit.TensorShape != label.TensorShape ||
+        logit.TensorShape != probability.TensorShape ||
+        logit.BatchSize != label.BatchSize ||
+        logit.BatchSize != probability.BatchSize)
+        throw std::invalid_argument(
+            "Shape mismatch between logit, label and probability");
+
+    const auto numCol = probability.TensorShape.NumCol();
+    const auto colSize = probability.ColumnElementSize();
+    const auto numRow = probability.ElementSize() / colSize;
+    const auto batchSize = probability.BatchSize;
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        return CPU::Float::SoftMaxCrossEntropyCpu(
+            logit.Data, label.Data, probability.Data, numCol, colSize, numRow,
+            batchSize);
+    else
     {
-        const auto batchOffset = size * batchIdx;
-        for (unsigned i = 0; i < size; i += 1)
+        T loss = static_cast<T>(0);
+        for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        {
+            const auto batchOffset = numRow * colSize * batchIdx;
+            const auto forEach = [&](const auto& function) {
+                for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+                    for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+                        function(batchOffset + colSize * rowIdx + colIdx);
+            };
+
+            T max = std::numeric_limits<T>::lowest();
+            forEach([&](std::size_t idx) {
+                max = std::max(max, logit.Data[idx]);
+            });
+
+            T expSum = static_cast<T>(0);
+            forEach([&](std::size_t idx) {
+                probability.Data[idx] =
+                    static_cast<T>(std::exp(logit.Data[idx] - max));
+                expSum += probability.Data[idx];
+            });
+
+            const auto logSumExp = static_cast<T>(max + std::log(expSum));
+            forEach([&](std::size_t idx) {
+                probability.Data[idx] /= expSum;
+                loss += label.Data[idx] * (logSumExp - logit.Data[idx]);
+            });
+        }
+        return loss;
+    }
+}
+
+//! Computes out = label - sum(label) * probability for each batch, which is
+//! negative gradient of SoftMaxCrossEntropy with respect to the logits
+template <typename T>
+void SoftMaxCrossEntropyGradient(const Tensor<T>& probability,
+                                 const Tensor<T>& label, Tensor<T>& out)
+{
+    if (out.Device.Type() != DeviceType::CPU)
+        throw std::runtime_error("Not implemented");
+    if (probability.TensorShape != label.TensorShape ||
+        probability.TensorShape != out.TensorShape ||
+        probability.BatchSize != label.BatchSize ||
+        probability.BatchSize != out.BatchSize)
+        throw std::invalid_argument(
+            "Shape mismatch between probability, label and output");
+
+    const auto numCol = out.TensorShape.NumCol();
+    const auto colSize = out.ColumnElementSize();
+    const auto numRow = out.ElementSize() / colSize;
+    const auto batchSize = out.BatchSize;
+
+    if constexpr (std::is_floating_point_v<T> && sizeof(T) == 4)
+        CPU::Float::SoftMaxCrossEntropyGradientCpu(
+            probability.Data, label.Data, out.Data, numCol, colSize, numRow,
+            batchSize);
+    else
+    {
+        for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
         {
-            output.Data[batchOffset + i] =
-                static_cast<T>(lambda(input.Data[batchOffset + i]));
+            const auto batchOffset = numRow * colSize * batchIdx;
+            T labelSum = static_cast<T>(0);
+            for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+                for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+                    labelSum +=
+                        label.Data[batchOffset + colSize * rowIdx + colIdx];
+
+            for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+                for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+                {
+                    const auto idx = batchOffset + colSize * rowIdx + colIdx;
+                    out.Data[idx] = static_cast<T>(
+                        label.Data[idx] - labelSum * probability.Data[idx]);
+                }
         }
     }
 }
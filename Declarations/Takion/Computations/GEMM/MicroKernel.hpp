@@ -0,0 +1,71 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_MICROKERNEL_HPP
+#define TAKION_COMPUTE_MICROKERNEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+//! Instruction set specific part of float and quantized GEMM
+//! Packing, blocking and the epilogue are shared between instruction sets,
+//! and only the register tile is computed by the kernel selected at runtime
+//! Kernels for instruction sets wider than the baseline are defined in their
+//! own translation units compiled with the instruction set enabled, so this
+//! header must not define any inline functions
+namespace Takion::Compute::CPU::Float
+{
+//! Computes MR x NR tile of packed A * packed B
+//! packedA holds MR elements and packedB holds NR elements for each k
+//! The tile is stored row by row (NR elements apart) to tile, which is
+//! aligned to 64 bytes
+using ComputeTileFunction = void (*)(std::size_t kc, const float* packedA,
+                                     const float* packedB, float* tile);
+
+struct MicroKernel
+{
+    std::size_t MR;
+    std::size_t NR;
+    ComputeTileFunction ComputeTile;
+};
+
+//! 6 x 16 tile using AVX2 and FMA
+MicroKernel GetAvx2MicroKernel();
+
+//! 12 x 32 tile using AVX-512
+MicroKernel GetAvx512MicroKernel();
+} // namespace Takion::Compute::CPU::Float
+
+namespace Takion::Compute::CPU::Int8
+{
+//! Computes MR x NR int32 tile of quantized input * packed weight
+//! inputRows holds first element of each row of the tile, and each group
+//! of 4 consecutive k is read as single 32 bit word
+//! packedWeight points to the first column of the tile in the first group,
+//! and groups are groupStride bytes apart (see QuantizedMatrix)
+//! The tile is stored row by row (NR elements apart) to tile, which is
+//! aligned to 64 bytes
+using ComputeTileFunction = void (*)(const std::uint8_t* const* inputRows,
+                                     const std::int8_t* packedWeight,
+                                     std::size_t numGroups,
+                                     std::size_t groupStride,
+                                     std::int32_t* tile);
+
+struct MicroKernel
+{
+    std::size_t MR;
+    std::size_t NR;
+    ComputeTileFunction ComputeTile;
+};
+
+//! 4 x 16 tile using AVX2 maddubs
+MicroKernel GetAvx2MicroKernel();
+
+//! 8 x 32 tile using AVX-512 VNNI dpbusd
+MicroKernel GetAvx512VnniMicroKernel();
+} // namespace Takion::Compute::CPU::Int8
+
+#endif
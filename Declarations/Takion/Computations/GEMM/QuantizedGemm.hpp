@@ -0,0 +1,84 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_QUANTIZEDGEMM_HPP
+#define TAKION_COMPUTE_QUANTIZEDGEMM_HPP
+
+#include <Takion/Computations/InstructionSet.hpp>
+#include <Takion/Utils/Span.hpp>
+#include <Takion/Utils/Declarations.hpp>
+#include <cstdint>
+#include <vector>
+
+//! Int8 GEMM for quantized inference
+//! Weights are quantized symmetrically to int8 with scale per column
+//! (output channel), and inputs asymmetrically to unsigned integers with
+//! single scale and zero point found by calibration
+//! Products are accumulated in int32 and converted back to float in the
+//! epilogue, which also applies bias and activation
+namespace Takion::Compute::CPU::Int8
+{
+using namespace Util;
+
+//! Largest quantized input value
+//! Inputs are limited to 7 bits, so the sum of two u8 x s8 products
+//! computed by maddubs never saturates int16. Every kernel uses the same
+//! range, so results do not depend on the instruction set
+constexpr std::int32_t MaxInputValue = 127;
+
+//! Largest magnitude of quantized weight
+constexpr std::int32_t MaxWeightValue = 127;
+
+//! Maps float input x to round(x / Scale) + ZeroPoint
+struct QuantizationRange
+{
+    float Scale = 1.0f;
+    std::int32_t ZeroPoint = 0;
+};
+
+//! (k x n) matrix quantized to int8 with scale per column
+//! Rows are padded to multiple of 4 and columns to multiple of 32 with zeros
+//! Data is stored in groups of 4 rows, each column holding its 4 values
+//! next to each other ([PaddedNumRow / 4][PaddedNumCol][4]), so a vector
+//! load yields 4 consecutive k of consecutive columns as maddubs and dpbusd
+//! expect
+struct QuantizedMatrix
+{
+    std::size_t NumRow = 0;
+    std::size_t NumCol = 0;
+    std::size_t PaddedNumRow = 0;
+    std::size_t PaddedNumCol = 0;
+    std::vector<std::int8_t> Data;
+    //! Float value of each column is quantized value * Scale[column]
+    std::vector<float> Scale;
+    //! Sum of quantized values of each column, used to remove zero point
+    //! of the input from the products
+    std::vector<std::int32_t> ColumnSum;
+};
+
+//! Returns quantization of inputs in [min, max]
+//! Range is extended to contain zero, so zero is represented exactly
+QuantizationRange ComputeInputRange(float min, float max);
+
+//! Quantizes (k x n) matrix whose rows are ld elements apart
+QuantizedMatrix QuantizeMatrix(const Span<float> matrix, std::size_t k,
+                               std::size_t n, std::size_t ld);
+
+//! Computes out = activation(input * weight + bias) for (m x k) input
+//! Input is quantized with inputRange before the product
+//! lda and ldc are row strides of input and out. bias is a row of n
+//! elements (supports Linear, Relu (leaky, as Graph::ReLU) and Sigmoid)
+//! Products run on dpbusd with AVX512VNNI, and on maddubs otherwise
+void QuantizedGemmBiasActivationCpu(const Span<float> input,
+                                    const QuantizedMatrix& weight,
+                                    QuantizationRange inputRange,
+                                    const Span<float> bias, Span<float> out,
+                                    std::size_t m, std::size_t lda,
+                                    std::size_t ldc, Activation activation,
+                                    InstructionSet instructionSet);
+} // namespace Takion::Compute::CPU::Int8
+
+#endif
@@ -0,0 +1,46 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_INSTRUCTIONSET_HPP
+#define TAKION_COMPUTE_INSTRUCTIONSET_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace Takion::Compute
+{
+//! Vector instruction sets CPU kernels are compiled for
+//! AVX2 (with FMA) is the baseline every translation unit is compiled with,
+//! except the ones detecting the instruction set so that processors without
+//! it get an exception from Device instead of an illegal instruction.
+//! AVX512 kernels are compiled separately and only used if the processor
+//! supports them. AVX512VNNI is AVX512 with int8 dot product instructions,
+//! which only changes kernels of quantized GEMM
+enum class InstructionSet
+{
+    AVX2,
+    AVX512,
+    AVX512VNNI,
+};
+
+//! True if both the processor and the operating system support the
+//! instruction set. Detected with cpuid once and cached
+bool IsSupported(InstructionSet instructionSet);
+
+//! Widest instruction set supported on this machine
+InstructionSet GetNativeInstructionSet();
+
+//! Width of the vector registers of the instruction set in bytes
+std::size_t VectorByteSize(InstructionSet instructionSet);
+
+std::string ToString(InstructionSet instructionSet);
+
+//! Brand string of the processor reported by cpuid
+//! (e.g. "Intel(R) Xeon(R) CPU ..."), "Unknown" if it is not available
+std::string GetProcessorName();
+} // namespace Takion::Compute
+
+#endif
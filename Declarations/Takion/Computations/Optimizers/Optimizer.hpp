@@ -9,9 +9,22 @@
 
 #include <Takion/Tensors/Tensor.hpp>
 #include <Takion/Computations/GEMM/MathKernel.hpp>
+#include <cmath>
+#include <vector>
 
 namespace Takion::Compute
 {
+//! State an optimizer keeps for each trainable tensor
+//! Stored by Graph::TrainableUnit next to the tensor it updates
+template <typename T>
+struct OptimizerState
+{
+    //! Moments of the optimizer, shaped as the trainable tensor
+    std::vector<Tensor<T>> MomentVector;
+    //! Number of updates applied to the tensor
+    std::size_t Step = 0;
+};
+
 template <typename T>
 class Optimizer
 {
@@ -24,16 +37,33 @@ public:
     Optimizer<T>& operator=(const Optimizer<T>& optimizer) = default;
     Optimizer<T>& operator=(Optimizer<T>&& optimizer) noexcept = default;
 
-    virtual void Optimize(Tensor<T>& tensor, Tensor<T>& delta) = 0;
+    //! Number of moment tensors required in OptimizerState
+    [[nodiscard]] virtual std::size_t NumMoments() const
+    {
+        return 0;
+    }
+
+    //! Applies update to tensor and advances its state
+    //! update is the descent direction (negative gradient) of the tensor
+    virtual void Optimize(Tensor<T>& tensor, const Tensor<T>& update,
+                          OptimizerState<T>& state) = 0;
 };
 
-//! Stochastic gradient descent
+//! Stochastic gradient descent with optional momentum and weight decay
 template <typename T>
 class SGD : public Optimizer<T>
 {
 public:
-    SGD(T epsilon)
-        : m_epsilon(epsilon)
+    //! \param momentum : factor of the velocity carried to the next update
+    //! (0 updates the tensor with the update directly)
+    //! \param nesterov : if true, applies Nesterov momentum
+    //! \param weightDecay : L2 penalty added to the gradient
+    SGD(T learningRate, T momentum = 0, bool nesterov = false,
+        T weightDecay = 0)
+        : m_learningRate(learningRate),
+          m_momentum(momentum),
+          m_nesterov(nesterov),
+          m_weightDecay(weightDecay)
     {
     }
 
@@ -43,14 +73,135 @@ public:
     SGD& operator=(SGD<T>&& sgd) noexcept = default;
     ~SGD() = default;
 
-    void Optimize(Tensor<T>& tensor, Tensor<T>& update) override
+    [[nodiscard]] std::size_t NumMoments() const override
     {
-        Compute::ScalarMul(update, m_epsilon);
-        Compute::Add(tensor, update, tensor);
+        return m_momentum != 0 ? 1 : 0;
+    }
+
+    void Optimize(Tensor<T>& tensor, const Tensor<T>& update,
+                  OptimizerState<T>& state) override
+    {
+        ++state.Step;
+        const auto size = tensor.ElementSize() * tensor.BatchSize;
+        //! Velocity is not read without momentum
+        auto velocity = state.MomentVector.empty()
+                            ? tensor.Data
+                            : state.MomentVector[0].Data;
+
+        if constexpr (std::is_same_v<T, float>)
+        {
+            CPU::Float::SgdUpdateCpu(tensor.Data, update.Data, velocity, size,
+                                     m_learningRate, m_momentum, m_nesterov,
+                                     m_weightDecay);
+        }
+        else
+        {
+            for (std::size_t idx = 0; idx < size; ++idx)
+            {
+                auto descent =
+                    update.Data[idx] - m_weightDecay * tensor.Data[idx];
+                if (m_momentum != 0)
+                {
+                    velocity[idx] = m_momentum * velocity[idx] + descent;
+                    descent = m_nesterov
+                                  ? descent + m_momentum * velocity[idx]
+                                  : velocity[idx];
+                }
+                tensor.Data[idx] += m_learningRate * descent;
+            }
+        }
+    }
+
+private:
+    T m_learningRate;
+    T m_momentum;
+    bool m_nesterov;
+    T m_weightDecay;
+};
+
+//! Adam, and AdamW if weight decay is decoupled from the gradient
+//! Both moments of a tensor are updated in the same pass as the tensor
+template <typename T>
+class Adam : public Optimizer<T>
+{
+public:
+    //! \param decoupledWeightDecay : if true, weight decay scales the tensor
+    //! directly (AdamW), otherwise it is added to the gradient as L2 penalty
+    Adam(T learningRate, T beta1 = static_cast<T>(0.9),
+         T beta2 = static_cast<T>(0.999), T epsilon = static_cast<T>(1e-8),
+         T weightDecay = 0, bool decoupledWeightDecay = false)
+        : m_learningRate(learningRate),
+          m_beta1(beta1),
+          m_beta2(beta2),
+          m_epsilon(epsilon),
+          m_weightDecay(weightDecay),
+          m_decoupledWeightDecay(decoupledWeightDecay)
+    {
+    }
+
+    Adam(const Adam<T>& adam) = default;
+    Adam(Adam<T>&& adam) noexcept = default;
+    Adam& operator=(const Adam<T>& adam) = default;
+    Adam& operator=(Adam<T>&& adam) noexcept = default;
+    ~Adam() = default;
+
+    [[nodiscard]] std::size_t NumMoments() const override
+    {
+        return 2;
+    }
+
+    void Optimize(Tensor<T>& tensor, const Tensor<T>& update,
+                  OptimizerState<T>& state) override
+    {
+        ++state.Step;
+        const auto size = tensor.ElementSize() * tensor.BatchSize;
+        auto firstMoment = state.MomentVector.at(0).Data;
+        auto secondMoment = state.MomentVector.at(1).Data;
+
+        if constexpr (std::is_same_v<T, float>)
+        {
+            CPU::Float::AdamUpdateCpu(tensor.Data, update.Data, firstMoment,
+                                      secondMoment, size, m_learningRate,
+                                      m_beta1, m_beta2, m_epsilon,
+                                      m_weightDecay, m_decoupledWeightDecay,
+                                      state.Step);
+        }
+        else
+        {
+            const auto exponent = static_cast<T>(state.Step);
+            const auto stepSize =
+                m_learningRate / (1 - std::pow(m_beta1, exponent));
+            const auto secondMomentScale =
+                1 / (1 - std::pow(m_beta2, exponent));
+            const auto coupledDecay =
+                m_decoupledWeightDecay ? 0 : m_weightDecay;
+            const auto decoupledDecay =
+                m_decoupledWeightDecay ? 1 - m_learningRate * m_weightDecay : 1;
+
+            for (std::size_t idx = 0; idx < size; ++idx)
+            {
+                const auto descent =
+                    update.Data[idx] - coupledDecay * tensor.Data[idx];
+                firstMoment[idx] =
+                    m_beta1 * firstMoment[idx] + (1 - m_beta1) * descent;
+                secondMoment[idx] = m_beta2 * secondMoment[idx] +
+                                    (1 - m_beta2) * descent * descent;
+                tensor.Data[idx] =
+                    tensor.Data[idx] * decoupledDecay +
+                    stepSize * firstMoment[idx] /
+                        (std::sqrt(secondMoment[idx] * secondMomentScale) +
+                         m_epsilon);
+            }
+        }
     }
 
 private:
+    T m_learningRate;
+    T m_beta1;
+    T m_beta2;
     T m_epsilon;
+    T m_weightDecay;
+    bool m_decoupledWeightDecay;
 };
 }
 
@@ -0,0 +1,191 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_PACKET_HPP
+#define TAKION_COMPUTE_PACKET_HPP
+
+#include <Takion/Computations/Vector/VectorMath.hpp>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+//! Arithmetic wrapper of 8 floats for element wise functions
+//! Functions passed to Compute::Map and Compute::MapReduce can be written
+//! once as generic lambda, since every operator and function here has scalar
+//! overload with identical meaning
+namespace Takion::Compute::Vector
+{
+struct Packet
+{
+    Packet() = default;
+
+    Packet(__m256 value)
+        : Value(value)
+    {
+    }
+
+    //! Broadcasts scalar to every lane
+    Packet(float scalar)
+        : Value(_mm256_set1_ps(scalar))
+    {
+    }
+
+    static Packet Load(const float* source)
+    {
+        return _mm256_loadu_ps(source);
+    }
+
+    void Store(float* destination) const
+    {
+        _mm256_storeu_ps(destination, Value);
+    }
+
+    __m256 Value;
+};
+
+//! Result of lane wise comparison. Lanes are either all ones or all zeros
+struct Mask
+{
+    __m256 Value;
+};
+
+inline Packet operator+(Packet lhs, Packet rhs)
+{
+    return _mm256_add_ps(lhs.Value, rhs.Value);
+}
+
+inline Packet operator-(Packet lhs, Packet rhs)
+{
+    return _mm256_sub_ps(lhs.Value, rhs.Value);
+}
+
+inline Packet operator*(Packet lhs, Packet rhs)
+{
+    return _mm256_mul_ps(lhs.Value, rhs.Value);
+}
+
+inline Packet operator/(Packet lhs, Packet rhs)
+{
+    return _mm256_div_ps(lhs.Value, rhs.Value);
+}
+
+inline Packet operator-(Packet packet)
+{
+    return _mm256_xor_ps(packet.Value, _mm256_set1_ps(-0.0f));
+}
+
+inline Packet& operator+=(Packet& lhs, Packet rhs)
+{
+    lhs = lhs + rhs;
+    return lhs;
+}
+
+inline Mask operator<(Packet lhs, Packet rhs)
+{
+    return { _mm256_cmp_ps(lhs.Value, rhs.Value, _CMP_LT_OQ) };
+}
+
+inline Mask operator>(Packet lhs, Packet rhs)
+{
+    return { _mm256_cmp_ps(lhs.Value, rhs.Value, _CMP_GT_OQ) };
+}
+
+inline Mask operator<=(Packet lhs, Packet rhs)
+{
+    return { _mm256_cmp_ps(lhs.Value, rhs.Value, _CMP_LE_OQ) };
+}
+
+inline Mask operator>=(Packet lhs, Packet rhs)
+{
+    return { _mm256_cmp_ps(lhs.Value, rhs.Value, _CMP_GE_OQ) };
+}
+
+//! Picks lanes of onTrue where mask is set and lanes of onFalse elsewhere
+inline Packet Select(Mask mask, Packet onTrue, Packet onFalse)
+{
+    return _mm256_blendv_ps(onFalse.Value, onTrue.Value, mask.Value);
+}
+
+inline Packet Max(Packet lhs, Packet rhs)
+{
+    return _mm256_max_ps(lhs.Value, rhs.Value);
+}
+
+inline Packet Min(Packet lhs, Packet rhs)
+{
+    return _mm256_min_ps(lhs.Value, rhs.Value);
+}
+
+inline Packet Exp(Packet packet)
+{
+    return Exp(packet.Value);
+}
+
+inline Packet Log(Packet packet)
+{
+    return Log(packet.Value);
+}
+
+inline Packet Sigmoid(Packet packet)
+{
+    return Sigmoid(packet.Value);
+}
+
+inline Packet Tanh(Packet packet)
+{
+    return Tanh(packet.Value);
+}
+
+inline float HorizontalSum(Packet packet)
+{
+    return HorizontalSum(packet.Value);
+}
+
+//! Scalar overloads used for non-float types and remainders of the rows
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+T Select(bool condition, T onTrue, T onFalse)
+{
+    return condition ? onTrue : onFalse;
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+T Max(T lhs, T rhs)
+{
+    return std::max(lhs, rhs);
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+T Min(T lhs, T rhs)
+{
+    return std::min(lhs, rhs);
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+T Exp(T value)
+{
+    return static_cast<T>(std::exp(value));
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+T Log(T value)
+{
+    return static_cast<T>(std::log(value));
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+T Sigmoid(T value)
+{
+    return static_cast<T>(static_cast<T>(1) / (1 + std::exp(-value)));
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+T Tanh(T value)
+{
+    return static_cast<T>(std::tanh(value));
+}
+} // namespace Takion::Compute::Vector
+
+#endif
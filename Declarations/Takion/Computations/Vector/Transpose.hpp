@@ -0,0 +1,58 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_VECTOR_TRANSPOSE_HPP
+#define TAKION_COMPUTE_VECTOR_TRANSPOSE_HPP
+
+#include <immintrin.h>
+#include <cstddef>
+
+namespace Takion::Compute::Vector
+{
+//! Transposes 8x8 block of 32 bit elements in registers
+//! Only shuffles are used, so the block may hold any 32 bit type
+//! \param input : first element of the block, rows are ldIn elements apart
+//! \param ldIn : distance between rows of input
+//! \param output : first element of the transposed block
+//! \param ldOut : distance between rows of output
+inline void Transpose8x8(const float* input, std::size_t ldIn, float* output,
+                         std::size_t ldOut)
+{
+    __m256 row[8];
+    for (std::size_t idx = 0; idx < 8; ++idx)
+        row[idx] = _mm256_loadu_ps(input + idx * ldIn);
+
+    //! Interleaves pairs of rows, then pairs of pairs within 128 bit lanes
+    __m256 pair[8];
+    for (std::size_t idx = 0; idx < 8; idx += 2)
+    {
+        pair[idx] = _mm256_unpacklo_ps(row[idx], row[idx + 1]);
+        pair[idx + 1] = _mm256_unpackhi_ps(row[idx], row[idx + 1]);
+    }
+
+    __m256 quad[8];
+    for (std::size_t idx = 0; idx < 8; idx += 4)
+    {
+        quad[idx] = _mm256_shuffle_ps(pair[idx], pair[idx + 2], 0x44);
+        quad[idx + 1] = _mm256_shuffle_ps(pair[idx], pair[idx + 2], 0xEE);
+        quad[idx + 2] = _mm256_shuffle_ps(pair[idx + 1], pair[idx + 3], 0x44);
+        quad[idx + 3] = _mm256_shuffle_ps(pair[idx + 1], pair[idx + 3], 0xEE);
+    }
+
+    //! Lower lanes hold columns 0-3 and upper lanes hold columns 4-7
+    for (std::size_t idx = 0; idx < 4; ++idx)
+    {
+        _mm256_storeu_ps(
+            output + idx * ldOut,
+            _mm256_permute2f128_ps(quad[idx], quad[idx + 4], 0x20));
+        _mm256_storeu_ps(
+            output + (idx + 4) * ldOut,
+            _mm256_permute2f128_ps(quad[idx], quad[idx + 4], 0x31));
+    }
+}
+} // namespace Takion::Compute::Vector
+
+#endif
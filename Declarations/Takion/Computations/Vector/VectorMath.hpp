@@ -0,0 +1,183 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_COMPUTE_VECTORMATH_HPP
+#define TAKION_COMPUTE_VECTORMATH_HPP
+
+#include <immintrin.h>
+#include <limits>
+
+//! Transcendental functions on 8 floats using AVX2 and FMA
+//! Each function reduces the argument to a small range and evaluates
+//! minimax polynomial (coefficients of Cephes single precision library)
+//! Error bounds below are measured against double precision results over
+//! the whole valid range, in units in the last place (ULP)
+namespace Takion::Compute::Vector
+{
+//! Computes e^x for each lane (max error 1.3 ULP)
+//! Inputs below -87.3 return denormals, below -103.9 zero and above 88.7 inf
+inline __m256 Exp(__m256 x)
+{
+    const auto input = x;
+    const auto isOverflow = _mm256_cmp_ps(
+        x, _mm256_set1_ps(88.7228391117f), _CMP_GT_OQ);
+    const auto isUnderflow = _mm256_cmp_ps(
+        x, _mm256_set1_ps(-103.972084045f), _CMP_LT_OQ);
+    x = _mm256_min_ps(x, _mm256_set1_ps(88.7228391117f));
+    x = _mm256_max_ps(x, _mm256_set1_ps(-103.972084045f));
+
+    //! e^x = 2^n * e^r with r in [-ln2/2, ln2/2]
+    const auto n = _mm256_round_ps(
+        _mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    auto r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+
+    auto y = _mm256_set1_ps(1.9875691500e-4f);
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(1.3981999507e-3f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(8.3334519073e-3f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(4.1665795894e-2f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(1.6666665459e-1f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(5.0000001201e-1f));
+    y = _mm256_fmadd_ps(y, _mm256_mul_ps(r, r),
+                        _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+    //! 2^n is applied in two steps, so n outside of the normal exponent
+    //! range does not overflow the exponent field
+    const auto n0 = _mm256_cvtps_epi32(_mm256_min_ps(
+        _mm256_max_ps(n, _mm256_set1_ps(-126.0f)), _mm256_set1_ps(127.0f)));
+    const auto n1 = _mm256_sub_epi32(_mm256_cvtps_epi32(n), n0);
+    const auto pow0 = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_add_epi32(n0, _mm256_set1_epi32(127)), 23));
+    const auto pow1 = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_add_epi32(n1, _mm256_set1_epi32(127)), 23));
+    auto result = _mm256_mul_ps(_mm256_mul_ps(y, pow0), pow1);
+
+    result = _mm256_blendv_ps(
+        result, _mm256_set1_ps(std::numeric_limits<float>::infinity()),
+        isOverflow);
+    result = _mm256_andnot_ps(isUnderflow, result);
+    //! NaN is propagated
+    return _mm256_blendv_ps(result, input,
+                            _mm256_cmp_ps(input, input, _CMP_UNORD_Q));
+}
+
+//! Computes natural logarithm for each lane (max error 1 ULP)
+//! Returns -inf for 0, NaN for negative inputs and inf for inf
+inline __m256 Log(__m256 x)
+{
+    const auto isZero =
+        _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ);
+    const auto isInvalid =
+        _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_NGE_UQ);
+    const auto isInf = _mm256_cmp_ps(
+        x, _mm256_set1_ps(std::numeric_limits<float>::infinity()),
+        _CMP_EQ_OQ);
+
+    //! Denormals are scaled into the normal range first
+    const auto isDenormal =
+        _mm256_cmp_ps(x, _mm256_set1_ps(1.17549435e-38f), _CMP_LT_OQ);
+    x = _mm256_blendv_ps(x, _mm256_mul_ps(x, _mm256_set1_ps(16777216.0f)),
+                         isDenormal);
+    auto exponentBias = _mm256_blendv_ps(
+        _mm256_set1_ps(126.0f), _mm256_set1_ps(150.0f), isDenormal);
+
+    //! x = m * 2^e with m in [sqrt(0.5), sqrt(2))
+    const auto bits = _mm256_castps_si256(x);
+    auto e = _mm256_sub_ps(
+        _mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 23)), exponentBias);
+    auto m = _mm256_castsi256_ps(
+        _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                        _mm256_set1_epi32(0x3f000000)));
+
+    const auto isSmall =
+        _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(isSmall, _mm256_set1_ps(1.0f)));
+    m = _mm256_add_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)),
+                      _mm256_and_ps(isSmall, m));
+
+    const auto m2 = _mm256_mul_ps(m, m);
+    auto y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), m2);
+
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+    y = _mm256_fnmadd_ps(m2, _mm256_set1_ps(0.5f), y);
+    auto result = _mm256_add_ps(m, y);
+    result = _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), result);
+
+    result = _mm256_blendv_ps(
+        result, _mm256_set1_ps(-std::numeric_limits<float>::infinity()),
+        isZero);
+    result = _mm256_blendv_ps(result, x, isInf);
+    return _mm256_blendv_ps(
+        result, _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN()),
+        isInvalid);
+}
+
+//! Computes 1 / (1 + e^-x) for each lane (max error 3.2 ULP)
+inline __m256 Sigmoid(__m256 x)
+{
+    const auto one = _mm256_set1_ps(1.0f);
+    return _mm256_div_ps(
+        one, _mm256_add_ps(one, Exp(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+}
+
+//! Computes hyperbolic tangent for each lane (max error 1.4 ULP)
+inline __m256 Tanh(__m256 x)
+{
+    const auto signMask = _mm256_set1_ps(-0.0f);
+    const auto sign = _mm256_and_ps(x, signMask);
+    const auto absX = _mm256_andnot_ps(signMask, x);
+
+    //! Small inputs use odd polynomial to avoid cancellation in 1 - 2/(e+1)
+    const auto z = _mm256_mul_ps(x, x);
+    auto small = _mm256_set1_ps(-5.70498872745e-3f);
+    small = _mm256_fmadd_ps(small, z, _mm256_set1_ps(2.06390887954e-2f));
+    small = _mm256_fmadd_ps(small, z, _mm256_set1_ps(-5.37397155531e-2f));
+    small = _mm256_fmadd_ps(small, z, _mm256_set1_ps(1.33314422036e-1f));
+    small = _mm256_fmadd_ps(small, z, _mm256_set1_ps(-3.33332819422e-1f));
+    small = _mm256_fmadd_ps(_mm256_mul_ps(small, z), x, x);
+
+    const auto one = _mm256_set1_ps(1.0f);
+    const auto expTwoX = Exp(_mm256_add_ps(absX, absX));
+    const auto large = _mm256_or_ps(
+        _mm256_sub_ps(one, _mm256_div_ps(_mm256_set1_ps(2.0f),
+                                         _mm256_add_ps(expTwoX, one))),
+        sign);
+
+    const auto isSmall =
+        _mm256_cmp_ps(absX, _mm256_set1_ps(0.625f), _CMP_LT_OQ);
+    return _mm256_blendv_ps(large, small, isSmall);
+}
+
+//! Sum of the lanes
+inline float HorizontalSum(__m256 value)
+{
+    const auto sum = _mm_add_ps(_mm256_castps256_ps128(value),
+                                _mm256_extractf128_ps(value, 1));
+    const auto pair = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+}
+
+//! Maximum of the lanes
+inline float HorizontalMax(__m256 value)
+{
+    const auto max = _mm_max_ps(_mm256_castps256_ps128(value),
+                                _mm256_extractf128_ps(value, 1));
+    const auto pair = _mm_max_ps(max, _mm_movehl_ps(max, max));
+    return _mm_cvtss_f32(_mm_max_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+}
+} // namespace Takion::Compute::Vector
+
+#endif
@@ -0,0 +1,95 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_ENGINE_TASKEXECUTOR_HPP
+#define TAKION_ENGINE_TASKEXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Takion::Engine
+{
+//! Fixed pool of worker threads which executes dependency graphs of tasks
+//! Each worker owns a deque of runnable tasks. Tasks released by a worker are
+//! pushed to its own deque and popped from the back, so successors run on the
+//! thread which produced their inputs. Idle workers steal from the front of
+//! deques owned by other workers
+class TaskExecutor
+{
+public:
+    //! \param numWorkers : number of worker threads to spawn
+    //! \param numThreadsPerWorker : number of OpenMP threads each worker uses
+    //! for parallel regions inside the tasks
+    TaskExecutor(std::size_t numWorkers, std::size_t numThreadsPerWorker);
+    ~TaskExecutor();
+
+    TaskExecutor(const TaskExecutor& taskExecutor) = delete;
+    TaskExecutor(TaskExecutor&& taskExecutor) noexcept = delete;
+    TaskExecutor& operator=(const TaskExecutor& taskExecutor) = delete;
+    TaskExecutor& operator=(TaskExecutor&& taskExecutor) noexcept = delete;
+
+    //! Executes every task of the graph and blocks until all of them finish
+    //! Task becomes runnable as soon as all tasks it depends on are finished
+    //! If any task throws, the first exception is rethrown after the graph
+    //! is drained
+    //! \param task : function called with index of the task to execute
+    //! \param successorVector : indices of tasks which depend on each task
+    //! \param numDependencyVector : number of tasks each task depends on
+    void Run(const std::function<void(std::size_t)>& task,
+             const std::vector<std::vector<std::size_t>>& successorVector,
+             const std::vector<std::size_t>& numDependencyVector);
+
+    [[nodiscard]] std::size_t NumWorkers() const
+    {
+        return m_workerVector.size();
+    }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex Mutex;
+        std::deque<std::size_t> Deque;
+    };
+
+    void m_workerLoop(std::size_t workerIdx, std::size_t numThreads);
+
+    void m_push(std::size_t workerIdx, std::size_t taskIdx);
+
+    //! Pops task from the back of the worker's own deque
+    bool m_pop(std::size_t workerIdx, std::size_t& taskIdx);
+
+    //! Steals task from the front of other workers' deques
+    bool m_steal(std::size_t workerIdx, std::size_t& taskIdx);
+
+    void m_execute(std::size_t workerIdx, std::size_t taskIdx);
+
+    std::vector<std::thread> m_workerVector;
+    std::vector<std::unique_ptr<WorkQueue>> m_queueVector;
+
+    //! Graph which is currently executed
+    const std::function<void(std::size_t)>* m_task = nullptr;
+    const std::vector<std::vector<std::size_t>>* m_successorVector = nullptr;
+    std::unique_ptr<std::atomic<std::size_t>[]> m_dependencyCount;
+    std::atomic<std::size_t> m_numRemainingTasks = 0;
+    std::atomic<std::size_t> m_numQueuedTasks = 0;
+    std::exception_ptr m_exception;
+
+    std::mutex m_runMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_workCondition;
+    std::condition_variable m_doneCondition;
+    bool m_stop = false;
+};
+} // namespace Takion::Engine
+
+#endif
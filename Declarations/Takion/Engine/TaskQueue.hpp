@@ -0,0 +1,60 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_ENGINE_TASKQUEUE_HPP
+#define TAKION_ENGINE_TASKQUEUE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Takion::Engine
+{
+//! Single worker thread which executes tasks in the order they were pushed,
+//! while the thread which pushed them keeps running
+//! Results of the tasks are only visible to the caller after Wait
+class TaskQueue
+{
+public:
+    //! \param numThreads : number of OpenMP threads the worker uses for
+    //! parallel regions inside the tasks
+    explicit TaskQueue(std::size_t numThreads);
+    //! Waits for every pushed task before the worker stops
+    ~TaskQueue();
+
+    TaskQueue(const TaskQueue& taskQueue) = delete;
+    TaskQueue(TaskQueue&& taskQueue) noexcept = delete;
+    TaskQueue& operator=(const TaskQueue& taskQueue) = delete;
+    TaskQueue& operator=(TaskQueue&& taskQueue) noexcept = delete;
+
+    void Push(std::function<void()> task);
+
+    //! Blocks until every pushed task finishes
+    //! If any task throws, the remaining tasks still run and the first
+    //! exception is rethrown
+    void Wait();
+
+private:
+    void m_workerLoop(std::size_t numThreads);
+
+    std::deque<std::function<void()>> m_taskDeque;
+    //! Number of tasks which are queued or running
+    std::size_t m_numPendingTasks = 0;
+    std::exception_ptr m_exception;
+
+    std::mutex m_mutex;
+    std::condition_variable m_workCondition;
+    std::condition_variable m_doneCondition;
+    bool m_stop = false;
+    //! Started after every other member is initialized
+    std::thread m_worker;
+};
+} // namespace Takion::Engine
+
+#endif
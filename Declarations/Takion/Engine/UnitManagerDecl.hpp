@@ -8,10 +8,18 @@
 #define TAKION_GRAPH_UNITMANAGER_DECL_HPP
 
 #include <Takion/Units/ComputableUnit.hpp>
+#include <Takion/Units/TrainableUnit.hpp>
+#include <Takion/Engine/TaskExecutor.hpp>
+#include <Takion/Engine/TaskQueue.hpp>
 #include <Takion/FrontEnd/UnitMetaData.hpp>
+#include <Takion/Computations/BFloat16.hpp>
 #include <Takion/Computations/Optimizers/Optimizer.hpp>
 #include <Takion/Utils/Loaders/Loader.hpp>
+#include <deque>
+#include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace Takion::Engine
 {
@@ -38,38 +46,302 @@ public:
     void SetLoader(const UnitId& unitId,
                    std::unique_ptr<Util::Loader<T>> loader);
 
+    //! Sets type weights of dense units are stored in
+    //! Applied to units built by following compilations
+    void SetStorageType(Compute::StorageType storageType)
+    {
+        m_storageType = storageType;
+    }
+
+    //! Enables GEMM tuning on following compilations
+    //! Products of dense units are tuned after the units are built, and
+    //! tuned blockings are read from and written back to cachePath
+    //! Empty path disables tuning
+    void SetGemmTuningCache(std::string cachePath)
+    {
+        m_gemmTuningCachePath = std::move(cachePath);
+    }
+
+    //! Accumulates gradients of numMicroBatches back propagations before
+    //! the optimizer is applied, on following compilations
+    //! Each Backward propagates a micro batch, and the optimizer updates
+    //! weights with the mean of the accumulated gradients after every
+    //! numMicroBatches calls. 1 applies the optimizer after every Backward
+    //! Gradients of an incomplete group are kept until following calls
+    //! complete it, and are discarded by compilation
+    void SetGradientAccumulation(std::size_t numMicroBatches)
+    {
+        if (numMicroBatches == 0)
+            throw std::invalid_argument(
+                "Gradients should be accumulated over at least 1 micro batch");
+        m_numMicroBatches = numMicroBatches;
+    }
+
+    //! Lets tensors placed in the arena share memory on following
+    //! compilations (enabled by default)
+    //! Disabled, every tensor gets its own range of the arena, which gives
+    //! reference results when memory planning is suspected
+    void SetMemorySharing(bool isEnabled)
+    {
+        m_isMemorySharingEnabled = isEnabled;
+    }
+
+    //! Keeps output of the unit observable on following compilations by
+    //! excluding it from graph passes that would replace it
+    void KeepOutput(const UnitId& unitId)
+    {
+        m_keptOutputSet.emplace(unitId);
+    }
+
     Shape GetUnitOutputShape(const UnitId& unitId);
 
+    //! Builds units from their metadata
+    //! Dense and Conv2D units whose only consumer is ReLU or Sigmoid absorb
+    //! the activation before units are built (see m_fuseActivations)
+    //! SoftMax feeding only CrossEntropy is merged into SoftMaxCrossEntropy
+    //! (see m_fuseSoftMaxCrossEntropy)
+    //! Execution plan used by Forward and Backward is built once here
+    //! Tensors of the units are placed in a single arena (see m_planMemory)
+    //! Trainable tensors, their updates and optimizer moments are placed in
+    //! slabs (see m_placeParameters)
     void Compile(const std::string& optimizerName, const Parameter& parameter);
 
+    //! Builds units which only support forward propagation
+    //! Gradients, scratch tensors of back propagation and optimizers are not
+    //! allocated, and Backward throws
+    void CompileForInference();
+
+    //! Builds units for inference like CompileForInference, and runs int8
+    //! GEMM on dense units afterwards
+    //! Forward propagation is executed numCalibrationBatches times on
+    //! batches given by the loaders of Fetcher units to record input range
+    //! of each dense unit, then weights are quantized
+    //! Only float models can be quantized
+    void CompileForQuantizedInference(std::size_t numCalibrationBatches);
+
+    //! Executes forward propagation by replaying the execution plan
     virtual void Forward();
 
+    //! Executes back propagation by replaying the execution plan
+    //! Optimizer updates the weights of each unit on the update queue as
+    //! soon as back propagation of the unit finishes, while units before it
+    //! keep propagating. Forward waits for the updates, so every forward
+    //! propagation sees the weights of the previous step
     virtual void Backward();
 
+    //! Executes forward propagation of given cycle on the worker pool
+    //! Each unit runs as soon as the units it depends on are finished, so
+    //! independent branches of the graph are computed concurrently
+    //! Throws if State of the unit does not match the cycle when it runs
     virtual void AsyncForward(std::size_t cycle);
 
+    //! Executes back propagation of given cycle on the worker pool
+    //! Weights are updated on the update queue like Backward
+    //! Throws if State of the unit does not match the cycle when it runs
     virtual void AsyncBackward(std::size_t cycle);
 
+    //! Blocks until weight updates of the last back propagation finish, and
+    //! rethrows exception thrown by the optimizer
+    //! Forward, AsyncForward, GetUnit and the slab accessors wait by
+    //! themselves
+    void WaitForParameterUpdates();
+
     virtual void ResetState();
 
+    //! Starts loading inputs of following cycles on every Fetcher unit
+    //! Called between Forward and ResetState, loading of the next cycles
+    //! overlaps with back propagation of the current cycle
+    //! \param depth : maximum number of cycles loaded in advance
+    void Prefetch(std::size_t depth);
+
     virtual void ChangeBatchSize(std::size_t batchSize);
 
+    //! Returns forward output of the unit
+    //! Fused activation units resolve to the unit which computes them
+    //! Throws if the unit applies fused activation to its own output, since
+    //! output before the activation is not kept
     [[nodiscard]] const Tensor<T>& GetOutput(UnitId unitId) const;
 
+    //! Waits for pending weight updates, so trainable tensors of the unit
+    //! can be read
     std::unique_ptr<Graph::ComputableUnit<T>>& GetUnit(const UnitId& unitId);
 
+    //! Planned peak memory of the tensors placed in the arena
+    [[nodiscard]] std::size_t ArenaByteSize() const
+    {
+        return m_arena ? m_arena->GetDataByteSize() : 0;
+    }
+
+    //! Memory the tensors placed in the arena would take if each of them
+    //! had its own buffer
+    [[nodiscard]] std::size_t PlannedTensorByteSize() const
+    {
+        return m_plannedTensorByteSize;
+    }
+
+    //! Units in the order Forward executes them, with the number of units
+    //! each of them waits for on the worker pool
+    //! Available after compilation
+    [[nodiscard]] std::vector<std::pair<UnitId, std::size_t>> ForwardSchedule()
+    const
+    {
+        return m_forwardPlan.Schedule();
+    }
+
+    //! Units in the order Backward executes them, with the number of units
+    //! each of them waits for on the worker pool
+    //! Units which do not propagate gradients are not scheduled
+    [[nodiscard]] std::vector<std::pair<UnitId, std::size_t>>
+    BackwardSchedule() const
+    {
+        return m_backwardPlan.Schedule();
+    }
+
+    //! Trainable tensors of every unit in a single contiguous buffer
+    //! Checkpoints can be written and restored with a single copy
+    //! Available after compilation
+    [[nodiscard]] Tensor<T>& ParameterSlab();
+
+    //! Updates of the trainable tensors the optimizer applies, at the same
+    //! offsets as ParameterSlab
+    //! With gradient accumulation, it holds the sum of the micro batches
+    //! propagated so far, which becomes their mean before it is applied
+    //! Available after compilation for training
+    [[nodiscard]] Tensor<T>& GradientSlab();
+
 private:
-    [[nodiscard]] bool m_isForwardCopyReady(const UnitId& subjectUnitId) const;
-    [[nodiscard]] bool m_isBackwardCopyReady(const UnitId& subjectUnitId) const;
-    //! Copies forward output of subject unit to forward inputs of destination units with direct connection
-    void m_forwardCopy(const UnitId& subjectUnitId);
-    //! Copies backward outputs of subject unit to backward inputs of destination units with direct connection
-    void m_backwardCopy(const UnitId& subjectUnitId);
+    //! Single step of the execution plan
+    //! Unit is executed and its output is copied to every pair in CopyVector
+    //! (source, destination) in order
+    //! Destinations in ShareVector refer to the buffer of their source, so
+    //! only their State is updated
+    struct ExecutionStep
+    {
+        Graph::ComputableUnit<T>* Unit = nullptr;
+        std::vector<std::pair<const Tensor<T>*, Tensor<T>*>> CopyVector;
+        std::vector<std::pair<const Tensor<T>*, Tensor<T>*>> ShareVector;
+
+        //! Adds edge from source to destination. Tensors on same device
+        //! share the buffer, others are copied
+        void AddEdge(const Tensor<T>* source, Tensor<T>* destination);
+    };
+
+    //! Steps of forward or backward propagation and dependencies between them
+    //! Steps are stored in topological order
+    struct ExecutionPlan
+    {
+        std::vector<ExecutionStep> StepVector;
+        //! Indices of steps which depend on each step
+        std::vector<std::vector<std::size_t>> SuccessorVector;
+        //! Number of steps each step depends on
+        std::vector<std::size_t> NumDependencyVector;
+
+        void AddStepDependency(std::size_t stepIdx,
+                               std::vector<std::size_t> dependencyVector);
+
+        //! Maximum number of steps which can run concurrently
+        [[nodiscard]] std::size_t MaxWidth() const;
+
+        //! Units of the steps with their number of dependencies
+        [[nodiscard]] std::vector<std::pair<UnitId, std::size_t>> Schedule()
+        const;
+    };
+
+    //! Range of the slabs holding trainable tensors of a single unit
+    //! Optimizer updates each segment as a whole with its own state
+    struct ParameterSegment
+    {
+        ParameterSegment(Graph::TrainableUnit<T>* unit, std::size_t size,
+                         Compute::Device device)
+            : Unit(unit),
+              Parameters(Shape({ size }), device),
+              Gradients(Shape({ size }), device),
+              MicroBatchGradients(Shape({ size }), device)
+        {
+        }
+
+        Graph::TrainableUnit<T>* Unit;
+        Tensor<T> Parameters;
+        Tensor<T> Gradients;
+        //! Gradients written by back propagation of the unit
+        //! Same as Gradients unless gradients are accumulated
+        Tensor<T> MicroBatchGradients;
+        Compute::OptimizerState<T> State;
+    };
+
+    void m_executeStep(ExecutionStep& step, bool isForward);
+
+    //! Makes destinations of shared edges refer to the buffer of their
+    //! source. Called again whenever buffers are reallocated
+    void m_shareTensorData();
+
+    //! Places forward outputs, gradients and backward scratch tensors of
+    //! the units in a single arena
+    //! Forward outputs stay valid for the whole cycle since back propagation
+    //! and Output read them. Gradients live from the backward step which
+    //! writes them to the step which reads them, and scratch tensors only
+    //! during their own step. Two tensors share memory only if every access
+    //! of one is ordered before every access of the other by the backward
+    //! plan, so sharing is also safe on the worker pool
+    void m_planMemory();
+
+    //! Places trainable tensors of every unit in the parameter slab, their
+    //! updates in the gradient slab and each optimizer moment in its own
+    //! slab at the same offsets
+    //! Units are placed in order of back propagation, and tensors of each
+    //! unit are adjacent. Offsets are aligned to cache lines
+    void m_placeParameters();
+
+    //! Pushes weight update of the unit to the update queue if it has
+    //! trainable tensors, or applies it right away if there is no queue
+    //! Only reads state set up by compilation, so workers of the pool can
+    //! call it concurrently
+    void m_enqueueUpdate(const Graph::ComputableUnit<T>* unit);
+
+    //! Returns worker pool used by AsyncForward and AsyncBackward
+    //! Pool is created on first use
+    TaskExecutor& m_getExecutor();
+
+    //! Sorts units topologically and stores the forward and backward
+    //! schedules with their copies in flat arrays, so Forward and Backward
+    //! do not need to poll the readiness of units
+    void m_buildExecutionPlan();
+
+    //! Puts units removed by graph passes back into the graph and discards
+    //! units built by the previous compilation, so passes of every
+    //! compilation start from the graph the user built
+    void m_restoreFusedUnits();
+
+    //! Graph pass which rewrites Dense -> activation and Conv2D -> activation
+    //! chains
+    //! Activation is removed from the graph and applied in the epilogue of
+    //! the dense or convolution unit, so consumers of the activation read its
+    //! output directly. Units in m_keptOutputSet are not fused
+    void m_fuseActivations();
+
+    //! Graph pass which rewrites SoftMax -> CrossEntropy chains into single
+    //! SoftMaxCrossEntropy unit reading the input of the SoftMax
+    //! Both removed units resolve to the fused unit, whose output is the
+    //! SoftMax probability. Losses in m_keptOutputSet are not fused
+    void m_fuseSoftMaxCrossEntropy();
+
+    //! Replaces previousUnitId with newUnitId in outputs of unitId
+    void m_replaceOutputUnitId(const UnitId& unitId,
+                               const UnitId& previousUnitId,
+                               const UnitId& newUnitId);
+
+    //! Loads the tuning cache, tunes shape classes of dense units which are
+    //! not in the cache and saves the cache
+    void m_tuneGemm();
+
+    //! Returns the unit that computes output of given unitId
+    [[nodiscard]] UnitId m_resolveUnitId(const UnitId& unitId) const;
+
+    void m_compile(const std::string& optimizerName,
+                   const Parameter& parameter);
 
     bool m_appendSource(const FrontEnd::UnitMetaData<T>& unitMetaData);
-    bool m_appendHidden(const FrontEnd::UnitMetaData<T>& unitMetaData,
-                        const std::string& optimizerName,
-                        const Parameter& parameter);
+    bool m_appendHidden(const FrontEnd::UnitMetaData<T>& unitMetaData);
     bool m_appendLoss(const FrontEnd::UnitMetaData<T>& unitMetaData);
 
 
@@ -82,6 +354,44 @@ private:
     std::unordered_map<UnitId, std::unique_ptr<Graph::ComputableUnit<T>>>
     m_unitMap;
     std::unordered_map<UnitId, std::unique_ptr<Util::Loader<T>>> m_loaderMap;
+    //! Activation fused into each dense and convolution unit
+    std::unordered_map<UnitId, Activation> m_fusedActivationMap;
+    //! Units removed by graph passes and the units which compute them
+    std::unordered_map<UnitId, UnitId> m_fusedUnitMap;
+    //! Metadata of units removed by graph passes, as the user built them
+    std::unordered_map<UnitId, FrontEnd::UnitMetaData<T>> m_fusedMetaDataMap;
+    //! Units whose output graph passes should not replace
+    std::unordered_set<UnitId> m_keptOutputSet;
+    ExecutionPlan m_forwardPlan;
+    ExecutionPlan m_backwardPlan;
+    std::unique_ptr<TaskExecutor> m_executor;
+    std::unique_ptr<Tensor<T>> m_arena;
+    std::unique_ptr<Compute::Optimizer<T>> m_optimizer;
+    std::unique_ptr<Tensor<T>> m_parameterSlab;
+    std::unique_ptr<Tensor<T>> m_gradientSlab;
+    //! Gradients of the current micro batch, only allocated if gradients
+    //! are accumulated
+    std::unique_ptr<Tensor<T>> m_microBatchGradientSlab;
+    std::vector<Tensor<T>> m_momentSlabVector;
+    //! Segments of the slabs in order of back propagation
+    //! Deque keeps the segments in place, since updates refer to them
+    std::deque<ParameterSegment> m_segmentDeque;
+    std::unordered_map<const Graph::ComputableUnit<T>*, ParameterSegment*>
+        m_segmentMap;
+    //! Applies the optimizer after back propagation of each unit
+    //! Created by compilation for training if more than one thread is
+    //! available, otherwise updates run inline
+    //! Declared after everything the updates refer to, so pending updates
+    //! finish before any of it is destroyed
+    std::unique_ptr<TaskQueue> m_updateQueue;
+    bool m_isInference = false;
+    bool m_isMemorySharingEnabled = true;
+    Compute::StorageType m_storageType = Compute::StorageType::Float32;
+    std::string m_gemmTuningCachePath;
+    std::size_t m_plannedTensorByteSize = 0;
+    std::size_t m_numMicroBatches = 1;
+    //! Index of the micro batch Backward propagates next
+    std::size_t m_microBatchIdx = 0;
     std::size_t m_batchSize;
 };
 } // namespace Takion::Graph
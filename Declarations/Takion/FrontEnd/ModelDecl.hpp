@@ -47,6 +47,23 @@ public:
                        >(),
                        std::string name = "");
 
+    //! 2D convolution of (channel, height, width) source with numFilters
+    //! filters of (kernelHeight x kernelWidth)
+    //! stride, padding and dilation are applied to both dimensions, and
+    //! source is padded with zeros on both sides
+    //! Output shape is (numFilters, output height, output width)
+    AbsTensor<T> Conv2D(AbsTensor<T> source, unsigned numFilters,
+                        unsigned kernelHeight, unsigned kernelWidth,
+                        unsigned stride = 1, unsigned padding = 0,
+                        unsigned dilation = 1,
+                        std::unique_ptr<Compute::Initializer<T>>
+                        weightInitializer = std::make_unique<
+                            Compute::HeNormal<T>>(),
+                        std::unique_ptr<Compute::Initializer<T>>
+                        biasInitializer = std::make_unique<
+                            Compute::HeNormal<T>>(),
+                        std::string name = "");
+
     AbsTensor<T> ReLU(AbsTensor<T> source,
                       std::string name = "");
 
@@ -57,16 +74,102 @@ public:
     AbsTensor<T> MSE(AbsTensor<T> prediction, AbsTensor<T> label,
                      std::string name);
 
+    //! Output of the unit is -label * log(prediction) for each element
+    //! CrossEntropy of SoftMax which has no other consumer is compiled as
+    //! SoftMaxCrossEntropy unless KeepOutput was called for the loss, so its
+    //! output is the SoftMax probability instead
     AbsTensor<T> CrossEntropy(AbsTensor<T> prediction, AbsTensor<T> label,
                               std::string name);
 
+    //! Applies SoftMax to prediction and computes CrossEntropy with label
+    //! Equivalent to CrossEntropy(SoftMax(prediction), label), but computed
+    //! in single numerically stable unit. Output of the unit is the SoftMax
+    //! probability
+    AbsTensor<T> SoftMaxCrossEntropy(AbsTensor<T> prediction,
+                                     AbsTensor<T> label, std::string name);
+
+    //! Sets type weights of dense units are stored in
+    //! Must be called before compilation. BFloat16 keeps float weights for
+    //! the optimizer, and products read their bfloat16 copy
+    void SetStorageType(Compute::StorageType storageType)
+    {
+        m_unitManager.SetStorageType(storageType);
+    }
+
+    //! Tunes GEMM blocking of every dense unit on following compilations
+    //! Tuned blockings are stored in cachePath for each processor, so later
+    //! compilations with the same cache only benchmark new shapes
+    //! Shapes which were never tuned use the default blocking
+    void EnableGemmTuning(std::string cachePath)
+    {
+        m_unitManager.SetGemmTuningCache(std::move(cachePath));
+    }
+
+    //! Trains with gradients accumulated over numMicroBatches batches on
+    //! following compilations
+    //! Each Train or cycle of Fit propagates a micro batch of the model's
+    //! batch size, and the optimizer is applied once every numMicroBatches
+    //! of them with the mean of their gradients. Effective batch size is
+    //! numMicroBatches times the batch size, while tensors of propagation
+    //! only hold a single micro batch
+    //! If the number of cycles is not a multiple of numMicroBatches, the
+    //! trailing micro batches are not applied when Fit returns. Their
+    //! gradients stay accumulated and the group is completed by following
+    //! Train or Fit calls. Compiling again discards them
+    void EnableGradientAccumulation(std::size_t numMicroBatches)
+    {
+        m_unitManager.SetGradientAccumulation(numMicroBatches);
+    }
+
+    //! Lets forward outputs, gradients and scratch tensors share memory on
+    //! following compilations where their lifetimes do not overlap
+    //! (enabled by default). Disabling it only increases ArenaByteSize
+    void SetMemorySharing(bool isEnabled)
+    {
+        m_unitManager.SetMemorySharing(isEnabled);
+    }
+
+    //! Keeps output of the unit available from Output on following
+    //! compilations
+    //! Dense and Conv2D units whose only consumer is ReLU or Sigmoid are
+    //! otherwise fused with the activation, and their output before the
+    //! activation is not computed. CrossEntropy of SoftMax is otherwise
+    //! fused into SoftMaxCrossEntropy, which outputs the probability
+    void KeepOutput(AbsTensor<T> absTensor)
+    {
+        m_unitManager.KeepOutput(absTensor.GetPrevOutput());
+    }
+
+    //! Compiles the model for training
+    //! \param optimizer : "SGD", "Adam" or "AdamW"
+    //! \param optimizerParams : "LearningRate" is required. Optional
+    //! floating point parameters are "Momentum" and "WeightDecay" for SGD
+    //! (with integer "Nesterov"), and "Beta1", "Beta2", "Epsilon" and
+    //! "WeightDecay" for Adam and AdamW (AdamW decays by 0.01 by default)
     void Compile(std::string optimizer, Parameter optimizerParams);
 
+    //! Compiles the model for Predict only
+    //! Tensors and optimizers used by back propagation are not allocated, so
+    //! Train and Fit throw afterwards
+    void CompileForInference();
+
+    //! Compiles the model for Predict with dense units running on int8 GEMM
+    //! Weights are quantized with scale per output channel, and inputs of
+    //! each dense unit with the range observed while predicting
+    //! numCalibrationBatches batches from the loaders of Fetcher units
+    //! Only float models can be quantized
+    void CompileForQuantizedInference(std::size_t numCalibrationBatches);
+
     void Train();
 
     void Train(std::map<AbsTensor<T>, std::vector<T>> inputDataMap,
                AbsTensor<T> labelUnit, std::vector<T> label);
 
+    //! Trains a single cycle like Train, executing each unit on the worker
+    //! pool as soon as the units it depends on finish, so independent
+    //! branches of the graph are computed concurrently
+    void AsyncTrain();
+
     void Predict();
 
     void Predict(std::map<AbsTensor<T>, std::vector<T>> inputDataMap);
@@ -74,13 +177,82 @@ public:
     void Predict(std::map<AbsTensor<T>, std::vector<T>> inputDataMap,
                  AbsTensor<T> labelUnit, std::vector<T> label);
 
-    void Fit(std::size_t epochs);
+    //! Trains the model for given number of cycles using the loaders of
+    //! Fetcher units
+    //! \param epochs : number of cycles to train
+    //! \param pipelineDepth : number of cycles Fetcher units can load in
+    //! advance while back propagation of the current cycle runs
+    //! (0 loads each cycle right before its forward propagation)
+    void Fit(std::size_t epochs, std::size_t pipelineDepth = 0);
 
+    //! Returns output of the unit from the last forward propagation
+    //! Throws for Dense and Conv2D units fused with their activation unless
+    //! KeepOutput was called for them before compilation
+    //! CrossEntropy loss fused with its SoftMax returns the SoftMax
+    //! probability instead of -label * log(prediction)
     [[nodiscard]] Util::TensorData<T> Output(
         AbsTensor<T> absTensor) const;
 
     [[nodiscard]] T GetLoss(AbsTensor<T> lossId);
 
+    //! Returns trainable tensor of the unit without its padding
+    //! \param key : "weight" or "bias" for Dense and Conv2D units
+    [[nodiscard]] Util::TensorData<T> TrainableTensor(AbsTensor<T> absTensor,
+                                                      const std::string& key);
+
+    //! Returns update of the trainable tensor written by the last back
+    //! propagation (of the last micro batch with gradient accumulation),
+    //! without its padding
+    [[nodiscard]] Util::TensorData<T> GradientTensor(AbsTensor<T> absTensor,
+                                                     const std::string& key);
+
+    //! Planned peak memory of forward outputs, gradients and scratch tensors
+    //! Available after Compile
+    [[nodiscard]] std::size_t ArenaByteSize() const
+    {
+        return m_unitManager.ArenaByteSize();
+    }
+
+    //! Memory tensors placed in the arena would take without sharing it
+    //! Available after Compile
+    [[nodiscard]] std::size_t PlannedTensorByteSize() const
+    {
+        return m_unitManager.PlannedTensorByteSize();
+    }
+
+    //! Units in the order forward propagation executes them, with the
+    //! number of units each of them waits for
+    //! Units removed by fusion are not scheduled. Available after Compile
+    [[nodiscard]] std::vector<std::pair<UnitId, std::size_t>> ForwardSchedule()
+    const
+    {
+        return m_unitManager.ForwardSchedule();
+    }
+
+    //! Units in the order back propagation executes them, with the number
+    //! of units each of them waits for. Available after Compile
+    [[nodiscard]] std::vector<std::pair<UnitId, std::size_t>>
+    BackwardSchedule() const
+    {
+        return m_unitManager.BackwardSchedule();
+    }
+
+    //! Trainable tensors of every unit in a single contiguous buffer
+    //! Checkpoints can be saved or restored with a single copy of its data
+    //! Available after Compile
+    [[nodiscard]] Tensor<T>& ParameterSlab()
+    {
+        return m_unitManager.ParameterSlab();
+    }
+
+    //! Updates of the trainable tensors at the same offsets as
+    //! ParameterSlab, so they can be reduced across replicas at once
+    //! Available after Compile for training
+    [[nodiscard]] Tensor<T>& GradientSlab()
+    {
+        return m_unitManager.GradientSlab();
+    }
+
 
     void ChangeBatchSize(std::size_t batchSize)
     {
@@ -92,6 +264,13 @@ public:
                       std::function<std::vector<T>()> loaderFunction);
 
 private:
+    //! Returns trainable unit computing given unit, waiting for its updates
+    [[nodiscard]] Graph::TrainableUnit<T>* m_getTrainableUnit(
+        AbsTensor<T> absTensor);
+
+    //! Copies elements of the tensor without its padding
+    [[nodiscard]] static Util::TensorData<T> m_toTensorData(
+        const Tensor<T>& tensor);
 
     void m_appendSubjectUnitToPreviousOutput(const UnitId& subjectUnit,
                                              const UnitId& previousUnit);
@@ -43,6 +43,11 @@ public:
 
     void SetOutputUnitIdVector(std::vector<UnitId> unitIdVector);
 
+    //! Redirects every input connected to previousUnitId to newUnitId
+    //! Used by graph passes which remove units from the graph
+    void ReplaceInputUnitId(const UnitId& previousUnitId,
+                            const UnitId& newUnitId);
+
     //! Used to add internal tensor if required
     //! \param key : key to store the tensor
     //! \param tensor: tensor to store
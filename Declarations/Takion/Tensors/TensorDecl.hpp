@@ -48,8 +48,22 @@ public:
 
     static void MoveTensorData(Tensor<T>& source, Tensor<T>& destination);
 
+    //! Copies data of the source into the buffer owned by destination
+    //! Tensors with identical layouts are copied with single memcpy
     static void CopyTensorData(const Tensor<T>& source, Tensor<T>& destination);
 
+    //! Destination refers to data of the source without taking ownership
+    //! Buffer of the destination is deallocated. Source must keep its buffer
+    //! while destination is in use. Copying into or resizing the
+    //! destination gives it its own buffer again
+    static void ShareTensorData(const Tensor<T>& source, Tensor<T>& destination);
+
+    //! Destination refers to part of the source buffer starting at offset
+    //! Layouts of the tensors can differ
+    //! \param offset : offset in number of elements from start of the source
+    static void ShareTensorData(const Tensor<T>& source, Tensor<T>& destination,
+                                std::size_t offset);
+
     void ChangeBatchSize(std::size_t newBatchSize);
 
     T& At(std::size_t batchIdx, std::vector<std::size_t> index);
@@ -93,6 +107,8 @@ private:
     std::size_t m_elementSize = 0;
     std::size_t m_columnElementSize = 0;
     std::atomic_bool m_hasOwnership = false;
+    //! True if Data refers to buffer owned by another tensor
+    std::atomic_bool m_isShared = false;
 
     std::size_t m_getElementSize() const;
 
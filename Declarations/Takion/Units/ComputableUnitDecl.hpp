@@ -10,6 +10,8 @@
 #include <Takion/Units/UnitType.hpp>
 #include <Takion/Tensors/Tensor.hpp>
 #include <future>
+#include <string>
+#include <vector>
 
 namespace Takion::Graph
 {
@@ -84,6 +86,14 @@ public:
 
     virtual void ChangeBatchSize(std::size_t batchSize);
 
+    //! Keys of InternalTensorMap entries which only hold temporary values of
+    //! Backward. They are overwritten before being read on every call, so the
+    //! engine may place them in memory shared with other units
+    [[nodiscard]] virtual std::vector<std::string> BackwardScratchKeys() const
+    {
+        return {};
+    }
+
     T GetLoss()
     {
         return m_loss;
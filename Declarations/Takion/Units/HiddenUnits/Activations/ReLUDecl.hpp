@@ -27,7 +27,8 @@ public:
     ReLU(const UnitId& unitId, UnitId sourceUnitId,
          Tensor<T> forwardInput,
          std::unordered_map<UnitId, Tensor<T>> backwardInputVector,
-         Tensor<T> forwardOutput, Tensor<T> backwardOutput,
+         Tensor<T> forwardOutput,
+         std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
          std::unordered_map<std::string, Tensor<T>> internalTensorMap,
          std::size_t batchSize);
     ~ReLU() = default;
@@ -37,7 +38,10 @@ public:
     ReLU& operator=(const ReLU& activationUnit) = delete;
     ReLU& operator=(ReLU&& activationUnit) noexcept;
 
-    static ReLU<T> CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData);
+    //! \param inferenceOnly : if true, tensors used by back propagation are
+    //! not allocated and the unit cannot execute Backward
+    static ReLU<T> CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData,
+                              bool inferenceOnly = false);
 
     void Forward() override;
 
@@ -49,6 +53,11 @@ public:
 
     void ChangeBatchSize(std::size_t batchSize) override;
 
+    [[nodiscard]] std::vector<std::string> BackwardScratchKeys() const override
+    {
+        return { "backwardTemp" };
+    }
+
 private:
 
     UnitId m_sourceUnitId;
@@ -24,7 +24,8 @@ public:
 
     Sigmoid(const UnitId& unitId, UnitId sourceUnitId, Tensor<T> forwardInput,
             std::unordered_map<UnitId, Tensor<T>> backwardInputVector,
-            Tensor<T> forwardOutput, Tensor<T> backwardOutput,
+            Tensor<T> forwardOutput,
+            std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
             std::unordered_map<std::string, Tensor<T>> internalTensorMap,
             std::size_t batchSize);
     ~Sigmoid() = default;
@@ -34,7 +35,10 @@ public:
     Sigmoid& operator=(const Sigmoid& activationUnit) = delete;
     Sigmoid& operator=(Sigmoid&& activationUnit) noexcept;
 
-    static Sigmoid<T> CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData);
+    //! \param inferenceOnly : if true, tensors used by back propagation are
+    //! not allocated and the unit cannot execute Backward
+    static Sigmoid<T> CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData,
+                                 bool inferenceOnly = false);
 
     void Forward() override;
 
@@ -46,6 +50,11 @@ public:
 
     void ChangeBatchSize(std::size_t batchSize) override;
 
+    [[nodiscard]] std::vector<std::string> BackwardScratchKeys() const override
+    {
+        return { "backwardTemp" };
+    }
+
 private:
     UnitId m_sourceUnitId;
 
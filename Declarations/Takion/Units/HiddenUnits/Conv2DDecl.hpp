@@ -0,0 +1,98 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_GRAPH_CONV2D_DECL_HPP
+#define TAKION_GRAPH_CONV2D_DECL_HPP
+
+#include <Takion/Units/ComputableUnit.hpp>
+#include <Takion/FrontEnd/UnitMetaData.hpp>
+#include <Takion/Units/TrainableUnit.hpp>
+#include <Takion/Utils/Declarations.hpp>
+#include <Takion/Computations/GEMM/Convolution.hpp>
+#include <memory>
+
+namespace Takion::Graph
+{
+//! 2D convolution over (channel, height, width) inputs
+//! Patches of the input are expanded to column matrices (im2col), and the
+//! convolution is computed as product of the weight and the column matrix
+//! of each sample on the packed GEMM
+//! Weight has one row of (channel x kernel height x kernel width) elements
+//! for each filter, and bias has one element for each filter
+template <typename T>
+class Conv2DUnit : public ComputableUnit<T>, public TrainableUnit<T>
+{
+public:
+    using ComputableUnit<T>::ForwardInputMap;
+    using TrainableUnit<T>::TrainableTensorMap;
+    using ComputableUnit<T>::ForwardOutput;
+    using ComputableUnit<T>::BackwardInputMap;
+    using ComputableUnit<T>::BackwardOutputMap;
+    using ComputableUnit<T>::InternalTensorMap;
+    using ComputableUnit<T>::BatchSize;
+    using TrainableUnit<T>::GradientTensorMap;
+
+    Conv2DUnit(const UnitId& unitId, const UnitId& sourceUnitId,
+               Tensor<T> forwardInput,
+               std::unordered_map<UnitId, Tensor<T>> backwardInputMap,
+               Tensor<T> forwardOutput,
+               std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
+               std::unordered_map<std::string, Tensor<T>> internalTensorMap,
+               std::unordered_map<std::string, Tensor<T>> trainableTensorMap,
+               std::unordered_map<std::string, Tensor<T>> gradientTensorMap,
+               std::size_t batchSize, Compute::Conv2DGeometry geometry,
+               Activation activation = Activation::Linear);
+    ~Conv2DUnit() = default;
+
+    Conv2DUnit(const Conv2DUnit<T>& conv2DUnit) = delete;
+    Conv2DUnit(Conv2DUnit<T>&& conv2DUnit) noexcept;
+    Conv2DUnit& operator=(const Conv2DUnit<T>& conv2DUnit) = delete;
+    Conv2DUnit& operator=(Conv2DUnit<T>&& conv2DUnit) noexcept;
+
+    //! Creates convolution unit from its metadata
+    //! Kernel size, stride, padding and dilation are read from integer
+    //! parameters of the metadata (see FrontEnd::Model::Conv2D)
+    //! \param activation : activation fused into the output of this unit
+    //! \param inferenceOnly : if true, tensors used by back propagation are
+    //! not allocated and the unit cannot execute Backward
+    static Conv2DUnit<T> CreateUnit(
+        const FrontEnd::UnitMetaData<T>& unitMetaData,
+        Activation activation = Activation::Linear,
+        bool inferenceOnly = false);
+
+    void Forward() override;
+
+    void AsyncForward(std::promise<bool> promise) override;
+
+    void Backward() override;
+
+    void AsyncBackward(std::promise<bool> promise) override;
+
+    void ChangeBatchSize(std::size_t batchSize) override;
+
+    [[nodiscard]] std::vector<std::string> BackwardScratchKeys() const override
+    {
+        return { "delta", "columnGradient" };
+    }
+
+    [[nodiscard]] const Compute::Conv2DGeometry& Geometry() const
+    {
+        return m_geometry;
+    }
+
+private:
+    UnitId m_sourceUnitId;
+    Compute::Conv2DGeometry m_geometry;
+    Activation m_activation;
+
+    static void m_checkShape(const Shape& inputShape, const Shape& outputShape,
+                             const Shape& weightShape, const Shape& biasShape,
+                             const Compute::Conv2DGeometry& geometry,
+                             const std::string& unitName);
+};
+} // namespace Takion::Graph
+
+#endif
@@ -10,6 +10,9 @@
 #include <Takion/Units/ComputableUnit.hpp>
 #include <Takion/FrontEnd/UnitMetaData.hpp>
 #include <Takion/Units/TrainableUnit.hpp>
+#include <Takion/Utils/Declarations.hpp>
+#include <Takion/Computations/GEMM/QuantizedGemm.hpp>
+#include <memory>
 
 namespace Takion::Graph
 {
@@ -23,17 +26,20 @@ public:
     using ComputableUnit<T>::BackwardInputMap;
     using ComputableUnit<T>::BackwardOutputMap;
     using ComputableUnit<T>::InternalTensorMap;
-    using TrainableUnit<T>::m_optimizer;
+    using ComputableUnit<T>::BatchSize;
+    using TrainableUnit<T>::GradientTensorMap;
 
 
     DenseUnit(const UnitId& unitId, const UnitId& sourceUnitId,
               Tensor<T> forwardInput,
               std::unordered_map<UnitId, Tensor<T>> backwardInputMap,
-              Tensor<T> forwardOutput, Tensor<T> backwardOutput,
+              Tensor<T> forwardOutput,
+              std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
               std::unordered_map<std::string, Tensor<T>> internalTensorMap,
               std::unordered_map<std::string, Tensor<T>> trainableTensorMap,
-              std::unique_ptr<Compute::Optimizer<T>> optimizer,
-              std::size_t batchSize);
+              std::unordered_map<std::string, Tensor<T>> gradientTensorMap,
+              std::size_t batchSize,
+              Activation activation = Activation::Linear);
     ~DenseUnit() = default;
 
     DenseUnit(const DenseUnit<T>& denseUnit) = delete;
@@ -41,9 +47,20 @@ public:
     DenseUnit& operator=(const DenseUnit<T>& denseUnit) = delete;
     DenseUnit& operator=(DenseUnit<T>&& denseUnit) noexcept;
 
+    //! Creates dense unit from its metadata
+    //! \param activation : activation fused into the output of this unit.
+    //! Forward output becomes activation(input * weight + bias) and backward
+    //! propagates through the activation using the stored output
+    //! \param inferenceOnly : if true, tensors used by back propagation are
+    //! not allocated and the unit cannot execute Backward
+    //! \param weightStorage : if BFloat16, products read bfloat16 copy of
+    //! the weight, which is refreshed after every update of the float weight
+    //! (float units only)
     static DenseUnit<T> CreateUnit(
         const FrontEnd::UnitMetaData<T>& unitMetaData,
-        std::unique_ptr<Compute::Optimizer<T>> optimizer);
+        Activation activation = Activation::Linear,
+        bool inferenceOnly = false,
+        Compute::StorageType weightStorage = Compute::StorageType::Float32);
 
     void Forward() override;
 
@@ -55,8 +72,46 @@ public:
 
     void ChangeBatchSize(std::size_t batchSize) override;
 
+    //! Refreshes bfloat16 copy of the weight
+    void SyncTrainableTensors() override;
+
+    [[nodiscard]] std::vector<std::string> BackwardScratchKeys() const override
+    {
+        return { "delta" };
+    }
+
+    //! Starts recording range of the input for quantization
+    //! Range is widened on every Forward until Quantize is called
+    void BeginCalibration();
+
+    //! Quantizes weight to int8 with scale per output column and input with
+    //! the range recorded since BeginCalibration
+    //! Forward runs on int8 GEMM afterwards. Only float units compiled for
+    //! inference can be quantized, since training would not update the
+    //! quantized weight
+    void Quantize();
+
+    [[nodiscard]] bool IsQuantized() const
+    {
+        return m_quantizedWeight != nullptr;
+    }
+
+    //! Tunes GEMM blocking of the products computed by Forward, and by
+    //! Backward unless the unit was compiled for inference
+    void TuneGemm();
+
 private:
     UnitId m_sourceUnitId;
+    Activation m_activation;
+
+    bool m_isCalibrating = false;
+    T m_inputMin = 0;
+    T m_inputMax = 0;
+    Compute::CPU::Int8::QuantizationRange m_inputRange;
+    std::unique_ptr<Compute::CPU::Int8::QuantizedMatrix> m_quantizedWeight;
+    //! Weight read by products if weights are stored in bfloat16
+    std::unique_ptr<Tensor<Compute::BFloat16>> m_bFloat16Weight;
+
     static void m_checkShape(const Shape& inputShape, const Shape& outputShape,
                              const Shape& weightShape, const Shape& biasShape,
                              const std::string& unitName);
@@ -27,11 +27,13 @@ public:
     //! \param labelUnitId : unitId for label
     //! \param predictionTensor : tensor connected to prediction input unit
     //! \param labelTensor : tensor connected to label input unit
-    //! \param backwardOutputTensor : tensor that outputs back propagation data
-    //! to prediction unit \param batchSize : batch Size
+    //! \param backwardOutputMap : tensor that outputs back propagation data
+    //! to prediction unit. Empty if the unit is only used for inference
+    //! \param batchSize : batch Size
     CrossEntropy(const UnitId& unitId, const UnitId& predictionUnitId,
                  const UnitId& labelUnitId, Tensor<T> predictionTensor,
-                 Tensor<T> labelTensor, Tensor<T> backwardOutputTensor,
+                 Tensor<T> labelTensor,
+                 std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
                  Tensor<T> outputTensor, Compute::Device device,
                  std::size_t batchSize);
     ~CrossEntropy() = default;
@@ -41,8 +43,11 @@ public:
     CrossEntropy<T>& operator=(const CrossEntropy<T>& lossUnit) = delete;
     CrossEntropy<T>& operator=(CrossEntropy<T>&& lossUnit) noexcept;
 
+    //! \param inferenceOnly : if true, back propagation output is not
+    //! allocated and the unit cannot execute Backward
     static CrossEntropy<T> CreateUnit(
-        const FrontEnd::UnitMetaData<T>& unitMetaData);
+        const FrontEnd::UnitMetaData<T>& unitMetaData,
+        bool inferenceOnly = false);
 
     void Forward() override;
 
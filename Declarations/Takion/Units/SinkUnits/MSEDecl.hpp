@@ -26,13 +26,14 @@ public:
     //! \param labelUnitId : unitId for label
     //! \param predictionTensor : tensor connected to prediction input unit
     //! \param labelTensor : tensor connected to label input unit
-    //! \param backwardOutputTensor : tensor that outputs back propagation data to prediction unit
+    //! \param backwardOutputMap : tensor that outputs back propagation data to
+    //! prediction unit. Empty if the unit is only used for inference
     //! \param batchSize : batch Size
     MSELoss(const UnitId& unitId, const UnitId& predictionUnitId,
             const UnitId& labelUnitId,
             Tensor<T> predictionTensor, Tensor<T> labelTensor,
+            std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
             Tensor<T> outputTensor,
-            Tensor<T> backwardOutputTensor,
             std::size_t batchSize);
     ~MSELoss() = default;
 
@@ -41,7 +42,10 @@ public:
     MSELoss<T>& operator=(const MSELoss<T>& lossUnit) = delete;
     MSELoss<T>& operator=(MSELoss<T>&& lossUnit) noexcept;
 
-    static MSELoss<T> CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData);
+    //! \param inferenceOnly : if true, back propagation output is not
+    //! allocated and the unit cannot execute Backward
+    static MSELoss<T> CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData,
+                                 bool inferenceOnly = false);
 
     void Forward() override;
 
@@ -0,0 +1,79 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_GRAPH_SOFTMAXCROSSENTROPY_DECL_HPP
+#define TAKION_GRAPH_SOFTMAXCROSSENTROPY_DECL_HPP
+
+#include <Takion/Units/ComputableUnit.hpp>
+#include <Takion/FrontEnd/UnitMetaData.hpp>
+
+namespace Takion::Graph
+{
+//! Loss unit which applies SoftMax to its prediction input and computes
+//! CrossEntropy against the label in single pass
+//! Forward output is the SoftMax probability, and back propagation writes
+//! label - sum(label) * probability directly, so the Jacobian of SoftMax is
+//! never built
+template <typename T>
+class SoftMaxCrossEntropy : public ComputableUnit<T>
+{
+public:
+    using ComputableUnit<T>::BackwardInputMap;
+    using ComputableUnit<T>::BackwardOutputMap;
+    using ComputableUnit<T>::ForwardInputMap;
+    using ComputableUnit<T>::ForwardOutput;
+    using ComputableUnit<T>::m_loss;
+
+    //! \param unitId : subject UnitId
+    //! \param predictionUnitId : unitId for prediction (logits before SoftMax)
+    //! \param labelUnitId : unitId for label
+    //! \param predictionTensor : tensor connected to prediction input unit
+    //! \param labelTensor : tensor connected to label input unit
+    //! \param backwardOutputMap : tensor that outputs back propagation data
+    //! to prediction unit. Empty if the unit is only used for inference
+    //! \param outputTensor : SoftMax probability of the prediction
+    //! \param batchSize : batch Size
+    SoftMaxCrossEntropy(const UnitId& unitId, const UnitId& predictionUnitId,
+                        const UnitId& labelUnitId, Tensor<T> predictionTensor,
+                        Tensor<T> labelTensor,
+                        std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
+                        Tensor<T> outputTensor, Compute::Device device,
+                        std::size_t batchSize);
+    ~SoftMaxCrossEntropy() = default;
+
+    SoftMaxCrossEntropy(const SoftMaxCrossEntropy<T>& lossUnit) = delete;
+    SoftMaxCrossEntropy(SoftMaxCrossEntropy<T>&& lossUnit) noexcept;
+    SoftMaxCrossEntropy<T>& operator=(
+        const SoftMaxCrossEntropy<T>& lossUnit) = delete;
+    SoftMaxCrossEntropy<T>& operator=(
+        SoftMaxCrossEntropy<T>&& lossUnit) noexcept;
+
+    //! \param inferenceOnly : if true, back propagation output is not
+    //! allocated and the unit cannot execute Backward
+    static SoftMaxCrossEntropy<T> CreateUnit(
+        const FrontEnd::UnitMetaData<T>& unitMetaData,
+        bool inferenceOnly = false);
+
+    void Forward() override;
+
+    void AsyncForward(std::promise<bool> promise) override;
+
+    void Backward() override;
+
+    void AsyncBackward(std::promise<bool> promise) override;
+
+private:
+    static void m_checkArguments(const Shape& predictionShape,
+                                 const Shape& labelShape,
+                                 const std::string& unitName);
+
+    UnitId m_predictionUnitId;
+    UnitId m_labelUnitId;
+    Compute::Device m_device;
+};
+}
+
+#endif
@@ -11,7 +11,9 @@
 #include <Takion/Computations/Initializers/InitializerType.hpp>
 #include <Takion/FrontEnd/UnitMetaData.hpp>
 #include <Takion/Utils/Loaders/Loader.hpp>
+#include <deque>
 #include <functional>
+#include <future>
 
 namespace Takion::Graph
 {
@@ -35,7 +37,8 @@ public:
 
     PlaceHolder(PlaceHolder&& placeHolder) noexcept
         : ComputableUnit<T>(std::move(placeHolder)),
-          m_loader(std::move(placeHolder.m_loader))
+          m_loader(std::move(placeHolder.m_loader)),
+          m_prefetchQueue(std::move(placeHolder.m_prefetchQueue))
     {
     }
 
@@ -45,6 +48,7 @@ public:
     {
         ComputableUnit<T>::operator=(std::move(placeHolder));
         m_loader = std::move(placeHolder.m_loader);
+        m_prefetchQueue = std::move(placeHolder.m_prefetchQueue);
         return *this;
     }
 
@@ -56,18 +60,38 @@ public:
 
     void AsyncBackward(std::promise<bool> promise) override;
 
+    //! Starts loading data of following cycles in the background so loading
+    //! overlaps with computation of the current cycle
+    //! Forward consumes prefetched data in order before calling the loader
+    //! \param depth : maximum number of cycles which can be loaded in advance
+    void Prefetch(std::size_t depth);
+
+    //! Waits for every prefetch in flight and discards loaded data
+    void DiscardPrefetch();
+
     void SetLoader(std::function<std::vector<T>()> loader)
     {
+        DiscardPrefetch();
         m_loader = std::move(loader);
     }
 
+    //! Prefetched data is discarded since loader can be modified by caller
     std::unique_ptr<Util::Loader<T>>& GetLoader()
     {
+        DiscardPrefetch();
         return m_loader;
     }
 
 private:
+    //! Returns data of next cycle from the prefetch queue, or from the loader
+    //! if nothing was prefetched
+    std::vector<T> m_load();
+
+    void m_initialize(std::vector<T> vector);
+
     std::unique_ptr<Util::Loader<T>> m_loader;
+    //! Declared after m_loader so pending loads finish before it is destroyed
+    std::deque<std::shared_future<std::vector<T>>> m_prefetchQueue;
 };
 }
 #endif
@@ -14,13 +14,18 @@
 
 namespace Takion::Graph
 {
+//! Unit with tensors updated by the optimizer
+//! Backward writes gradient of each trainable tensor, and the engine applies
+//! the optimizer to every trainable unit at once (see
+//! Engine::UnitManager::ParameterSlab)
 template <typename T>
 class TrainableUnit
 
 {
 public:
-    TrainableUnit(std::unordered_map<std::string, Tensor<T>> trainableTensorMap,
-                  std::unique_ptr<Compute::Optimizer<T>> optimizer);
+    TrainableUnit(
+        std::unordered_map<std::string, Tensor<T>> trainableTensorMap,
+        std::unordered_map<std::string, Tensor<T>> gradientTensorMap);
 
     TrainableUnit(
         std::unordered_map<std::string, Tensor<T>> trainableTensorMap);
@@ -31,17 +36,29 @@ public:
 
     TrainableUnit(TrainableUnit<T>&& trainableUnit) noexcept
         : TrainableTensorMap(std::move(trainableUnit.TrainableTensorMap)),
-          m_optimizer(std::move(trainableUnit.m_optimizer))
+          GradientTensorMap(std::move(trainableUnit.GradientTensorMap)),
+          OptimizerStateMap(std::move(trainableUnit.OptimizerStateMap))
     {
     }
 
     TrainableUnit<T>& operator=(const TrainableUnit<T>& trainableUnit) = delete;
     TrainableUnit<T>& operator=(TrainableUnit<T>&& trainableUnit) noexcept;
 
-    std::unordered_map<std::string, Tensor<T>> TrainableTensorMap;
+    //! Called after the optimizer updated TrainableTensorMap
+    //! Units keeping other copies of their trainable tensors refresh them
+    virtual void SyncTrainableTensors()
+    {
+    }
 
-protected:
-    std::unique_ptr<Compute::Optimizer<T>> m_optimizer = nullptr;
+    std::unordered_map<std::string, Tensor<T>> TrainableTensorMap;
+    //! Update of each TrainableTensorMap entry written by Backward, averaged
+    //! over the batch (descent direction, negative gradient)
+    //! Empty if the unit was compiled for inference
+    std::unordered_map<std::string, Tensor<T>> GradientTensorMap;
+    //! State of the optimizer for each entry of TrainableTensorMap
+    //! Moments are views of the optimizer state of the engine
+    std::unordered_map<std::string, Compute::OptimizerState<T>>
+    OptimizerStateMap;
 };
 }
 
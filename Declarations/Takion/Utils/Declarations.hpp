@@ -35,6 +35,15 @@ enum class Activation
     Linear,
 };
 
+//! Selects which operands of matrix product are transposed
+//! NN : A * B, NT : A * B^T, TN : A^T * B
+enum class TransposeOp
+{
+    NN,
+    NT,
+    TN,
+};
+
 enum class Padding
 {
     Zeros,
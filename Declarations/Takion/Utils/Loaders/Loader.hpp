@@ -22,6 +22,8 @@ public:
     {
     }
 
+    virtual ~Loader() = default;
+
     void SetData(std::vector<T> vector)
     {
         m_data = std::move(vector);
@@ -33,8 +33,16 @@ public:
 
     [[nodiscard]] int GetIntegerParam(const std::string& name) const;
 
+    //! Returns defaultValue if the parameter was not given
+    [[nodiscard]] int GetIntegerParam(const std::string& name,
+                                      int defaultValue) const;
+
     [[nodiscard]] float GetFloatingPointParam(const std::string& name) const;
 
+    //! Returns defaultValue if the parameter was not given
+    [[nodiscard]] float GetFloatingPointParam(const std::string& name,
+                                              float defaultValue) const;
+
     [[nodiscard]] std::string GetStringParam(const std::string& name) const;
 
 private:
@@ -109,12 +109,15 @@ SharedPtr<T>& SharedPtr<T>::operator=(const SharedPtr<U>& sharedPtr)
     if (this == &sharedPtr)
         return *this;
 
-    int oldRefCount = sharedPtr.m_sharedObjectInfoPtr->RefCount.load(
-        std::memory_order_relaxed);
-    while (!sharedPtr.m_sharedObjectInfoPtr->RefCount.compare_exchange_weak(
-        oldRefCount, oldRefCount + 1,
-        std::memory_order_release,
-        std::memory_order_relaxed));
+    if (sharedPtr.m_sharedObjectInfoPtr)
+    {
+        int oldRefCount = sharedPtr.m_sharedObjectInfoPtr->RefCount.load(
+            std::memory_order_relaxed);
+        while (!sharedPtr.m_sharedObjectInfoPtr->RefCount.compare_exchange_weak(
+            oldRefCount, oldRefCount + 1,
+            std::memory_order_release,
+            std::memory_order_relaxed));
+    }
 
     m_delete();
     m_objectPtr = sharedPtr.m_objectPtr;
@@ -129,12 +132,15 @@ SharedPtr<T>& SharedPtr<T>::operator=(const SharedPtr<T>& sharedPtr)
     if (this == &sharedPtr)
         return *this;
 
-    int oldRefCount = sharedPtr.m_sharedObjectInfoPtr->RefCount.load(
-        std::memory_order_relaxed);
-    while (!sharedPtr.m_sharedObjectInfoPtr->RefCount.compare_exchange_weak(
-        oldRefCount, oldRefCount + 1,
-        std::memory_order_release,
-        std::memory_order_relaxed));
+    if (sharedPtr.m_sharedObjectInfoPtr)
+    {
+        int oldRefCount = sharedPtr.m_sharedObjectInfoPtr->RefCount.load(
+            std::memory_order_relaxed);
+        while (!sharedPtr.m_sharedObjectInfoPtr->RefCount.compare_exchange_weak(
+            oldRefCount, oldRefCount + 1,
+            std::memory_order_release,
+            std::memory_order_relaxed));
+    }
 
     m_delete();
     m_objectPtr = sharedPtr.m_objectPtr;
@@ -8,6 +8,8 @@
 #define TAKION_GRAPH_UNITMANAGER_HPP
 
 #include <Takion/Engine/UnitManagerDecl.hpp>
+#include <Takion/Computations/GEMM/GemmTuner.hpp>
+#include <Takion/Units/HiddenUnits/Conv2D.hpp>
 #include <Takion/Units/HiddenUnits/Dense.hpp>
 #include <Takion/Units/SourceUnits/ConstantUnit.hpp>
 #include <Takion/Units/SourceUnits/PlaceHolder.hpp>
@@ -16,6 +18,10 @@
 #include <Takion/Units/HiddenUnits/Activations/SoftMax.hpp>
 #include <Takion/Units/SinkUnits/MSE.hpp>
 #include <Takion/Units/SinkUnits/CrossEntropy.hpp>
+#include <Takion/Units/SinkUnits/SoftMaxCrossEntropy.hpp>
+#include <omp.h>
+#include <algorithm>
+#include <set>
 
 
 namespace Takion::Engine
@@ -24,6 +30,30 @@ template <typename T>
 UnitManager<T>::UnitManager(UnitManager<T>&& unitManager) noexcept
     : m_unitMetaDataMap(std::move(unitManager.m_unitMetaDataMap)),
       m_unitMap(std::move(unitManager.m_unitMap)),
+      m_fusedActivationMap(std::move(unitManager.m_fusedActivationMap)),
+      m_fusedUnitMap(std::move(unitManager.m_fusedUnitMap)),
+      m_fusedMetaDataMap(std::move(unitManager.m_fusedMetaDataMap)),
+      m_keptOutputSet(std::move(unitManager.m_keptOutputSet)),
+      m_forwardPlan(std::move(unitManager.m_forwardPlan)),
+      m_backwardPlan(std::move(unitManager.m_backwardPlan)),
+      m_executor(std::move(unitManager.m_executor)),
+      m_arena(std::move(unitManager.m_arena)),
+      m_optimizer(std::move(unitManager.m_optimizer)),
+      m_parameterSlab(std::move(unitManager.m_parameterSlab)),
+      m_gradientSlab(std::move(unitManager.m_gradientSlab)),
+      m_microBatchGradientSlab(
+          std::move(unitManager.m_microBatchGradientSlab)),
+      m_momentSlabVector(std::move(unitManager.m_momentSlabVector)),
+      m_segmentDeque(std::move(unitManager.m_segmentDeque)),
+      m_segmentMap(std::move(unitManager.m_segmentMap)),
+      m_updateQueue(std::move(unitManager.m_updateQueue)),
+      m_isInference(unitManager.m_isInference),
+      m_isMemorySharingEnabled(unitManager.m_isMemorySharingEnabled),
+      m_storageType(unitManager.m_storageType),
+      m_gemmTuningCachePath(std::move(unitManager.m_gemmTuningCachePath)),
+      m_plannedTensorByteSize(unitManager.m_plannedTensorByteSize),
+      m_numMicroBatches(unitManager.m_numMicroBatches),
+      m_microBatchIdx(unitManager.m_microBatchIdx),
       m_batchSize(unitManager.m_batchSize)
 {
 }
@@ -31,8 +61,33 @@ UnitManager<T>::UnitManager(UnitManager<T>&& unitManager) noexcept
 template <typename T>
 UnitManager<T>& UnitManager<T>::operator=(UnitManager<T>&& unitManager) noexcept
 {
+    //! Previous queue finishes pending updates before the members they
+    //! refer to are replaced
+    m_updateQueue = std::move(unitManager.m_updateQueue);
     m_unitMetaDataMap = std::move(unitManager.m_unitMetaDataMap);
     m_unitMap = std::move(unitManager.m_unitMap);
+    m_fusedActivationMap = std::move(unitManager.m_fusedActivationMap);
+    m_fusedUnitMap = std::move(unitManager.m_fusedUnitMap);
+    m_fusedMetaDataMap = std::move(unitManager.m_fusedMetaDataMap);
+    m_keptOutputSet = std::move(unitManager.m_keptOutputSet);
+    m_forwardPlan = std::move(unitManager.m_forwardPlan);
+    m_backwardPlan = std::move(unitManager.m_backwardPlan);
+    m_executor = std::move(unitManager.m_executor);
+    m_arena = std::move(unitManager.m_arena);
+    m_optimizer = std::move(unitManager.m_optimizer);
+    m_parameterSlab = std::move(unitManager.m_parameterSlab);
+    m_gradientSlab = std::move(unitManager.m_gradientSlab);
+    m_microBatchGradientSlab = std::move(unitManager.m_microBatchGradientSlab);
+    m_momentSlabVector = std::move(unitManager.m_momentSlabVector);
+    m_segmentDeque = std::move(unitManager.m_segmentDeque);
+    m_segmentMap = std::move(unitManager.m_segmentMap);
+    m_isInference = unitManager.m_isInference;
+    m_isMemorySharingEnabled = unitManager.m_isMemorySharingEnabled;
+    m_storageType = unitManager.m_storageType;
+    m_gemmTuningCachePath = std::move(unitManager.m_gemmTuningCachePath);
+    m_plannedTensorByteSize = unitManager.m_plannedTensorByteSize;
+    m_numMicroBatches = unitManager.m_numMicroBatches;
+    m_microBatchIdx = unitManager.m_microBatchIdx;
     return *this;
 }
 
@@ -67,21 +122,118 @@ template <typename T>
 void UnitManager<T>::Compile(const std::string& optimizerName,
                              const Parameter& parameter)
 {
+    m_isInference = false;
+    m_compile(optimizerName, parameter);
+}
+
+template <typename T>
+void UnitManager<T>::CompileForInference()
+{
+    m_isInference = true;
+    m_compile("", Parameter());
+}
+
+template <typename T>
+void UnitManager<T>::CompileForQuantizedInference(
+    std::size_t numCalibrationBatches)
+{
+    if constexpr (!std::is_same_v<T, float>)
+        throw std::runtime_error("Only float models can be quantized");
+
+    if (numCalibrationBatches == 0)
+        throw std::invalid_argument(
+            "At least one batch is required for calibration");
+
+    CompileForInference();
+
+    std::vector<Graph::DenseUnit<T>*> denseUnitVector;
+    for (const auto& [unitId, unitPtr] : m_unitMap)
+        if (unitId.Type.Name() == "Dense")
+            denseUnitVector.emplace_back(
+                dynamic_cast<Graph::DenseUnit<T>*>(unitPtr.get()));
+
+    for (auto* denseUnit : denseUnitVector)
+        denseUnit->BeginCalibration();
+
+    for (std::size_t batchIdx = 0; batchIdx < numCalibrationBatches;
+         ++batchIdx)
+    {
+        Forward();
+        ResetState();
+    }
+
+    for (auto* denseUnit : denseUnitVector)
+        denseUnit->Quantize();
+}
+
+template <typename T>
+void UnitManager<T>::m_compile(const std::string& optimizerName,
+                               const Parameter& parameter)
+{
+    WaitForParameterUpdates();
+    m_restoreFusedUnits();
+    m_fuseActivations();
+    m_fuseSoftMaxCrossEntropy();
+
+    m_optimizer = m_isInference ? nullptr
+                                : m_makeOptimizer(optimizerName, parameter);
+
     for (const auto& [key, unitMetaData] : m_unitMetaDataMap)
     {
         if (m_appendSource(unitMetaData))
             continue;
-        if (m_appendHidden(unitMetaData, optimizerName, parameter))
+        if (m_appendHidden(unitMetaData))
             continue;
         if (m_appendLoss(unitMetaData))
             continue;
         throw std::runtime_error("No matching unit type");
     }
+
+    m_buildExecutionPlan();
+    m_planMemory();
+    m_shareTensorData();
+    m_placeParameters();
+
+    //! Queue is created here on the calling thread, since workers of the
+    //! pool only see their share of the threads and would race to create it
+    //! Nothing can overlap with the updates on a single thread, so they run
+    //! inline without a queue
+    m_updateQueue.reset();
+    const auto numThreads = omp_get_max_threads();
+    if (!m_isInference && numThreads > 1)
+    {
+        //! Updates are bound by memory bandwidth and run next to back
+        //! propagation of the units before them, so they only take a share
+        //! of the threads
+        m_updateQueue = std::make_unique<TaskQueue>(
+            static_cast<std::size_t>(std::max(numThreads / 4, 1)));
+    }
+
+    if (!m_gemmTuningCachePath.empty())
+        m_tuneGemm();
+}
+
+template <typename T>
+void UnitManager<T>::m_tuneGemm()
+{
+    //! Only float GEMM has tunable blocking
+    if constexpr (std::is_same_v<T, float>)
+    {
+        Compute::CPU::Float::LoadGemmTuningCache(m_gemmTuningCachePath);
+
+        for (const auto& [unitId, unitPtr] : m_unitMap)
+            if (unitId.Type.Name() == "Dense")
+                dynamic_cast<Graph::DenseUnit<T>*>(unitPtr.get())->TuneGemm();
+
+        Compute::CPU::Float::SaveGemmTuningCache(m_gemmTuningCachePath);
+    }
 }
 
 template <typename T>
 void UnitManager<T>::Forward()
 {
+    WaitForParameterUpdates();
+
     for (const auto& [key, unitPtr] : m_unitMap)
         if (key.Type.BaseType == UnitBaseType::Fetcher ||
             key.Type.BaseType == UnitBaseType::Constant)
@@ -90,100 +242,90 @@ void UnitManager<T>::Forward()
                 tensor.State.fetch_add(1);
         }
 
-    bool done = false;
-    while (!done)
-    {
-        done = true;
-        for (const auto& [key, unitPtr] : m_unitMap)
-        {
-            if (unitPtr->IsForwardReady(0))
-            {
-                unitPtr->Forward();
-                unitPtr->UpdateForwardState();
-                done = false;
-            }
-            if (m_isForwardCopyReady(key))
-            {
-                m_forwardCopy(key);
-                done = false;
-            }
-        }
-    }
+    for (auto& step : m_forwardPlan.StepVector)
+        m_executeStep(step, true);
 }
 
 template <typename T>
 void UnitManager<T>::Backward()
 {
+    if (m_isInference)
+        throw std::runtime_error(
+            "Back propagation is not available on units compiled for "
+            "inference");
+
     for (const auto& [key, unitPtr] : m_unitMap)
         if (key.Type.BaseType == UnitBaseType::Loss)
             for (auto& [unitId, tensor] : unitPtr->BackwardInputMap)
                 tensor.State.fetch_add(1);
 
-    bool done = false;
-    while (!done)
-    {
-        done = true;
-        for (const auto& [key, unitPtr] : m_unitMap)
-        {
-            if (unitPtr->IsBackwardReady(0))
-            {
-                unitPtr->Backward();
-                unitPtr->UpdateBackwardState();
-                done = false;
-            }
-            if (m_isBackwardCopyReady(key))
-            {
-                m_backwardCopy(key);
-                done = false;
-            }
-        }
-    }
+    for (auto& step : m_backwardPlan.StepVector)
+        m_executeStep(step, false);
+
+    m_microBatchIdx = (m_microBatchIdx + 1) % m_numMicroBatches;
+}
+
+template <typename T>
+void UnitManager<T>::Prefetch(std::size_t depth)
+{
+    for (const auto& [key, unitPtr] : m_unitMap)
+        if (key.Type.BaseType == UnitBaseType::Fetcher)
+            dynamic_cast<Graph::PlaceHolder<T>*>(unitPtr.get())->Prefetch(
+                depth);
 }
 
 template <typename T>
 void UnitManager<T>::AsyncForward(std::size_t cycle)
 {
-    std::unordered_map<UnitId, std::future<bool>> futureVector;
-    futureVector.reserve(10);
+    WaitForParameterUpdates();
 
     for (const auto& [key, unitPtr] : m_unitMap)
-    {
-        if (unitPtr->IsForwardReady(cycle))
+        if (key.Type.BaseType == UnitBaseType::Fetcher ||
+            key.Type.BaseType == UnitBaseType::Constant)
         {
-            std::promise<bool> promise;
-            futureVector[key] = promise.get_future();
-            unitPtr->AsyncForward(std::move(promise));
+            for (auto& [unitId, tensor] : unitPtr->ForwardInputMap)
+                tensor.State.fetch_add(1);
         }
-    }
 
-    for (auto& [key, future] : futureVector)
-    {
-        future.wait();
-        m_forwardCopy(key);
-    }
+    auto& stepVector = m_forwardPlan.StepVector;
+    const auto task = [this, &stepVector, cycle](std::size_t stepIdx) {
+        auto& step = stepVector[stepIdx];
+        if (!step.Unit->IsForwardReady(cycle))
+            throw std::runtime_error("Unit " + step.Unit->Id().UnitName +
+                                     " is not ready for forward propagation");
+        m_executeStep(step, true);
+    };
+
+    m_getExecutor().Run(task, m_forwardPlan.SuccessorVector,
+                        m_forwardPlan.NumDependencyVector);
 }
 
 template <typename T>
 void UnitManager<T>::AsyncBackward(std::size_t cycle)
 {
-    std::unordered_map<UnitId, std::future<bool>> futureVector;
-    futureVector.reserve(10);
+    if (m_isInference)
+        throw std::runtime_error(
+            "Back propagation is not available on units compiled for "
+            "inference");
 
     for (const auto& [key, unitPtr] : m_unitMap)
-    {
-        if (unitPtr->IsBackwardReady(cycle))
-        {
-            std::promise<bool> promise;
-            futureVector[key] = promise.get_future();
-            unitPtr->AsyncBackward(std::move(promise));
-        }
-    }
+        if (key.Type.BaseType == UnitBaseType::Loss)
+            for (auto& [unitId, tensor] : unitPtr->BackwardInputMap)
+                tensor.State.fetch_add(1);
 
-    for (auto& [key, future] : futureVector)
-    {
-        future.wait();
-        m_backwardCopy(key);
-    }
+    auto& stepVector = m_backwardPlan.StepVector;
+    const auto task = [this, &stepVector, cycle](std::size_t stepIdx) {
+        auto& step = stepVector[stepIdx];
+        if (!step.Unit->IsBackwardReady(cycle))
+            throw std::runtime_error("Unit " + step.Unit->Id().UnitName +
+                                     " is not ready for back propagation");
+        m_executeStep(step, false);
+    };
+
+    m_getExecutor().Run(task, m_backwardPlan.SuccessorVector,
+                        m_backwardPlan.NumDependencyVector);
+
+    m_microBatchIdx = (m_microBatchIdx + 1) % m_numMicroBatches;
 }
 
 template <typename T>
@@ -199,128 +341,808 @@ void UnitManager<T>::ChangeBatchSize(std::size_t batchSize)
     for (const auto& [key, unitPtr] : m_unitMap)
         unitPtr->ChangeBatchSize(batchSize);
 
+    m_planMemory();
+    m_shareTensorData();
     m_batchSize = batchSize;
 }
 
 
+template <typename T>
+Tensor<T>& UnitManager<T>::ParameterSlab()
+{
+    if (!m_parameterSlab)
+        throw std::runtime_error("Model has no compiled trainable tensor");
+    WaitForParameterUpdates();
+    return *m_parameterSlab;
+}
+
+template <typename T>
+Tensor<T>& UnitManager<T>::GradientSlab()
+{
+    if (!m_gradientSlab)
+        throw std::runtime_error(
+            "Gradients are only available on models compiled for training");
+    WaitForParameterUpdates();
+    return *m_gradientSlab;
+}
+
 template <typename T>
 const Tensor<T>& UnitManager<T>::GetOutput(UnitId unitId) const
 {
-    return m_unitMap.at(unitId)->ForwardOutput;
+    if (m_fusedActivationMap.find(unitId) != m_fusedActivationMap.end())
+        throw std::invalid_argument(
+            "Output of the unit is fused with its activation. Call KeepOutput "
+            "before compilation to observe it");
+    return m_unitMap.at(m_resolveUnitId(unitId))->ForwardOutput;
 }
 
 template <typename T>
 std::unique_ptr<Graph::ComputableUnit<T>>& UnitManager<T>::GetUnit(
     const UnitId& unitId)
 {
-    return m_unitMap[unitId];
+    WaitForParameterUpdates();
+    return m_unitMap[m_resolveUnitId(unitId)];
 }
 
 template <typename T>
-bool UnitManager<T>::m_isForwardCopyReady(const UnitId& subjectUnitId) const
+void UnitManager<T>::m_buildExecutionPlan()
 {
-    const auto& sourceMetaData = m_unitMetaDataMap.at(subjectUnitId);
-    if (sourceMetaData.Id().Type.BaseType == UnitBaseType::Loss)
-        return false;
+    //! Kahn's algorithm over input connections of the units
+    //! Ready units are visited in order of their ids, so the plan is
+    //! deterministic and follows the order units were added to the model
+    std::unordered_map<UnitId, std::size_t> numRemainingInputs;
+    std::set<UnitId> readySet;
+    for (const auto& [unitId, unitMetaData] : m_unitMetaDataMap)
+    {
+        numRemainingInputs[unitId] = unitMetaData.InputUnitMap().size();
+        if (unitMetaData.InputUnitMap().empty())
+            readySet.insert(unitId);
+    }
+
+    std::vector<UnitId> sortedUnitIdVector;
+    sortedUnitIdVector.reserve(m_unitMetaDataMap.size());
+    while (!readySet.empty())
+    {
+        const auto unitId = *readySet.begin();
+        readySet.erase(readySet.begin());
+        sortedUnitIdVector.emplace_back(unitId);
+
+        for (const auto& outputUnitId :
+             m_unitMetaDataMap.at(unitId).OutputUnitVector())
+        {
+            if (--numRemainingInputs.at(outputUnitId) == 0)
+                readySet.insert(outputUnitId);
+        }
+    }
 
-    const auto& subjectOutputTensor =
-        m_unitMap.at(subjectUnitId)->ForwardOutput;
+    if (sortedUnitIdVector.size() != m_unitMetaDataMap.size())
+        throw std::runtime_error("Graph contains cycle");
 
-    for (const auto& outputUnitId : sourceMetaData.OutputUnitVector())
+    m_forwardPlan = ExecutionPlan();
+    std::unordered_map<UnitId, std::size_t> forwardStepIdxMap;
+    for (const auto& unitId : sortedUnitIdVector)
     {
-        const auto& nextInputTensorMap =
-            m_unitMap.at(outputUnitId)->ForwardInputMap;
-        for (const auto& [targetUnitId, destTensor] : nextInputTensorMap)
+        forwardStepIdxMap[unitId] = m_forwardPlan.StepVector.size();
+        ExecutionStep step;
+        step.Unit = m_unitMap.at(unitId).get();
+
+        if (unitId.Type.BaseType != UnitBaseType::Loss)
         {
-            if (targetUnitId == subjectUnitId)
+            for (const auto& outputUnitId :
+                 m_unitMetaDataMap.at(unitId).OutputUnitVector())
             {
-                if (subjectOutputTensor.State != destTensor.State + 1)
-                    return false;
+                auto& destination =
+                    m_unitMap.at(outputUnitId)->ForwardInputMap.at(unitId);
+                step.AddEdge(&step.Unit->ForwardOutput, &destination);
             }
         }
+        m_forwardPlan.StepVector.emplace_back(std::move(step));
+    }
+
+    for (const auto& unitId : sortedUnitIdVector)
+    {
+        std::vector<std::size_t> dependencyVector;
+        for (const auto& [key, inputUnitId] :
+             m_unitMetaDataMap.at(unitId).InputUnitMap())
+            dependencyVector.emplace_back(forwardStepIdxMap.at(inputUnitId));
+        m_forwardPlan.AddStepDependency(forwardStepIdxMap.at(unitId),
+                                        dependencyVector);
+    }
+
+    //! Backward runs in reverse topological order and only contains units
+    //! which produce gradients. Gradients are not copied to units which
+    //! never propagate them (sources)
+    m_backwardPlan = ExecutionPlan();
+    std::unordered_map<UnitId, std::size_t> backwardStepIdxMap;
+    for (auto itr = sortedUnitIdVector.rbegin();
+         itr != sortedUnitIdVector.rend(); ++itr)
+    {
+        const auto& unitId = *itr;
+        auto* unit = m_unitMap.at(unitId).get();
+        if (unit->BackwardOutputMap.empty())
+            continue;
+
+        backwardStepIdxMap[unitId] = m_backwardPlan.StepVector.size();
+        ExecutionStep step;
+        step.Unit = unit;
+        for (const auto& [previousUnitId, gradient] : unit->BackwardOutputMap)
+        {
+            auto& previousUnit = m_unitMap.at(previousUnitId);
+            if (previousUnit->BackwardOutputMap.empty())
+                continue;
+            step.AddEdge(&gradient, &previousUnit->BackwardInputMap.at(unitId));
+        }
+        m_backwardPlan.StepVector.emplace_back(std::move(step));
+    }
+
+    for (const auto& [unitId, stepIdx] : backwardStepIdxMap)
+    {
+        std::vector<std::size_t> dependencyVector;
+        for (const auto& [nextUnitId, gradient] :
+             m_unitMap.at(unitId)->BackwardInputMap)
+        {
+            const auto itr = backwardStepIdxMap.find(nextUnitId);
+            if (itr != backwardStepIdxMap.end())
+                dependencyVector.emplace_back(itr->second);
+        }
+        m_backwardPlan.AddStepDependency(stepIdx, dependencyVector);
+    }
+}
+
+template <typename T>
+void UnitManager<T>::ExecutionStep::AddEdge(const Tensor<T>* source,
+                                            Tensor<T>* destination)
+{
+    auto& edgeVector =
+        source->Device == destination->Device ? ShareVector : CopyVector;
+    //! Units may consume same output more than once
+    const std::pair<const Tensor<T>*, Tensor<T>*> edge = { source,
+                                                           destination };
+    if (std::find(edgeVector.begin(), edgeVector.end(), edge) ==
+        edgeVector.end())
+        edgeVector.emplace_back(edge);
+}
+
+template <typename T>
+void UnitManager<T>::m_shareTensorData()
+{
+    //! Producer writes its output once per cycle, and consumers only read
+    //! their inputs. Sharing is safe since consumers of cycle n finish
+    //! before the producer runs for cycle n + 1
+    for (auto* plan : { &m_forwardPlan, &m_backwardPlan })
+        for (auto& step : plan->StepVector)
+            for (auto& [source, destination] : step.ShareVector)
+                Tensor<T>::ShareTensorData(*source, *destination);
+}
+
+template <typename T>
+void UnitManager<T>::ExecutionPlan::AddStepDependency(
+    std::size_t stepIdx, std::vector<std::size_t> dependencyVector)
+{
+    std::sort(dependencyVector.begin(), dependencyVector.end());
+    dependencyVector.erase(
+        std::unique(dependencyVector.begin(), dependencyVector.end()),
+        dependencyVector.end());
+
+    if (SuccessorVector.size() < StepVector.size())
+        SuccessorVector.resize(StepVector.size());
+    if (NumDependencyVector.size() < StepVector.size())
+        NumDependencyVector.resize(StepVector.size(), 0);
+
+    NumDependencyVector[stepIdx] = dependencyVector.size();
+    for (const auto dependencyIdx : dependencyVector)
+        SuccessorVector[dependencyIdx].emplace_back(stepIdx);
+}
+
+template <typename T>
+std::size_t UnitManager<T>::ExecutionPlan::MaxWidth() const
+{
+    //! Steps are grouped by their depth in the dependency graph
+    std::vector<std::size_t> levelVector(StepVector.size(), 0);
+    std::vector<std::size_t> widthVector(StepVector.size() + 1, 0);
+    std::size_t maxWidth = 0;
+    for (std::size_t stepIdx = 0; stepIdx < StepVector.size(); ++stepIdx)
+    {
+        const auto level = levelVector[stepIdx];
+        maxWidth = std::max(maxWidth, ++widthVector[level]);
+        for (const auto successorIdx : SuccessorVector[stepIdx])
+            levelVector[successorIdx] =
+                std::max(levelVector[successorIdx], level + 1);
+    }
+    return maxWidth;
+}
+
+template <typename T>
+std::vector<std::pair<UnitId, std::size_t>>
+UnitManager<T>::ExecutionPlan::Schedule() const
+{
+    std::vector<std::pair<UnitId, std::size_t>> schedule;
+    schedule.reserve(StepVector.size());
+    for (std::size_t stepIdx = 0; stepIdx < StepVector.size(); ++stepIdx)
+        schedule.emplace_back(StepVector[stepIdx].Unit->Id(),
+                              NumDependencyVector[stepIdx]);
+    return schedule;
+}
+
+template <typename T>
+void UnitManager<T>::m_executeStep(ExecutionStep& step, bool isForward)
+{
+    if (isForward)
+    {
+        step.Unit->Forward();
+        step.Unit->UpdateForwardState();
+    }
+    else
+    {
+        step.Unit->Backward();
+        step.Unit->UpdateBackwardState();
     }
-    return true;
+
+    for (auto& [source, destination] : step.CopyVector)
+    {
+        Tensor<T>::CopyTensorData(*source, *destination);
+        destination->State.fetch_add(1);
+    }
+
+    for (auto& [source, destination] : step.ShareVector)
+        destination->State.fetch_add(1);
+
+    if (!isForward)
+        m_enqueueUpdate(step.Unit);
 }
 
 template <typename T>
-bool UnitManager<T>::m_isBackwardCopyReady(const UnitId& subjectUnitId) const
+void UnitManager<T>::m_planMemory()
 {
-    const auto& sourceMetaData = m_unitMetaDataMap.at(subjectUnitId);
-    if (sourceMetaData.Id().Type.BaseType == UnitBaseType::Fetcher)
-        return false;
+    //! Tensor placed in the arena with indices of backward steps accessing it
+    //! Tensors without steps are live during the whole cycle
+    struct Allocation
+    {
+        Tensor<T>* TensorPtr = nullptr;
+        std::vector<std::size_t> StepVector;
+        std::size_t Size = 0;
+        std::size_t Offset = 0;
+    };
+
+    const auto& backwardStepVector = m_backwardPlan.StepVector;
+    const auto numSteps = backwardStepVector.size();
+    std::unordered_map<const Graph::ComputableUnit<T>*, std::size_t>
+        backwardStepIdxMap;
+    for (std::size_t stepIdx = 0; stepIdx < numSteps; ++stepIdx)
+        backwardStepIdxMap[backwardStepVector[stepIdx].Unit] = stepIdx;
+
+    //! Successors of each step always come later in the plan, so the
+    //! transitive closure is built in a single reverse pass
+    std::vector<std::vector<bool>> isReachable(
+        numSteps, std::vector<bool>(numSteps, false));
+    for (auto stepIdx = numSteps; stepIdx-- > 0;)
+        for (const auto successorIdx : m_backwardPlan.SuccessorVector[stepIdx])
+        {
+            isReachable[stepIdx][successorIdx] = true;
+            for (std::size_t idx = 0; idx < numSteps; ++idx)
+                if (isReachable[successorIdx][idx])
+                    isReachable[stepIdx][idx] = true;
+        }
 
-    bool hasValidBackwardUnit = false;
-    for (const auto& [unitId, outputTensor] :
-         m_unitMap.at(subjectUnitId)->BackwardOutputMap)
+    std::vector<Allocation> allocationVector;
+    for (const auto& step : m_forwardPlan.StepVector)
     {
-        const auto& nextBackwardInputTensorMap =
-            m_unitMap.at(unitId)->BackwardInputMap;
+        auto* unit = step.Unit;
+        const auto baseType = unit->Id().Type.BaseType;
+        //! Outputs of sources are written outside of the cycle
+        if (baseType == UnitBaseType::Fetcher ||
+            baseType == UnitBaseType::Constant)
+            continue;
 
-        for (const auto& [targetUnitId, destTensor] :
-             nextBackwardInputTensorMap)
+        allocationVector.emplace_back(Allocation{ &unit->ForwardOutput });
+
+        const auto itr = backwardStepIdxMap.find(unit);
+        if (itr == backwardStepIdxMap.end())
+            continue;
+        const auto stepIdx = itr->second;
+
+        for (auto& [previousUnitId, gradient] : unit->BackwardOutputMap)
         {
-            if (targetUnitId == subjectUnitId)
-            {
-                hasValidBackwardUnit = true;
-                if (outputTensor.State != destTensor.State + 1)
+            std::vector<std::size_t> stepVector = { stepIdx };
+            const auto previousItr = backwardStepIdxMap.find(
+                m_unitMap.at(previousUnitId).get());
+            if (previousItr != backwardStepIdxMap.end())
+                stepVector.emplace_back(previousItr->second);
+            allocationVector.emplace_back(Allocation{ &gradient, stepVector });
+        }
+
+        for (const auto& key : unit->BackwardScratchKeys())
+            allocationVector.emplace_back(
+                Allocation{ &unit->InternalTensorMap.at(key), { stepIdx } });
+    }
+
+    m_plannedTensorByteSize = 0;
+    if (allocationVector.empty())
+    {
+        m_arena.reset();
+        return;
+    }
+
+    //! Offsets are aligned to cache lines so tensors written concurrently
+    //! by different workers do not share them
+    const auto device = allocationVector.front().TensorPtr->Device;
+    const std::size_t alignment = std::max<std::size_t>(64 / sizeof(T), 1);
+    allocationVector.erase(
+        std::remove_if(allocationVector.begin(), allocationVector.end(),
+                       [&device](const Allocation& allocation) {
+                           return allocation.TensorPtr->Device != device;
+                       }),
+        allocationVector.end());
+    for (auto& allocation : allocationVector)
+    {
+        const auto size = allocation.TensorPtr->TotalElementSize();
+        allocation.Size = (size + alignment - 1) / alignment * alignment;
+        m_plannedTensorByteSize += allocation.TensorPtr->GetDataByteSize();
+    }
+
+    const auto isOrderedBefore = [this, &isReachable](
+                                     const Allocation& first,
+                                     const Allocation& second) {
+        if (!m_isMemorySharingEnabled || first.StepVector.empty() ||
+            second.StepVector.empty())
+            return false;
+        for (const auto firstStepIdx : first.StepVector)
+            for (const auto secondStepIdx : second.StepVector)
+                if (!isReachable[firstStepIdx][secondStepIdx])
                     return false;
-            }
+        return true;
+    };
+
+    //! Tensors live during the whole cycle are placed first, and the rest
+    //! in order of the backward plan with larger ones first
+    std::stable_sort(allocationVector.begin(), allocationVector.end(),
+                     [](const Allocation& lhs, const Allocation& rhs) {
+                         if (lhs.StepVector.empty() || rhs.StepVector.empty())
+                             return lhs.StepVector.empty() &&
+                                    !rhs.StepVector.empty();
+                         if (lhs.StepVector.front() != rhs.StepVector.front())
+                             return lhs.StepVector.front() <
+                                    rhs.StepVector.front();
+                         return lhs.Size > rhs.Size;
+                     });
+
+    //! Each tensor takes the lowest offset which does not overlap tensors
+    //! that can be live at the same time
+    std::size_t arenaSize = 0;
+    for (std::size_t idx = 0; idx < allocationVector.size(); ++idx)
+    {
+        auto& allocation = allocationVector[idx];
+        std::vector<std::pair<std::size_t, std::size_t>> occupiedVector;
+        for (std::size_t placedIdx = 0; placedIdx < idx; ++placedIdx)
+        {
+            const auto& placed = allocationVector[placedIdx];
+            if (!isOrderedBefore(placed, allocation) &&
+                !isOrderedBefore(allocation, placed))
+                occupiedVector.emplace_back(placed.Offset,
+                                            placed.Offset + placed.Size);
         }
+        std::sort(occupiedVector.begin(), occupiedVector.end());
+
+        std::size_t offset = 0;
+        for (const auto& [begin, end] : occupiedVector)
+        {
+            if (offset + allocation.Size <= begin)
+                break;
+            offset = std::max(offset, end);
+        }
+        allocation.Offset = offset;
+        arenaSize = std::max(arenaSize, offset + allocation.Size);
+    }
+
+    auto arena = std::make_unique<Tensor<T>>(Shape({ arenaSize }), device);
+    for (const auto& allocation : allocationVector)
+        Tensor<T>::ShareTensorData(*arena, *allocation.TensorPtr,
+                                   allocation.Offset);
+    m_arena = std::move(arena);
+}
+
+template <typename T>
+TaskExecutor& UnitManager<T>::m_getExecutor()
+{
+    if (!m_executor)
+    {
+        //! Units are parallelized internally with OpenMP, so the pool only
+        //! needs enough workers to overlap independent branches of the graph
+        const auto numThreads = static_cast<std::size_t>(
+            std::max(omp_get_max_threads(), 1));
+        const auto numWorkers = std::max<std::size_t>(
+            std::min(numThreads, std::max(m_forwardPlan.MaxWidth(),
+                                          m_backwardPlan.MaxWidth())),
+            1);
+        m_executor = std::make_unique<TaskExecutor>(
+            numWorkers, std::max<std::size_t>(numThreads / numWorkers, 1));
     }
-    return hasValidBackwardUnit;
+    return *m_executor;
 }
 
 template <typename T>
-void UnitManager<T>::m_forwardCopy(const UnitId& subjectUnitId)
+void UnitManager<T>::m_restoreFusedUnits()
 {
-    const auto& sourceMetaData = m_unitMetaDataMap[subjectUnitId];
-    auto& subjectOutputTensor = m_unitMap[subjectUnitId]->ForwardOutput;
+    m_unitMap.clear();
+    for (auto& [unitId, unitMetaData] : m_fusedMetaDataMap)
+        m_unitMetaDataMap[unitId] = std::move(unitMetaData);
+    m_fusedMetaDataMap.clear();
 
-    for (const auto& outputUnitId : sourceMetaData.OutputUnitVector())
+    //! SoftMaxCrossEntropy is undone first, since its prediction may be
+    //! dense unit which absorbed the activation before the SoftMax
+    for (const auto& [unitId, fusedUnitId] : m_fusedUnitMap)
     {
-        auto& nextInputTensorMap = m_unitMap[outputUnitId]->ForwardInputMap;
-        for (auto& [targetUnitId, destTensor] : nextInputTensorMap)
+        if (unitId.Type.Name() == "SoftMax")
+            m_replaceOutputUnitId(
+                m_unitMetaDataMap.at(unitId).GetInputUnitId("input"),
+                fusedUnitId, unitId);
+        else if (unitId.Type.Name() == "CrossEntropy")
         {
-            if (targetUnitId == subjectUnitId)
-            {
-                Tensor<T>::CopyTensorData(subjectOutputTensor, destTensor);
-                destTensor.State.fetch_add(1);
-            }
+            m_replaceOutputUnitId(
+                m_unitMetaDataMap.at(unitId).GetInputUnitId("label"),
+                fusedUnitId, unitId);
+            m_unitMetaDataMap.erase(fusedUnitId);
         }
     }
+
+    for (const auto& [activationUnitId, unitId] : m_fusedUnitMap)
+    {
+        if (m_fusedActivationMap.find(unitId) == m_fusedActivationMap.end())
+            continue;
+
+        for (const auto& nextUnitId :
+             m_unitMetaDataMap.at(activationUnitId).OutputUnitVector())
+            m_unitMetaDataMap.at(nextUnitId)
+                .ReplaceInputUnitId(unitId, activationUnitId);
+        m_unitMetaDataMap.at(unitId).SetOutputUnitIdVector(
+            { activationUnitId });
+    }
+
+    m_fusedActivationMap.clear();
+    m_fusedUnitMap.clear();
+}
+
+template <typename T>
+void UnitManager<T>::m_fuseActivations()
+{
+    for (auto& [unitId, unitMetaData] : m_unitMetaDataMap)
+    {
+        if (unitId.Type.Name() != "Dense" && unitId.Type.Name() != "Conv2D")
+            continue;
+        if (m_keptOutputSet.find(unitId) != m_keptOutputSet.end())
+            continue;
+
+        const auto outputUnitVector = unitMetaData.OutputUnitVector();
+        if (outputUnitVector.size() != 1)
+            continue;
+
+        const auto activationUnitId = outputUnitVector.front();
+        const auto activationName = activationUnitId.Type.Name();
+        Activation activation;
+        if (activationName == "ReLU")
+            activation = Activation::Relu;
+        else if (activationName == "Sigmoid")
+            activation = Activation::Sigmoid;
+        else
+            continue;
+
+        const auto& activationMetaData =
+            m_unitMetaDataMap.at(activationUnitId);
+        for (const auto& nextUnitId : activationMetaData.OutputUnitVector())
+            m_unitMetaDataMap.at(nextUnitId)
+                .ReplaceInputUnitId(activationUnitId, unitId);
+
+        unitMetaData.SetOutputUnitIdVector(
+            activationMetaData.OutputUnitVector());
+        m_fusedActivationMap[unitId] = activation;
+        m_fusedUnitMap[activationUnitId] = unitId;
+    }
+
+    for (const auto& [activationUnitId, denseUnitId] : m_fusedUnitMap)
+    {
+        m_fusedMetaDataMap[activationUnitId] =
+            std::move(m_unitMetaDataMap.at(activationUnitId));
+        m_unitMetaDataMap.erase(activationUnitId);
+    }
 }
 
 template <typename T>
-void UnitManager<T>::m_backwardCopy(const UnitId& subjectUnitId)
+void UnitManager<T>::m_fuseSoftMaxCrossEntropy()
 {
-    for (const auto& [unitId, outputTensor] :
-         m_unitMap.at(subjectUnitId)->BackwardOutputMap)
+    std::vector<UnitId> lossUnitIdVector;
+    for (const auto& [unitId, unitMetaData] : m_unitMetaDataMap)
+        if (unitId.Type.Name() == "CrossEntropy" &&
+            m_keptOutputSet.find(unitId) == m_keptOutputSet.end())
+            lossUnitIdVector.emplace_back(unitId);
+
+    for (const auto& lossUnitId : lossUnitIdVector)
     {
-        auto& nextBackwardInputTensorMap =
-            m_unitMap.at(unitId)->BackwardInputMap;
+        const auto& lossMetaData = m_unitMetaDataMap.at(lossUnitId);
+        const auto softMaxUnitId = lossMetaData.GetInputUnitId("prediction");
+        const auto labelUnitId = lossMetaData.GetInputUnitId("label");
+        if (softMaxUnitId.Type.Name() != "SoftMax")
+            continue;
+
+        const auto& softMaxMetaData = m_unitMetaDataMap.at(softMaxUnitId);
+        if (softMaxMetaData.OutputUnitVector().size() != 1)
+            continue;
+
+        const auto sourceUnitId = softMaxMetaData.GetInputUnitId("input");
+        const UnitId fusedUnitId{
+            UnitType(UnitBaseType::Loss, "SoftMaxCrossEntropy"), lossUnitId.Id,
+            lossUnitId.UnitName
+        };
 
-        for (auto& [targetUnitId, destTensor] : nextBackwardInputTensorMap)
+        FrontEnd::UnitMetaData<T> fusedMetaData(
+            fusedUnitId, lossMetaData.BatchSize(), {}, {},
+            { { "prediction", softMaxMetaData.GetInputShape("input") },
+              { "label", lossMetaData.GetInputShape("label") } },
+            lossMetaData.GetOutputShape(),
+            { { "prediction", sourceUnitId }, { "label", labelUnitId } },
+            lossMetaData.Device);
+
+        m_replaceOutputUnitId(sourceUnitId, softMaxUnitId, fusedUnitId);
+        m_replaceOutputUnitId(labelUnitId, lossUnitId, fusedUnitId);
+
+        m_fusedMetaDataMap[softMaxUnitId] =
+            std::move(m_unitMetaDataMap.at(softMaxUnitId));
+        m_fusedMetaDataMap[lossUnitId] =
+            std::move(m_unitMetaDataMap.at(lossUnitId));
+        m_unitMetaDataMap.erase(softMaxUnitId);
+        m_unitMetaDataMap.erase(lossUnitId);
+        m_unitMetaDataMap[fusedUnitId] = std::move(fusedMetaData);
+        m_fusedUnitMap[softMaxUnitId] = fusedUnitId;
+        m_fusedUnitMap[lossUnitId] = fusedUnitId;
+    }
+}
+
+template <typename T>
+void UnitManager<T>::m_replaceOutputUnitId(const UnitId& unitId,
+                                           const UnitId& previousUnitId,
+                                           const UnitId& newUnitId)
+{
+    auto& unitMetaData = m_unitMetaDataMap.at(unitId);
+    auto outputUnitVector = unitMetaData.OutputUnitVector();
+    std::replace(outputUnitVector.begin(), outputUnitVector.end(),
+                 previousUnitId, newUnitId);
+    unitMetaData.SetOutputUnitIdVector(outputUnitVector);
+}
+
+template <typename T>
+UnitId UnitManager<T>::m_resolveUnitId(const UnitId& unitId) const
+{
+    const auto itr = m_fusedUnitMap.find(unitId);
+    if (itr == m_fusedUnitMap.end())
+        return unitId;
+    return itr->second;
+}
+
+template <typename T>
+void UnitManager<T>::m_placeParameters()
+{
+    //! Trainable tensor of a unit and its offset in the slabs
+    struct Placement
+    {
+        Graph::TrainableUnit<T>* Unit;
+        std::string Key;
+        std::size_t Offset;
+    };
+
+    //! Units with trainable tensors in order of back propagation and the
+    //! range of the slabs each of them occupies
+    std::vector<std::pair<const Graph::ComputableUnit<T>*,
+                          Graph::TrainableUnit<T>*>>
+        trainableUnitVector;
+    for (auto itr = m_forwardPlan.StepVector.rbegin();
+         itr != m_forwardPlan.StepVector.rend(); ++itr)
+        if (auto* unit = dynamic_cast<Graph::TrainableUnit<T>*>(itr->Unit);
+            unit && !unit->TrainableTensorMap.empty())
+            trainableUnitVector.emplace_back(itr->Unit, unit);
+
+    const std::size_t alignment = std::max<std::size_t>(64 / sizeof(T), 1);
+    std::vector<Placement> placementVector;
+    std::vector<std::pair<std::size_t, std::size_t>> rangeVector;
+    std::size_t slabSize = 0;
+    for (const auto& [computableUnit, unit] : trainableUnitVector)
+    {
+        std::vector<std::string> keyVector;
+        for (const auto& [key, tensor] : unit->TrainableTensorMap)
+            keyVector.emplace_back(key);
+        std::sort(keyVector.begin(), keyVector.end());
+
+        const auto begin = slabSize;
+        for (const auto& key : keyVector)
+        {
+            placementVector.emplace_back(Placement{ unit, key, slabSize });
+            const auto size =
+                unit->TrainableTensorMap.at(key).TotalElementSize();
+            slabSize += (size + alignment - 1) / alignment * alignment;
+        }
+        rangeVector.emplace_back(begin, slabSize);
+    }
+
+    m_segmentMap.clear();
+    m_segmentDeque.clear();
+    m_momentSlabVector.clear();
+    m_parameterSlab.reset();
+    m_gradientSlab.reset();
+    m_microBatchGradientSlab.reset();
+    m_microBatchIdx = 0;
+    if (placementVector.empty())
+        return;
+
+    const auto device =
+        placementVector.front().Unit->TrainableTensorMap.begin()->second.Device;
+    const Compute::Zeros<T> zeroInitializer;
+    const auto makeSlab = [&]() {
+        auto slab = std::make_unique<Tensor<T>>(Shape({ slabSize }), device);
+        zeroInitializer.Initialize(*slab);
+        return slab;
+    };
+
+    //! Initialized values are copied before tensors refer to the slab
+    m_parameterSlab = makeSlab();
+    for (const auto& [unit, key, offset] : placementVector)
+    {
+        auto& tensor = unit->TrainableTensorMap.at(key);
+        std::copy(tensor.Data.Begin(), tensor.Data.End(),
+                  m_parameterSlab->Data.Address(offset));
+        Tensor<T>::ShareTensorData(*m_parameterSlab, tensor, offset);
+    }
+
+    if (m_isInference)
+        return;
+
+    m_gradientSlab = makeSlab();
+    if (m_numMicroBatches > 1)
+        m_microBatchGradientSlab = makeSlab();
+    //! Units write their gradients to the slab the optimizer reads, unless
+    //! gradients are accumulated
+    const auto& microBatchGradientSlab = m_microBatchGradientSlab
+                                             ? *m_microBatchGradientSlab
+                                             : *m_gradientSlab;
+    for (std::size_t idx = 0; idx < m_optimizer->NumMoments(); ++idx)
+        m_momentSlabVector.emplace_back(Shape({ slabSize }), device);
+    for (auto& moment : m_momentSlabVector)
+        zeroInitializer.Initialize(moment);
+
+    for (std::size_t idx = 0; idx < trainableUnitVector.size(); ++idx)
+    {
+        const auto [computableUnit, unit] = trainableUnitVector[idx];
+        const auto [begin, end] = rangeVector[idx];
+
+        auto& segment = m_segmentDeque.emplace_back(unit, end - begin, device);
+        Tensor<T>::ShareTensorData(*m_parameterSlab, segment.Parameters,
+                                   begin);
+        Tensor<T>::ShareTensorData(*m_gradientSlab, segment.Gradients, begin);
+        Tensor<T>::ShareTensorData(microBatchGradientSlab,
+                                   segment.MicroBatchGradients, begin);
+        //! Growing the vector would copy the views out of the slab
+        segment.State.MomentVector.reserve(m_momentSlabVector.size());
+        for (const auto& moment : m_momentSlabVector)
         {
-            if (targetUnitId == subjectUnitId)
+            segment.State.MomentVector.emplace_back(Shape({ end - begin }),
+                                                    device);
+            Tensor<T>::ShareTensorData(moment,
+                                       segment.State.MomentVector.back(),
+                                       begin);
+        }
+
+        m_segmentMap[computableUnit] = &segment;
+        unit->OptimizerStateMap.clear();
+    }
+
+    for (const auto& [unit, key, offset] : placementVector)
+    {
+        Tensor<T>::ShareTensorData(microBatchGradientSlab,
+                                   unit->GradientTensorMap.at(key), offset);
+
+        const auto& tensor = unit->TrainableTensorMap.at(key);
+        auto& state = unit->OptimizerStateMap[key];
+        state.MomentVector.reserve(m_momentSlabVector.size());
+        for (const auto& moment : m_momentSlabVector)
+        {
+            state.MomentVector.emplace_back(tensor.TensorShape,
+                                            tensor.BatchSize, tensor.Device);
+            Tensor<T>::ShareTensorData(moment, state.MomentVector.back(),
+                                       offset);
+        }
+    }
+}
+
+template <typename T>
+void UnitManager<T>::m_enqueueUpdate(const Graph::ComputableUnit<T>* unit)
+{
+    const auto itr = m_segmentMap.find(unit);
+    if (itr == m_segmentMap.end())
+        return;
+
+    auto* segment = itr->second;
+    auto* optimizer = m_optimizer.get();
+    const auto microBatchIdx = m_microBatchIdx;
+    const auto numMicroBatches = m_numMicroBatches;
+    const auto update = [segment, optimizer, microBatchIdx,
+                         numMicroBatches]() {
+        if (numMicroBatches > 1)
+        {
+            auto& gradients = segment->Gradients;
+            const auto& microBatchGradients = segment->MicroBatchGradients;
+            if (microBatchIdx == 0)
+                Compute::Map([](auto gradient) { return gradient; },
+                             gradients, microBatchGradients);
+            else if (microBatchIdx + 1 < numMicroBatches)
+                Compute::Map(
+                    [](auto sum, auto gradient) { return sum + gradient; },
+                    gradients, gradients, microBatchGradients);
+            else
             {
-                Tensor<T>::CopyTensorData(outputTensor, destTensor);
-                destTensor.State.fetch_add(1);
+                //! Sum of the last micro batch becomes the mean
+                const auto scale =
+                    static_cast<T>(1) / static_cast<T>(numMicroBatches);
+                Compute::Map(
+                    [scale](auto sum, auto gradient) {
+                        return (sum + gradient) * scale;
+                    },
+                    gradients, gradients, microBatchGradients);
             }
+
+            if (microBatchIdx + 1 < numMicroBatches)
+                return;
         }
+
+        optimizer->Optimize(segment->Parameters, segment->Gradients,
+                            segment->State);
+
+        for (auto& [key, state] : segment->Unit->OptimizerStateMap)
+            state.Step = segment->State.Step;
+        segment->Unit->SyncTrainableTensors();
+    };
+
+    if (!m_updateQueue)
+    {
+        update();
+        return;
     }
+    m_updateQueue->Push(update);
+}
+
+template <typename T>
+void UnitManager<T>::WaitForParameterUpdates()
+{
+    if (m_updateQueue)
+        m_updateQueue->Wait();
 }
 
 template <typename T>
 std::unique_ptr<Compute::Optimizer<T>> UnitManager<T>::m_makeOptimizer(
     const std::string& optimizerName, const Parameter& parameter) const
 {
+    const auto getParam = [&parameter](const std::string& name,
+                                       float defaultValue) {
+        return static_cast<T>(
+            parameter.GetFloatingPointParam(name, defaultValue));
+    };
+    const auto learningRate =
+        static_cast<T>(parameter.GetFloatingPointParam("LearningRate"));
+
     if (optimizerName == "SGD")
     {
         auto optimizer = std::make_unique<Compute::SGD<T>>(
-            parameter.GetFloatingPointParam("LearningRate"));
+            learningRate, getParam("Momentum", 0.0f),
+            parameter.GetIntegerParam("Nesterov", 0) != 0,
+            getParam("WeightDecay", 0.0f));
         return std::move(optimizer);
     }
-    throw std::runtime_error("Unsupported optimizer type");
+    if (optimizerName == "Adam" || optimizerName == "AdamW")
+    {
+        const auto isAdamW = optimizerName == "AdamW";
+        auto optimizer = std::make_unique<Compute::Adam<T>>(
+            learningRate, getParam("Beta1", 0.9f), getParam("Beta2", 0.999f),
+            getParam("Epsilon", 1e-8f),
+            getParam("WeightDecay", isAdamW ? 0.01f : 0.0f), isAdamW);
+        return std::move(optimizer);
+    }
+    throw std::runtime_error("Unsupported optimizer type : " + optimizerName);
 }
 
 template <typename T>
@@ -351,37 +1173,56 @@ bool UnitManager<T>::m_appendSource(
 
 template <typename T>
 bool UnitManager<T>::m_appendHidden(
-    const FrontEnd::UnitMetaData<T>& unitMetaData,
-    const std::string& optimizerName, const Parameter& parameter)
+    const FrontEnd::UnitMetaData<T>& unitMetaData)
 {
     const auto unitId = unitMetaData.Id();
     auto type = unitId.Type;
 
     if (type.Name() == "Dense")
     {
+        const auto itr = m_fusedActivationMap.find(unitId);
+        const auto activation = itr == m_fusedActivationMap.end()
+                                    ? Activation::Linear
+                                    : itr->second;
         auto unit = Graph::DenseUnit<T>::CreateUnit(
-            unitMetaData, m_makeOptimizer(optimizerName, parameter));
+            unitMetaData, activation, m_isInference, m_storageType);
 
         m_unitMap[unitId] =
             std::make_unique<Graph::DenseUnit<T>>(std::move(unit));
         return true;
     }
+    if (type.Name() == "Conv2D")
+    {
+        const auto itr = m_fusedActivationMap.find(unitId);
+        const auto activation = itr == m_fusedActivationMap.end()
+                                    ? Activation::Linear
+                                    : itr->second;
+        auto unit = Graph::Conv2DUnit<T>::CreateUnit(unitMetaData, activation,
+                                                     m_isInference);
+
+        m_unitMap[unitId] =
+            std::make_unique<Graph::Conv2DUnit<T>>(std::move(unit));
+        return true;
+    }
     if (type.Name() == "ReLU")
     {
-        auto unit = Graph::ReLU<T>::CreateUnit(unitMetaData);
+        auto unit =
+            Graph::ReLU<T>::CreateUnit(unitMetaData, m_isInference);
         m_unitMap[unitId] = std::make_unique<Graph::ReLU<T>>(std::move(unit));
         return true;
     }
     if (type.Name() == "Sigmoid")
     {
-        auto unit = Graph::Sigmoid<T>::CreateUnit(unitMetaData);
+        auto unit =
+            Graph::Sigmoid<T>::CreateUnit(unitMetaData, m_isInference);
         m_unitMap[unitId] =
             std::make_unique<Graph::Sigmoid<T>>(std::move(unit));
         return true;
     }
     if (type.Name() == "SoftMax")
     {
-        auto unit = Graph::SoftMax<T>::CreateUnit(unitMetaData);
+        auto unit =
+            Graph::SoftMax<T>::CreateUnit(unitMetaData, m_isInference);
         m_unitMap[unitId] =
             std::make_unique<Graph::SoftMax<T>>(std::move(unit));
         return true;
@@ -413,14 +1254,24 @@ bool UnitManager<T>::m_appendLoss(const FrontEnd::UnitMetaData<T>& unitMetaData)
 
     if (type.Name() == "CrossEntropy")
     {
-        auto unit = Graph::CrossEntropy<T>::CreateUnit(unitMetaData);
+        auto unit =
+            Graph::CrossEntropy<T>::CreateUnit(unitMetaData, m_isInference);
         m_unitMap[unitId] =
             std::make_unique<Graph::CrossEntropy<T>>(std::move(unit));
         return true;
     }
+    if (type.Name() == "SoftMaxCrossEntropy")
+    {
+        auto unit = Graph::SoftMaxCrossEntropy<T>::CreateUnit(unitMetaData,
+                                                              m_isInference);
+        m_unitMap[unitId] =
+            std::make_unique<Graph::SoftMaxCrossEntropy<T>>(std::move(unit));
+        return true;
+    }
     if (type.Name() == "MSE")
     {
-        auto unit = Graph::MSELoss<T>::CreateUnit(unitMetaData);
+        auto unit =
+            Graph::MSELoss<T>::CreateUnit(unitMetaData, m_isInference);
         m_unitMap[unitId] =
             std::make_unique<Graph::MSELoss<T>>(std::move(unit));
         return true;
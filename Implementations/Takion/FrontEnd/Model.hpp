@@ -13,7 +13,9 @@
 #include <Takion/Computations/Device.hpp>
 #include <Takion/Engine/UnitManager.hpp>
 #include <Takion/Utils/Loaders/Loader.hpp>
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 
 
 namespace Takion::FrontEnd
@@ -143,6 +145,89 @@ AbsTensor<T> Model<T>::Dense(AbsTensor<T> source, unsigned numUnits,
     return AbsTensor<T>(outputShape, subjectUnitId);
 }
 
+template <typename T>
+AbsTensor<T> Model<T>::Conv2D(AbsTensor<T> source, unsigned numFilters,
+                              unsigned kernelHeight, unsigned kernelWidth,
+                              unsigned stride, unsigned padding,
+                              unsigned dilation,
+                              std::unique_ptr<Compute::Initializer<T>>
+                              weightInitializer,
+                              std::unique_ptr<Compute::Initializer<T>>
+                              biasInitializer, std::string name)
+{
+    const UnitId subjectUnitId{ UnitType(UnitBaseType::Hidden, "Conv2D"),
+                                m_id++, std::move(name) };
+
+    const auto prevUnitId = source.GetPrevOutput();
+    const auto prevOutputShape =
+        m_unitManager.GetUnitOutputShape(prevUnitId);
+
+    if (prevOutputShape.Dim() != 3)
+        throw std::invalid_argument(
+            "Conv2D - source should be (channel, height, width) tensor. "
+            "Given shape : " +
+            prevOutputShape.ToString());
+
+    Compute::Conv2DGeometry geometry;
+    geometry.InputChannels = prevOutputShape.At(0);
+    geometry.InputHeight = prevOutputShape.At(1);
+    geometry.InputWidth = prevOutputShape.At(2);
+    geometry.KernelHeight = kernelHeight;
+    geometry.KernelWidth = kernelWidth;
+    geometry.StrideHeight = geometry.StrideWidth = stride;
+    geometry.PaddingHeight = geometry.PaddingWidth = padding;
+    geometry.DilationHeight = geometry.DilationWidth = dilation;
+
+    if (geometry.OutputHeight() == 0 || geometry.OutputWidth() == 0)
+        throw std::invalid_argument(
+            "Conv2D - kernel does not fit in the padded source. "
+            "Given shape : " +
+            prevOutputShape.ToString());
+
+    m_appendSubjectUnitToPreviousOutput(subjectUnitId, prevUnitId);
+
+    const auto kernelSize = kernelHeight * kernelWidth;
+    const Shape weightShape({ numFilters, geometry.PatchSize() });
+    const Shape biasShape({ numFilters });
+    const Shape outputShape(
+        { numFilters, geometry.OutputHeight(), geometry.OutputWidth() });
+
+    std::unordered_map<std::string, std::unique_ptr<Compute::Initializer<T>>>
+        initializerMap;
+
+    weightInitializer->FanIn = geometry.PatchSize();
+    weightInitializer->FanOut = numFilters * kernelSize;
+    biasInitializer->FanIn = geometry.PatchSize();
+    biasInitializer->FanOut = numFilters * kernelSize;
+
+    initializerMap["weight"] = std::move(weightInitializer);
+    initializerMap["bias"] = std::move(biasInitializer);
+
+    const auto toInt = [](std::size_t value) {
+        return static_cast<int>(value);
+    };
+    Parameter params(std::unordered_map<std::string, int>{
+        { "KernelHeight", toInt(geometry.KernelHeight) },
+        { "KernelWidth", toInt(geometry.KernelWidth) },
+        { "StrideHeight", toInt(geometry.StrideHeight) },
+        { "StrideWidth", toInt(geometry.StrideWidth) },
+        { "PaddingHeight", toInt(geometry.PaddingHeight) },
+        { "PaddingWidth", toInt(geometry.PaddingWidth) },
+        { "DilationHeight", toInt(geometry.DilationHeight) },
+        { "DilationWidth", toInt(geometry.DilationWidth) } });
+
+    UnitMetaData<T> unitMetaData(
+        subjectUnitId, m_batchSize,
+        { { "weight", weightShape }, { "bias", biasShape } },
+        std::move(initializerMap), { { "input", prevOutputShape } },
+        outputShape, { { "input", prevUnitId } }, m_device,
+        std::move(params));
+
+    m_unitManager.AppendUnit(std::move(unitMetaData));
+
+    return AbsTensor<T>(outputShape, subjectUnitId);
+}
+
 template <typename T>
 AbsTensor<T> Model<T>::ReLU(AbsTensor<T> source, std::string name)
 {
@@ -259,6 +344,33 @@ AbsTensor<T> Model<T>::CrossEntropy(AbsTensor<T> prediction, AbsTensor<T> label,
     return AbsTensor<T>(Shape(), subjectUnitId);
 }
 
+template <typename T>
+AbsTensor<T> Model<T>::SoftMaxCrossEntropy(AbsTensor<T> prediction,
+                                           AbsTensor<T> label,
+                                           std::string name)
+{
+    const UnitId subjectUnitId{
+        UnitType(UnitBaseType::Loss, "SoftMaxCrossEntropy"), m_id++,
+        std::move(name)
+    };
+
+    const auto predictionId = prediction.GetPrevOutput();
+    const auto labelId = label.GetPrevOutput();
+    const auto predictionShape = prediction.GetShape();
+    const auto labelShape = label.GetShape();
+
+    m_appendSubjectUnitToPreviousOutput(subjectUnitId, predictionId);
+    m_appendSubjectUnitToPreviousOutput(subjectUnitId, labelId);
+
+    UnitMetaData<T> unitMetaData(
+        subjectUnitId, m_batchSize, {}, {},
+        { { "prediction", predictionShape }, { "label", labelShape } }, Shape(),
+        { { "prediction", predictionId }, { "label", labelId } }, m_device);
+
+    m_unitManager.AppendUnit(std::move(unitMetaData));
+    return AbsTensor<T>(Shape(), subjectUnitId);
+}
+
 
 template <typename T>
 void Model<T>::Compile(std::string optimizer, Parameter optimizerParams)
@@ -266,6 +378,18 @@ void Model<T>::Compile(std::string optimizer, Parameter optimizerParams)
     m_unitManager.Compile(optimizer, optimizerParams);
 }
 
+template <typename T>
+void Model<T>::CompileForInference()
+{
+    m_unitManager.CompileForInference();
+}
+
+template <typename T>
+void Model<T>::CompileForQuantizedInference(std::size_t numCalibrationBatches)
+{
+    m_unitManager.CompileForQuantizedInference(numCalibrationBatches);
+}
+
 template <typename T>
 void Model<T>::Train()
 {
@@ -301,6 +425,14 @@ void Model<T>::Train(std::map<AbsTensor<T>, std::vector<T>>
 }
 
 
+template <typename T>
+void Model<T>::AsyncTrain()
+{
+    m_unitManager.AsyncForward(0);
+    m_unitManager.AsyncBackward(0);
+    m_unitManager.ResetState();
+}
+
 template <typename T>
 void Model<T>::Predict()
 {
@@ -349,11 +481,15 @@ void Model<T>::Predict(
 
 
 template <typename T>
-void Model<T>::Fit(std::size_t epochs)
+void Model<T>::Fit(std::size_t epochs, std::size_t pipelineDepth)
 {
     for (std::size_t cycle = 0; cycle < epochs; ++cycle)
     {
-        Train();
+        m_unitManager.Forward();
+        //! Cycles beyond the last epoch are not loaded
+        m_unitManager.Prefetch(std::min(pipelineDepth, epochs - cycle - 1));
+        m_unitManager.Backward();
+        m_unitManager.ResetState();
     }
 }
 
@@ -388,6 +524,44 @@ T Model<T>::GetLoss(AbsTensor<T> lossId)
     return loss;
 }
 
+template <typename T>
+Util::TensorData<T> Model<T>::TrainableTensor(AbsTensor<T> absTensor,
+                                              const std::string& key)
+{
+    return m_toTensorData(
+        m_getTrainableUnit(absTensor)->TrainableTensorMap.at(key));
+}
+
+template <typename T>
+Util::TensorData<T> Model<T>::GradientTensor(AbsTensor<T> absTensor,
+                                             const std::string& key)
+{
+    return m_toTensorData(
+        m_getTrainableUnit(absTensor)->GradientTensorMap.at(key));
+}
+
+template <typename T>
+Graph::TrainableUnit<T>* Model<T>::m_getTrainableUnit(AbsTensor<T> absTensor)
+{
+    const auto unitId = absTensor.GetPrevOutput();
+    auto* unit = dynamic_cast<Graph::TrainableUnit<T>*>(
+        m_unitManager.GetUnit(unitId).get());
+    if (!unit)
+        throw std::invalid_argument("Given unit must be trainable");
+    return unit;
+}
+
+template <typename T>
+Util::TensorData<T> Model<T>::m_toTensorData(const Tensor<T>& tensor)
+{
+    const auto size = tensor.TensorShape.Size();
+    std::vector<T> data(tensor.BatchSize * size);
+    for (std::size_t idx = 0; idx < data.size(); ++idx)
+        data[idx] = tensor.At(idx);
+
+    return Util::TensorData<T>(data, tensor.TensorShape, tensor.BatchSize);
+}
+
 
 template <typename T>
 void Model<T>::ChangeLoader(AbsTensor<T> loaderId,
@@ -89,6 +89,15 @@ void UnitMetaData<T>::SetOutputUnitIdVector(std::vector<UnitId> unitIdVector)
     m_outputUnitIdVector = std::move(unitIdVector);
 }
 
+template <typename T>
+void UnitMetaData<T>::ReplaceInputUnitId(const UnitId& previousUnitId,
+                                         const UnitId& newUnitId)
+{
+    for (auto& [key, unitId] : m_inputUnitMap)
+        if (unitId == previousUnitId)
+            unitId = newUnitId;
+}
+
 template <typename T>
 void UnitMetaData<T>::AddInternalTensor(const std::string& key,
                                         Tensor<T> tensor)
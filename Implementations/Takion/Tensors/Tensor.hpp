@@ -130,6 +130,10 @@ Tensor<T>& Tensor<T>::operator=(const Tensor<T>& tensor)
     if (this == &tensor)
         return *this;
 
+    //! Allocated buffer cannot be reused if size of the data differs
+    if (TotalElementSize() != tensor.TotalElementSize())
+        m_freeData();
+
     TensorShape = tensor.TensorShape;
     Device = tensor.Device;
     BatchSize = tensor.BatchSize;
@@ -334,8 +338,7 @@ void Tensor<T>::MoveTensorData(Tensor<T>& source, Tensor<T>& destination)
 
     //! Deallocate data in destination if it already has allocated data to
     //! prevent memory leaks
-    if (destination.m_hasOwnership)
-        destination.m_freeData();
+    destination.m_freeData();
 
     source.m_hasOwnership.exchange(false, std::memory_order_acquire);
     destination.Data = source.Data;
@@ -349,7 +352,7 @@ void Tensor<T>::CopyTensorData(const Tensor<T>& source, Tensor<T>& destination)
         throw std::invalid_argument(
             "Shape mismatch between source and destination tensors");
 
-    if (!source.m_hasOwnership)
+    if (!source.m_hasOwnership && !source.m_isShared)
         throw std::runtime_error(
             "Source tensor does not have ownership of the data");
 
@@ -370,6 +373,20 @@ void Tensor<T>::CopyTensorData(const Tensor<T>& source, Tensor<T>& destination)
                           sourceBatchElementSize * sizeof(T)));
 #endif
         destination.Data = Util::Span<T>(ptr, sourceBatchElementSize);
+        destination.m_isShared.exchange(false, std::memory_order_release);
+    }
+
+    //! Identical layouts include identical paddings, so the whole buffer can
+    //! be copied at once
+    if (source.m_elementSize == destination.m_elementSize &&
+        source.BatchSize == destination.BatchSize)
+    {
+        std::memcpy(destination.Data.Begin(), source.Data.Base(),
+                    source.GetDataByteSize());
+        if (!destination.m_hasOwnership)
+            destination.m_hasOwnership.exchange(true,
+                                                std::memory_order_release);
+        return;
     }
 
     const long blockSize = 100;
@@ -392,12 +409,62 @@ void Tensor<T>::CopyTensorData(const Tensor<T>& source, Tensor<T>& destination)
                                             std::memory_order_release);
 }
 
+template <typename T>
+void Tensor<T>::ShareTensorData(const Tensor<T>& source,
+                                Tensor<T>& destination)
+{
+    if (source.Device != destination.Device)
+        throw std::invalid_argument(
+            "Device type of source and destination tensor must be same when "
+            "sharing data between tensors");
+
+    if (source.TensorShape != destination.TensorShape ||
+        source.BatchSize != destination.BatchSize)
+        throw std::invalid_argument(
+            "Shape mismatch between source and destination tensors");
+
+    if (!source.m_hasOwnership && !source.m_isShared)
+        throw std::runtime_error(
+            "Source tensor does not have ownership of the data");
+
+    if (&source == &destination)
+        return;
+
+    destination.m_freeData();
+    destination.Data = source.Data;
+    destination.m_isShared.exchange(true, std::memory_order_release);
+}
+
+template <typename T>
+void Tensor<T>::ShareTensorData(const Tensor<T>& source,
+                                Tensor<T>& destination, std::size_t offset)
+{
+    if (source.Device != destination.Device)
+        throw std::invalid_argument(
+            "Device type of source and destination tensor must be same when "
+            "sharing data between tensors");
+
+    if (offset + destination.TotalElementSize() > source.TotalElementSize())
+        throw std::invalid_argument(
+            "Destination tensor exceeds buffer of the source tensor");
+
+    if (!source.m_hasOwnership && !source.m_isShared)
+        throw std::runtime_error(
+            "Source tensor does not have ownership of the data");
+
+    Util::Span<T> sourceData = source.Data;
+    destination.m_freeData();
+    destination.Data =
+        sourceData.SubSpan(offset, destination.TotalElementSize());
+    destination.m_isShared.exchange(true, std::memory_order_release);
+}
+
 template <typename T>
 void Tensor<T>::ChangeBatchSize(std::size_t newBatchSize)
 {
-    m_hasOwnership.exchange(false, std::memory_order_acquire);
+    //! Shared buffer is not deallocated since it is owned by another tensor
+    m_freeData();
     const auto newTotalSize = ElementSize() * newBatchSize;
-    Data.Clear();
 
 #ifdef _MSC_VER
     T* ptr = static_cast<T*>(
@@ -407,6 +474,7 @@ void Tensor<T>::ChangeBatchSize(std::size_t newBatchSize)
         aligned_alloc(Device.PadByteSize(), newTotalSize * sizeof(T)));
 #endif
     Data = Util::Span<T>(ptr, newTotalSize);
+    BatchSize = newBatchSize;
     m_hasOwnership.exchange(true, std::memory_order_release);
 }
 
@@ -450,6 +518,11 @@ void Tensor<T>::m_freeData()
         m_hasOwnership.exchange(false, std::memory_order_acquire);
         Data.Clear();
     }
+    else if (m_isShared)
+    {
+        m_isShared.exchange(false, std::memory_order_acquire);
+        Data = Util::Span<T>();
+    }
 }
 } // namespace Takion
 #endif
@@ -18,14 +18,15 @@ template <typename T>
 ReLU<T>::ReLU(
     const UnitId& unitId, UnitId sourceUnitId, Tensor<T> forwardInput,
     std::unordered_map<UnitId, Tensor<T>> backwardInputVector,
-    Tensor<T> forwardOutput, Tensor<T> backwardOutput,
+    Tensor<T> forwardOutput,
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
     std::unordered_map<std::string, Tensor<T>> internalTensorMap,
     std::size_t batchSize)
     : ComputableUnit<T>(unitId,
                         { { sourceUnitId, std::move(forwardInput) } },
                         std::move(backwardInputVector),
                         forwardOutput,
-                        { { sourceUnitId, std::move(backwardOutput) } },
+                        std::move(backwardOutputMap),
                         std::move(internalTensorMap),
                         batchSize),
       m_sourceUnitId(std::move(sourceUnitId))
@@ -49,7 +50,7 @@ ReLU<T>& ReLU<T>::operator=(
 
 template <typename T>
 ReLU<T> ReLU<T>::CreateUnit(
-    const FrontEnd::UnitMetaData<T>& unitMetaData)
+    const FrontEnd::UnitMetaData<T>& unitMetaData, bool inferenceOnly)
 {
     const auto unitId = unitMetaData.Id();
     const auto batchSize = unitMetaData.BatchSize();
@@ -63,22 +64,31 @@ ReLU<T> ReLU<T>::CreateUnit(
 
     Tensor<T> forwardInputTensor(inputShape, batchSize, device);
 
+    Tensor<T> forwardOutputTensor(outputShape, batchSize, device);
+
+    //! Tensors of back propagation are not allocated for inference
     std::unordered_map<UnitId, Tensor<T>> backwardInputMap;
-    for (const auto& backwardInputUnitId : unitMetaData.OutputUnitVector())
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    std::unordered_map<std::string, Tensor<T>> internalTensorMap;
+    if (!inferenceOnly)
     {
-        Tensor<T> tensor(inputShape, batchSize, device);
-        backwardInputMap[backwardInputUnitId] = tensor;
+        for (const auto& backwardInputUnitId : unitMetaData.OutputUnitVector())
+        {
+            Tensor<T> tensor(inputShape, batchSize, device);
+            backwardInputMap[backwardInputUnitId] = tensor;
+        }
+
+        Tensor<T> backwardOutputTensor(inputShape, batchSize, device);
+        Tensor<T> backwardTempTensor(outputShape, batchSize, device);
+        backwardOutputMap[sourceUnitId] = backwardOutputTensor;
+        internalTensorMap["backwardTemp"] = backwardTempTensor;
     }
 
-    Tensor<T> forwardOutputTensor(outputShape, batchSize, device);
-    Tensor<T> backwardOutputTensor(inputShape, batchSize, device);
-    Tensor<T> backwardTempTensor(outputShape, batchSize, device);
-
     auto activationUnit = ReLU<T>(
         unitMetaData.Id(), sourceUnitId, forwardInputTensor,
         backwardInputMap, forwardOutputTensor,
-        backwardOutputTensor,
-        { { "backwardTemp", backwardTempTensor } }, batchSize);
+        backwardOutputMap,
+        internalTensorMap, batchSize);
 
     return activationUnit;
 }
@@ -88,11 +98,12 @@ void ReLU<T>::Forward()
 {
     const Tensor<T>& inputTensor = ForwardInputMap.at(m_sourceUnitId);
 
-    const auto lambdaForward = [](T val)
-    {
-        return val > static_cast<T>(0) ? val : static_cast<T>(0.1f*val);
+    const auto lambdaForward = [](auto value) {
+        using Value = decltype(value);
+        return Compute::Vector::Select(value > Value(0), value,
+                                       value * Value(0.1f));
     };
-    Compute::Apply(inputTensor, ForwardOutput, lambdaForward);
+    Compute::Map(lambdaForward, ForwardOutput, inputTensor);
 }
 
 template <typename T>
@@ -100,11 +111,12 @@ void ReLU<T>::AsyncForward(std::promise<bool> promise)
 {
     const Tensor<T>& inputTensor = ForwardInputMap.at(m_sourceUnitId);
 
-    const auto lambdaForward = [](T val)
-    {
-        return val > static_cast<T>(0) ? val : static_cast<T>(0.1f * val);
+    const auto lambdaForward = [](auto value) {
+        using Value = decltype(value);
+        return Compute::Vector::Select(value > Value(0), value,
+                                       value * Value(0.1f));
     };
-    Compute::Apply(inputTensor, ForwardOutput, lambdaForward);
+    Compute::Map(lambdaForward, ForwardOutput, inputTensor);
 
     promise.set_value(true);
 }
@@ -127,17 +139,16 @@ void ReLU<T>::Backward()
         Compute::Add(tensor, backwardTemp);
     }
 
-    const auto lambdaBackward = [](T val)
-    {
-
-        return val > static_cast<T>(0)
-                   ? static_cast<T>(1)
-                   : static_cast<T>(0.1f);
+    //! Averaging of the gradients, derivative of ReLU and its product with
+    //! the gradient are evaluated in single pass
+    const auto numInputs = static_cast<T>(BackwardInputMap.size());
+    const auto lambdaBackward = [numInputs](auto gradient, auto value) {
+        using Value = decltype(value);
+        return gradient / Value(numInputs) *
+               Compute::Vector::Select(value > Value(0), Value(1),
+                                       Value(0.1f));
     };
-
-    Compute::ScalarDiv(backwardTemp, static_cast<T>(BackwardInputMap.size()));
-    Compute::Apply(inputTensor, backwardOutput, lambdaBackward);
-    Compute::Dot(backwardTemp, backwardOutput, backwardOutput);
+    Compute::Map(lambdaBackward, backwardOutput, backwardTemp, inputTensor);
 }
 
 template <typename T>
@@ -156,14 +167,16 @@ void ReLU<T>::AsyncBackward(std::promise<bool> promise)
         Compute::Add(tensor, backwardTemp);
     }
 
-    const auto lambdaBackward = [](T val) {
-        return val > static_cast<T>(0) ? static_cast<T>(1)
-                                       : static_cast<T>(0.1f);
+    //! Averaging of the gradients, derivative of ReLU and its product with
+    //! the gradient are evaluated in single pass
+    const auto numInputs = static_cast<T>(BackwardInputMap.size());
+    const auto lambdaBackward = [numInputs](auto gradient, auto value) {
+        using Value = decltype(value);
+        return gradient / Value(numInputs) *
+               Compute::Vector::Select(value > Value(0), Value(1),
+                                       Value(0.1f));
     };
-
-    Compute::ScalarDiv(backwardTemp, static_cast<T>(BackwardInputMap.size()));
-    Compute::Apply(inputTensor, backwardOutput, lambdaBackward);
-    Compute::Dot(backwardTemp, backwardOutput, backwardOutput);
+    Compute::Map(lambdaBackward, backwardOutput, backwardTemp, inputTensor);
 
     promise.set_value(true);
 }
@@ -172,8 +185,9 @@ template <typename T>
 void ReLU<T>::ChangeBatchSize(std::size_t batchSize)
 {
     ComputableUnit<T>::ChangeBatchSize(batchSize);
-    Tensor<T>& backwardTemp = InternalTensorMap.at("backwardTemp");
-    backwardTemp.ChangeBatchSize(batchSize);
+    if (const auto itr = InternalTensorMap.find("backwardTemp");
+        itr != InternalTensorMap.end())
+        itr->second.ChangeBatchSize(batchSize);
 }
 
 
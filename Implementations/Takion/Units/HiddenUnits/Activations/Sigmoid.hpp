@@ -18,14 +18,15 @@ template <typename T>
 Sigmoid<T>::Sigmoid(const UnitId& unitId, UnitId sourceUnitId,
                     Tensor<T> forwardInput,
                     std::unordered_map<UnitId, Tensor<T>> backwardInputVector,
-                    Tensor<T> forwardOutput, Tensor<T> backwardOutput,
+                    Tensor<T> forwardOutput,
+                    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
                     std::unordered_map<std::string, Tensor<T>>
                     internalTensorMap,
                     std::size_t batchSize)
     : ComputableUnit<T>(unitId, { { sourceUnitId, forwardInput } },
                         std::move(backwardInputVector),
                         forwardOutput,
-                        { { sourceUnitId, std::move(backwardOutput) } },
+                        std::move(backwardOutputMap),
                         std::move(internalTensorMap), batchSize),
       m_sourceUnitId(std::move(sourceUnitId))
 {
@@ -46,7 +47,8 @@ Sigmoid<T>& Sigmoid<T>::operator=(Sigmoid<T>&& activationUnit) noexcept
 }
 
 template <typename T>
-Sigmoid<T> Sigmoid<T>::CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData)
+Sigmoid<T> Sigmoid<T>::CreateUnit(
+    const FrontEnd::UnitMetaData<T>& unitMetaData, bool inferenceOnly)
 {
     const auto unitId = unitMetaData.Id();
     const auto batchSize = unitMetaData.BatchSize();
@@ -60,23 +62,32 @@ Sigmoid<T> Sigmoid<T>::CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData)
 
     Tensor<T> forwardInputTensor(inputShape, batchSize, device);
 
+    Tensor<T> forwardOutputTensor(outputShape, batchSize, device);
+
+    //! Tensors of back propagation are not allocated for inference
     std::unordered_map<UnitId, Tensor<T>> backwardInputMap;
-    for (const auto& backwardInputUnitId : unitMetaData.OutputUnitVector())
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    std::unordered_map<std::string, Tensor<T>> internalTensorMap;
+    if (!inferenceOnly)
     {
-        Tensor<T> tensor(inputShape, batchSize, device);
-        backwardInputMap[backwardInputUnitId] = tensor;
+        for (const auto& backwardInputUnitId : unitMetaData.OutputUnitVector())
+        {
+            Tensor<T> tensor(inputShape, batchSize, device);
+            backwardInputMap[backwardInputUnitId] = tensor;
+        }
+
+        Tensor<T> backwardOutputTensor(inputShape, batchSize, device);
+        Tensor<T> backwardTempTensor(outputShape, batchSize, device);
+        backwardOutputMap[sourceUnitId] = backwardOutputTensor;
+        internalTensorMap["backwardTemp"] = backwardTempTensor;
     }
 
-    Tensor<T> forwardOutputTensor(outputShape, batchSize, device);
-    Tensor<T> backwardOutputTensor(inputShape, batchSize, device);
-    Tensor<T> backwardTempTensor(outputShape, batchSize, device);
-
     auto activationUnit =
         Sigmoid<T>(unitMetaData.Id(), sourceUnitId,
                    forwardInputTensor,
                    backwardInputMap, forwardOutputTensor,
-                   backwardOutputTensor,
-                   { { "backwardTemp", backwardTempTensor } }, batchSize);
+                   backwardOutputMap,
+                   internalTensorMap, batchSize);
 
     return activationUnit;
 }
@@ -85,26 +96,13 @@ template <typename T>
 void Sigmoid<T>::Forward()
 {
     const Tensor<T>& inputTensor = ForwardInputMap.at(m_sourceUnitId);
-
-    const auto lambdaForward = [](T val)
-    {
-        return static_cast<T>(static_cast<T>(1) / (1 + std::exp(-val)));
-    };
-    Compute::Apply(inputTensor, ForwardOutput, lambdaForward);
+    Compute::Sigmoid(inputTensor, ForwardOutput);
 }
 
 template <typename T>
 void Sigmoid<T>::AsyncForward(std::promise<bool> promise)
 {
-    const Tensor<T>& inputTensor = ForwardInputMap.at(m_sourceUnitId);
-
-    const auto lambdaForward = [](T val)
-    {
-        return static_cast<T>(static_cast<T>(std::exp(val)) / (1 + std::exp(val)
-                              ));
-    };
-    Compute::Apply(inputTensor, ForwardOutput, lambdaForward);
-
+    Forward();
     promise.set_value(true);
 }
 
@@ -115,7 +113,6 @@ void Sigmoid<T>::Backward()
 
     Tensor<T>& backwardTemp = InternalTensorMap.at("backwardTemp");
     Tensor<T>& backwardOutput = BackwardOutputMap.at(m_sourceUnitId);
-    const Tensor<T>& inputTensor = ForwardInputMap.at(m_sourceUnitId);
 
     zeroInitializer.Initialize(backwardTemp);
 
@@ -124,46 +121,18 @@ void Sigmoid<T>::Backward()
         Compute::Add(tensor, backwardTemp);
     }
 
-    const auto lambdaForward = [](T val)
-    {
-        return static_cast<T>(static_cast<T>(std::exp(val)) /
-                              (1 + std::exp(val)));
-    };
-
-    const auto lambdaBackward = [=](T val)
-    {
-        return static_cast<T>(lambdaForward(val) * (1 - lambdaForward(val)));
-    };
-
-    Compute::ScalarDiv(backwardTemp, static_cast<T>(BackwardInputMap.size()));
-    Compute::Apply(inputTensor, backwardOutput, lambdaBackward);
-    Compute::Dot(backwardTemp, backwardOutput, backwardOutput);
+    //! Derivative is evaluated from the forward output (s * (1 - s)), so
+    //! back propagation does not evaluate exp again
+    Compute::ScalarDiv(backwardTemp, static_cast<T>(BackwardInputMap.size()),
+                       backwardOutput);
+    Compute::ActivationGradient(ForwardOutput, backwardOutput,
+                                Activation::Sigmoid);
 }
 
 template <typename T>
 void Sigmoid<T>::AsyncBackward(std::promise<bool> promise)
 {
-    const Zeros<T> zeroInitializer;
-
-    Tensor<T>& backwardTemp = InternalTensorMap.at("backwardTemp");
-    Tensor<T>& backwardOutput = BackwardOutputMap.at(m_sourceUnitId);
-    const Tensor<T>& inputTensor = ForwardInputMap.at(m_sourceUnitId);
-
-    zeroInitializer.Initialize(backwardTemp);
-
-    for (const auto& [unitId, tensor] : BackwardInputMap)
-        Compute::Add(tensor, backwardTemp);
-
-    const auto lambdaBackward = [](T val)
-    {
-        return static_cast<T>(std::exp(val) / (1 + exp(val)) -
-                              (std::exp(val) / std::pow(1 + exp(val), 2)));
-    };
-
-    Compute::ScalarDiv(backwardTemp, static_cast<T>(BackwardInputMap.size()));
-    Compute::Apply(backwardTemp, backwardOutput, lambdaBackward);
-    Compute::Dot(inputTensor, backwardOutput, backwardOutput);
-
+    Backward();
     promise.set_value(true);
 }
 
@@ -171,8 +140,9 @@ template <typename T>
 void Sigmoid<T>::ChangeBatchSize(std::size_t batchSize)
 {
     ComputableUnit<T>::ChangeBatchSize(batchSize);
-    Tensor<T>& backwardTemp = InternalTensorMap.at("backwardTemp");
-    backwardTemp.ChangeBatchSize(batchSize);
+    if (const auto itr = InternalTensorMap.find("backwardTemp");
+        itr != InternalTensorMap.end())
+        itr->second.ChangeBatchSize(batchSize);
 }
 
 template <typename T>
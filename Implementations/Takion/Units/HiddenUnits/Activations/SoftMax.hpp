@@ -17,14 +17,15 @@ template <typename T>
 SoftMax<T>::SoftMax(const UnitId& unitId, UnitId sourceUnitId,
                     Tensor<T> forwardInput,
                     std::unordered_map<UnitId, Tensor<T>> backwardInputVector,
-                    Tensor<T> forwardOutput, Tensor<T> backwardOutput,
+                    Tensor<T> forwardOutput,
+                    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
                     std::unordered_map<std::string, Tensor<T>>
                     internalTensorMap, Compute::Device device,
                     std::size_t batchSize)
     : ComputableUnit<T>(unitId, { { sourceUnitId, forwardInput } },
                         std::move(backwardInputVector),
                         forwardOutput,
-                        { { sourceUnitId, std::move(backwardOutput) } },
+                        std::move(backwardOutputMap),
                         std::move(internalTensorMap), batchSize),
       m_sourceUnitId(std::move(sourceUnitId)),
       m_device(std::move(device))
@@ -32,7 +33,8 @@ SoftMax<T>::SoftMax(const UnitId& unitId, UnitId sourceUnitId,
 }
 
 template <typename T>
-SoftMax<T> SoftMax<T>::CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData)
+SoftMax<T> SoftMax<T>::CreateUnit(
+    const FrontEnd::UnitMetaData<T>& unitMetaData, bool inferenceOnly)
 {
     const auto unitId = unitMetaData.Id();
     const auto batchSize = unitMetaData.BatchSize();
@@ -46,23 +48,32 @@ SoftMax<T> SoftMax<T>::CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData)
 
     Tensor<T> forwardInputTensor(inputShape, batchSize, device);
 
+    Tensor<T> forwardOutputTensor(outputShape, batchSize, device);
+
+    //! Tensors of back propagation are not allocated for inference
     std::unordered_map<UnitId, Tensor<T>> backwardInputMap;
-    for (const auto& backwardInputUnitId : unitMetaData.OutputUnitVector())
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    std::unordered_map<std::string, Tensor<T>> internalTensorMap;
+    if (!inferenceOnly)
     {
-        Tensor<T> tensor(inputShape, batchSize, device);
-        backwardInputMap[backwardInputUnitId] = tensor;
-    }
+        for (const auto& backwardInputUnitId : unitMetaData.OutputUnitVector())
+        {
+            Tensor<T> tensor(inputShape, batchSize, device);
+            backwardInputMap[backwardInputUnitId] = tensor;
+        }
 
-    Tensor<T> forwardOutputTensor(outputShape, batchSize, device);
-    Tensor<T> backwardOutputTensor(inputShape, batchSize, device);
-    Tensor<T> backwardTempTensor(outputShape, batchSize, device);
+        Tensor<T> backwardOutputTensor(inputShape, batchSize, device);
+        Tensor<T> backwardTempTensor(outputShape, batchSize, device);
+        backwardOutputMap[sourceUnitId] = backwardOutputTensor;
+        internalTensorMap["backwardTemp"] = backwardTempTensor;
+    }
 
     auto activationUnit =
         SoftMax<T>(unitMetaData.Id(), sourceUnitId,
                    forwardInputTensor,
                    backwardInputMap, forwardOutputTensor,
-                   backwardOutputTensor,
-                   { { "backwardTemp", backwardTempTensor } }, device,
+                   backwardOutputMap,
+                   internalTensorMap, device,
                    batchSize);
 
     return activationUnit;
@@ -71,34 +82,10 @@ SoftMax<T> SoftMax<T>::CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData)
 template <typename T>
 void SoftMax<T>::Forward()
 {
-    const auto batchSize = ComputableUnit<T>::BatchSize;
-    const auto shape = ForwardOutput.TensorShape;
-    const auto size = shape.Size();
     const Tensor<T>& inputTensor = ForwardInputMap[m_sourceUnitId];
 
     if (m_device.Type() == Compute::DeviceType::CPU)
-    {
-#pragma omp parallel for schedule(static)
-        for (long batchIdx = 0; batchIdx < static_cast<long>(batchSize);
-             ++batchIdx)
-        {
-            T sum = static_cast<T>(0);
-            for (std::size_t idx = 0; idx < size; ++idx)
-            {
-                const auto index = batchIdx * size + idx;
-                const auto val = inputTensor.At(index);
-                T toAdd = static_cast<T>(std::exp(val));
-                sum = sum + toAdd;
-            }
-            for (std::size_t idx = 0; idx < size; ++idx)
-            {
-                const auto index = batchIdx * size + idx;
-                const auto val = inputTensor.At(index);
-                ForwardOutput.At(index) =
-                    static_cast<T>(std::exp(val)) / sum;
-            }
-        }
-    }
+        Compute::SoftMax(inputTensor, ForwardOutput);
     else
     {
         throw std::runtime_error("Not implemented");
@@ -108,41 +95,7 @@ void SoftMax<T>::Forward()
 template <typename T>
 void SoftMax<T>::AsyncForward(std::promise<bool> promise)
 {
-    const auto batchSize = ComputableUnit<T>::BatchSize;
-    const auto shape = ForwardOutput.TensorShape;
-    const auto size = shape.Size();
-    const Tensor<T>& inputTensor = ForwardInputMap[m_sourceUnitId];
-
-    if (m_device.Type() == Compute::DeviceType::CPU)
-    {
-#pragma omp parallel for schedule(static)
-        for (long batchIdx = 0; batchIdx < static_cast<long>(batchSize);
-             ++batchIdx)
-        {
-            T sum = static_cast<T>(0);
-            for (std::size_t idx = 0; idx < size; ++idx)
-            {
-                const auto index = batchIdx * size + idx;
-                const auto val = inputTensor.At(index);
-                T toAdd = std::min(static_cast<T>(std::exp(val)),
-                                   std::numeric_limits<T>::max());
-                sum = std::min(sum + toAdd, std::numeric_limits<T>::max());
-            }
-            for (std::size_t idx = 0; idx < size; ++idx)
-            {
-                const auto index = batchIdx * size + idx;
-                const auto val = inputTensor.At(index);
-                ForwardOutput.At(index) =
-                    std::min(static_cast<T>(std::exp(val)),
-                             std::numeric_limits<T>::max()) / sum;
-            }
-        }
-    }
-    else
-    {
-        throw std::runtime_error("Not implemented");
-    }
-
+    Forward();
     promise.set_value(true);
 }
 
@@ -278,8 +231,9 @@ template <typename T>
 void SoftMax<T>::ChangeBatchSize(std::size_t batchSize)
 {
     ComputableUnit<T>::ChangeBatchSize(batchSize);
-    Tensor<T>& backwardTemp = InternalTensorMap.at("backwardTemp");
-    backwardTemp.ChangeBatchSize(batchSize);
+    if (const auto itr = InternalTensorMap.find("backwardTemp");
+        itr != InternalTensorMap.end())
+        itr->second.ChangeBatchSize(batchSize);
 }
 
 template <typename T>
@@ -0,0 +1,288 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_GRAPH_CONV2D_HPP
+#define TAKION_GRAPH_CONV2D_HPP
+
+#include <Takion/Units/HiddenUnits/Conv2DDecl.hpp>
+#include <Takion/Computations/GEMM/MathKernel.hpp>
+#include <unordered_map>
+
+namespace Takion::Graph
+{
+template <typename T>
+Conv2DUnit<T>::Conv2DUnit(
+    const UnitId& unitId, const UnitId& sourceUnitId, Tensor<T> forwardInput,
+    std::unordered_map<UnitId, Tensor<T>> backwardInputMap,
+    Tensor<T> forwardOutput,
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
+    std::unordered_map<std::string, Tensor<T>> internalTensorMap,
+    std::unordered_map<std::string, Tensor<T>> trainableTensorMap,
+    std::unordered_map<std::string, Tensor<T>> gradientTensorMap,
+    std::size_t batchSize, Compute::Conv2DGeometry geometry,
+    Activation activation)
+    : ComputableUnit<T>(unitId, { { sourceUnitId, std::move(forwardInput) } },
+                        std::move(backwardInputMap), forwardOutput,
+                        std::move(backwardOutputMap),
+                        std::move(internalTensorMap), batchSize),
+      TrainableUnit<T>(std::move(trainableTensorMap),
+                       std::move(gradientTensorMap)),
+      m_sourceUnitId(sourceUnitId),
+      m_geometry(geometry),
+      m_activation(activation)
+{
+}
+
+template <typename T>
+Conv2DUnit<T>::Conv2DUnit(Conv2DUnit<T>&& conv2DUnit) noexcept
+    : ComputableUnit<T>(std::move(conv2DUnit)),
+      TrainableUnit<T>(std::move(conv2DUnit)),
+      m_sourceUnitId(std::move(conv2DUnit.m_sourceUnitId)),
+      m_geometry(conv2DUnit.m_geometry),
+      m_activation(conv2DUnit.m_activation)
+{
+}
+
+template <typename T>
+Conv2DUnit<T>& Conv2DUnit<T>::operator=(Conv2DUnit<T>&& conv2DUnit) noexcept
+{
+    ComputableUnit<T>::operator=(std::move(conv2DUnit));
+    TrainableUnit<T>::operator=(std::move(conv2DUnit));
+    m_sourceUnitId = std::move(conv2DUnit.m_sourceUnitId);
+    m_geometry = conv2DUnit.m_geometry;
+    m_activation = conv2DUnit.m_activation;
+
+    return *this;
+}
+
+template <typename T>
+Conv2DUnit<T> Conv2DUnit<T>::CreateUnit(
+    const FrontEnd::UnitMetaData<T>& unitMetaData, Activation activation,
+    bool inferenceOnly)
+{
+    const auto unitId = unitMetaData.Id();
+    auto sourceUnitId = unitMetaData.GetInputUnitId("input");
+    const auto batchSize = unitMetaData.BatchSize();
+    const auto weightShape = unitMetaData.InternalVariableShape("weight");
+    const auto biasShape = unitMetaData.InternalVariableShape("bias");
+    const auto inputShape = unitMetaData.GetInputShape("input");
+    const auto outputShape = unitMetaData.GetOutputShape();
+
+    if constexpr (!std::is_same_v<T, float>)
+        throw std::runtime_error(
+            "Conv2D " + unitId.UnitName +
+            " - convolution is only implemented for float");
+
+    if (inputShape.Dim() != 3)
+        throw std::runtime_error(
+            "Conv2D " + unitId.UnitName +
+            " - input should be (channel, height, width) tensor. "
+            "Given input shape : " +
+            inputShape.ToString());
+
+    const auto& params = unitMetaData.Params;
+    Compute::Conv2DGeometry geometry;
+    geometry.InputChannels = inputShape.At(0);
+    geometry.InputHeight = inputShape.At(1);
+    geometry.InputWidth = inputShape.At(2);
+    geometry.KernelHeight = params.GetIntegerParam("KernelHeight");
+    geometry.KernelWidth = params.GetIntegerParam("KernelWidth");
+    geometry.StrideHeight = params.GetIntegerParam("StrideHeight");
+    geometry.StrideWidth = params.GetIntegerParam("StrideWidth");
+    geometry.PaddingHeight = params.GetIntegerParam("PaddingHeight");
+    geometry.PaddingWidth = params.GetIntegerParam("PaddingWidth");
+    geometry.DilationHeight = params.GetIntegerParam("DilationHeight");
+    geometry.DilationWidth = params.GetIntegerParam("DilationWidth");
+
+    Conv2DUnit<T>::m_checkShape(inputShape, outputShape, weightShape,
+                                biasShape, geometry, unitId.UnitName);
+
+    const auto& weightInitializer = unitMetaData.GetInitializer("weight");
+    const auto& biasInitializer = unitMetaData.GetInitializer("bias");
+
+    Tensor<T> forwardInputTensor(inputShape, batchSize, unitMetaData.Device);
+    Tensor<T> forwardOutputTensor(outputShape, batchSize,
+                                  unitMetaData.Device);
+
+    Tensor<T> weight(weightShape, unitMetaData.Device);
+    Tensor<T> bias(biasShape, unitMetaData.Device);
+
+    weightInitializer->Initialize(weight);
+    biasInitializer->Initialize(bias);
+
+    std::unordered_map<std::string, Tensor<T>> trainableUnitMap = {
+        { "weight", weight },
+        { "bias", bias },
+    };
+
+    //! Row padding of the output is a part of the column matrix, so the
+    //! product is written to the output in its own layout
+    const Shape columnShape(
+        { geometry.PatchSize(),
+          geometry.OutputHeight() * forwardOutputTensor.ColumnElementSize() });
+    Tensor<T> column(columnShape, batchSize, unitMetaData.Device);
+
+    std::unordered_map<UnitId, Tensor<T>> backwardInputMap;
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    std::unordered_map<std::string, Tensor<T>> gradientTensorMap;
+    std::unordered_map<std::string, Tensor<T>> internalTensorMap = {
+        { "column", column },
+    };
+
+    //! Tensors of back propagation are not allocated for inference
+    if (!inferenceOnly)
+    {
+        for (const auto& outputUnitId : unitMetaData.OutputUnitVector())
+        {
+            Tensor<T> tensor(outputShape, batchSize, unitMetaData.Device);
+            backwardInputMap[outputUnitId] = tensor;
+        }
+
+        Tensor<T> backwardOutputTensor(inputShape, batchSize,
+                                       unitMetaData.Device);
+        backwardOutputMap[sourceUnitId] = backwardOutputTensor;
+
+        Tensor<T> delta(outputShape, batchSize, unitMetaData.Device);
+        Tensor<T> columnGradient(columnShape, batchSize, unitMetaData.Device);
+        Tensor<T> weightUpdateMean(weightShape, unitMetaData.Device);
+        Tensor<T> biasUpdateMean(biasShape, unitMetaData.Device);
+
+        internalTensorMap["delta"] = delta;
+        internalTensorMap["columnGradient"] = columnGradient;
+        gradientTensorMap["weight"] = weightUpdateMean;
+        gradientTensorMap["bias"] = biasUpdateMean;
+    }
+
+    if (column.ColumnElementSize() != columnShape.NumCol())
+        throw std::runtime_error("Conv2D " + unitId.UnitName +
+                                 " - column matrix should not be padded");
+
+    return Conv2DUnit<T>(unitId, sourceUnitId, forwardInputTensor,
+                         backwardInputMap, forwardOutputTensor,
+                         backwardOutputMap, internalTensorMap,
+                         trainableUnitMap, gradientTensorMap, batchSize,
+                         geometry, activation);
+}
+
+template <typename T>
+void Conv2DUnit<T>::Forward()
+{
+    const Tensor<T>& input = ForwardInputMap.at(m_sourceUnitId);
+    const Tensor<T>& weight = TrainableTensorMap.at("weight");
+    const Tensor<T>& bias = TrainableTensorMap.at("bias");
+    Tensor<T>& column = InternalTensorMap.at("column");
+
+    Compute::Conv2D(input, weight, bias, column, ForwardOutput, m_geometry,
+                    m_activation);
+}
+
+template <typename T>
+void Conv2DUnit<T>::AsyncForward(std::promise<bool> promise)
+{
+    Forward();
+    promise.set_value(true);
+}
+
+template <typename T>
+void Conv2DUnit<T>::Backward()
+{
+    Tensor<T>& weight = TrainableTensorMap.at("weight");
+    Tensor<T>& weightUpdateMean = GradientTensorMap.at("weight");
+    Tensor<T>& biasUpdateMean = GradientTensorMap.at("bias");
+
+    Tensor<T>& delta = InternalTensorMap.at("delta");
+    Tensor<T>& column = InternalTensorMap.at("column");
+    Tensor<T>& columnGradient = InternalTensorMap.at("columnGradient");
+    Tensor<T>& backwardOutput = BackwardOutputMap.at(m_sourceUnitId);
+
+    const Compute::Zeros<T> zeroInitializer;
+    zeroInitializer.Initialize(delta);
+
+    for (auto& [unitId, gradient] : BackwardInputMap)
+        Compute::Add(gradient, delta);
+
+    Compute::ScalarDiv(delta, static_cast<T>(BackwardInputMap.size()));
+    Compute::ActivationGradient(ForwardOutput, delta, m_activation);
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+        //! Padding of delta is a part of the GEMM inner dimension, and
+        //! gradients of other units may leave values there
+        Compute::CPU::Float::ClearPaddingCpu(
+            delta.Data, BatchSize * delta.TensorShape.At(0) *
+                            m_geometry.OutputHeight(),
+            m_geometry.OutputWidth(), delta.ColumnElementSize());
+
+        Compute::Conv2DInputGradient(delta, weight, columnGradient,
+                                     backwardOutput, m_geometry);
+
+        Compute::Conv2DWeightGradient(delta, column, weightUpdateMean,
+                                      biasUpdateMean, m_geometry);
+    }
+}
+
+template <typename T>
+void Conv2DUnit<T>::AsyncBackward(std::promise<bool> promise)
+{
+    Backward();
+    promise.set_value(true);
+}
+
+template <typename T>
+void Conv2DUnit<T>::ChangeBatchSize(std::size_t batchSize)
+{
+    ComputableUnit<T>::ChangeBatchSize(batchSize);
+    for (const auto& key : { "column", "delta", "columnGradient" })
+        if (const auto itr = InternalTensorMap.find(key);
+            itr != InternalTensorMap.end())
+            itr->second.ChangeBatchSize(batchSize);
+}
+
+template <typename T>
+void Conv2DUnit<T>::m_checkShape(const Shape& inputShape,
+                                 const Shape& outputShape,
+                                 const Shape& weightShape,
+                                 const Shape& biasShape,
+                                 const Compute::Conv2DGeometry& geometry,
+                                 const std::string& unitName)
+{
+    if (geometry.OutputHeight() == 0 || geometry.OutputWidth() == 0)
+    {
+        const std::string errorMessage =
+            std::string("Conv2D ") + unitName +
+            " - kernel does not fit in the padded input. "
+            "Given input shape : " +
+            inputShape.ToString();
+        throw std::runtime_error(errorMessage);
+    }
+
+    if (weightShape.Dim() != 2 || biasShape.Dim() != 1 ||
+        weightShape.NumCol() != geometry.PatchSize() ||
+        weightShape.NumRow() != biasShape.NumCol())
+    {
+        const std::string errorMessage =
+            std::string("Conv2D ") + unitName +
+            " - weight should be (filters x channel * kernel size) tensor "
+            "and bias should have an element for each filter. "
+            "Given weight shape : " +
+            weightShape.ToString() +
+            " Given bias shape : " + biasShape.ToString();
+        throw std::runtime_error(errorMessage);
+    }
+
+    if (outputShape.Dim() != 3 || outputShape.At(0) != weightShape.NumRow() ||
+        outputShape.At(1) != geometry.OutputHeight() ||
+        outputShape.At(2) != geometry.OutputWidth())
+    {
+        const std::string errorMessage =
+            std::string("Conv2D ") + unitName + " - output shape mismatch. " +
+            "Given output shape : " + outputShape.ToString();
+        throw std::runtime_error(errorMessage);
+    }
+}
+} // namespace Takion::Graph
+
+#endif
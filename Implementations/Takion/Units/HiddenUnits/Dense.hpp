@@ -10,6 +10,8 @@
 
 #include <Takion/Units/HiddenUnits/DenseDecl.hpp>
 #include <Takion/Computations/GEMM/MathKernel.hpp>
+#include <algorithm>
+#include <limits>
 #include <unordered_map>
 
 
@@ -19,17 +21,21 @@ template <typename T>
 DenseUnit<T>::DenseUnit(
     const UnitId& unitId, const UnitId& sourceUnitId, Tensor<T> forwardInput,
     std::unordered_map<UnitId, Tensor<T>> backwardInputMap,
-    Tensor<T> forwardOutput, Tensor<T> backwardOutput,
+    Tensor<T> forwardOutput,
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
     std::unordered_map<std::string, Tensor<T>> internalTensorMap,
     std::unordered_map<std::string, Tensor<T>> trainableTensorMap,
-    std::unique_ptr<Compute::Optimizer<T>> optimizer, std::size_t batchSize)
+    std::unordered_map<std::string, Tensor<T>> gradientTensorMap,
+    std::size_t batchSize, Activation activation)
     : ComputableUnit<T>(unitId, { { sourceUnitId, std::move(forwardInput) } },
                         std::move(backwardInputMap), forwardOutput,
-                        { { sourceUnitId, std::move(backwardOutput) } },
+                        std::move(backwardOutputMap),
                         std::move(internalTensorMap),
                         batchSize),
-      TrainableUnit<T>(std::move(trainableTensorMap), std::move(optimizer)),
-      m_sourceUnitId(sourceUnitId)
+      TrainableUnit<T>(std::move(trainableTensorMap),
+                       std::move(gradientTensorMap)),
+      m_sourceUnitId(sourceUnitId),
+      m_activation(activation)
 {
 }
 
@@ -37,7 +43,14 @@ template <typename T>
 DenseUnit<T>::DenseUnit(DenseUnit<T>&& denseUnit) noexcept
     : ComputableUnit<T>(std::move(denseUnit)),
       TrainableUnit<T>(std::move(denseUnit)),
-      m_sourceUnitId(std::move(denseUnit.m_sourceUnitId))
+      m_sourceUnitId(std::move(denseUnit.m_sourceUnitId)),
+      m_activation(denseUnit.m_activation),
+      m_isCalibrating(denseUnit.m_isCalibrating),
+      m_inputMin(denseUnit.m_inputMin),
+      m_inputMax(denseUnit.m_inputMax),
+      m_inputRange(denseUnit.m_inputRange),
+      m_quantizedWeight(std::move(denseUnit.m_quantizedWeight)),
+      m_bFloat16Weight(std::move(denseUnit.m_bFloat16Weight))
 {
 }
 
@@ -47,14 +60,21 @@ DenseUnit<T>& DenseUnit<T>::operator=(DenseUnit<T>&& denseUnit) noexcept
 {
     ComputableUnit<T>::operator=(std::move(denseUnit));
     TrainableUnit<T>::operator=(std::move(denseUnit));
+    m_activation = denseUnit.m_activation;
+    m_isCalibrating = denseUnit.m_isCalibrating;
+    m_inputMin = denseUnit.m_inputMin;
+    m_inputMax = denseUnit.m_inputMax;
+    m_inputRange = denseUnit.m_inputRange;
+    m_quantizedWeight = std::move(denseUnit.m_quantizedWeight);
+    m_bFloat16Weight = std::move(denseUnit.m_bFloat16Weight);
 
     return *this;
 }
 
 template <typename T>
 DenseUnit<T> DenseUnit<T>::CreateUnit(
-    const FrontEnd::UnitMetaData<T>& unitMetaData,
-    std::unique_ptr<Compute::Optimizer<T>> optimizer)
+    const FrontEnd::UnitMetaData<T>& unitMetaData, Activation activation,
+    bool inferenceOnly, Compute::StorageType weightStorage)
 {
     const auto unitId = unitMetaData.Id();
     auto sourceUnitId = unitMetaData.GetInputUnitId("input");
@@ -63,7 +83,6 @@ DenseUnit<T> DenseUnit<T>::CreateUnit(
     const auto biasShape = unitMetaData.InternalVariableShape("bias");
     const auto inputShape = unitMetaData.GetInputShape("input");
     const auto outputShape = unitMetaData.GetOutputShape();
-    const auto weightTransposeShape = weightShape.GetTransposedShape();
 
     DenseUnit<T>::m_checkShape(inputShape, outputShape, weightShape, biasShape,
                                unitId.UnitName);
@@ -75,39 +94,11 @@ DenseUnit<T> DenseUnit<T>::CreateUnit(
                                  unitMetaData.BatchSize(),
                                  unitMetaData.Device);
 
-    std::unordered_map<UnitId, Tensor<T>> backwardInputMap;
-
-    for (const auto& outputUnitId : unitMetaData.OutputUnitVector())
-    {
-        Tensor<T> tensor(unitMetaData.GetOutputShape(),
-                         unitMetaData.BatchSize(),
-                         unitMetaData.Device);
-        backwardInputMap[outputUnitId] = tensor;
-    }
-
     Tensor<T> forwardOutputTensor(outputShape,
                                   batchSize, unitMetaData.Device);
 
-    Tensor<T> backwardOutputTensor(inputShape,
-                                   batchSize,
-                                   unitMetaData.Device);
-
     Tensor<T> weight(weightShape, unitMetaData.Device);
-    Tensor<T> weightTranspose(weightTransposeShape, unitMetaData.Device);
-
-    Tensor<T> weightUpdate(weightShape, batchSize, unitMetaData.Device);
-    Tensor<T> weightUpdateMean(weightShape, unitMetaData.Device);
-
     Tensor<T> bias(biasShape, unitMetaData.Device);
-    Tensor<T> biasUpdateMean(biasShape, unitMetaData.Device);
-
-    Tensor<T> delta(unitMetaData.GetOutputShape(), batchSize,
-                    unitMetaData.Device);
-
-    Tensor<T> previousInputTranspose(
-        inputShape.GetTransposedShape(),
-        unitMetaData.BatchSize(),
-        unitMetaData.Device);
 
     weightInitializer->Initialize(weight);
     biasInitializer->Initialize(bias);
@@ -117,23 +108,63 @@ DenseUnit<T> DenseUnit<T>::CreateUnit(
         { "bias", bias },
     };
 
-    std::unordered_map<std::string, Tensor<T>> internalTensorMap =
+    //! Tensors of back propagation are not allocated for inference
+    std::unordered_map<UnitId, Tensor<T>> backwardInputMap;
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    std::unordered_map<std::string, Tensor<T>> internalTensorMap;
+    std::unordered_map<std::string, Tensor<T>> gradientTensorMap;
+    if (!inferenceOnly)
     {
-        { "weightTranspose", weightTranspose },
-        { "weightUpdate", weightUpdate },
-        { "weightUpdateMean", weightUpdateMean },
-        { "biasUpdateMean", biasUpdateMean },
-        { "delta", delta },
-        { "previousInputTranspose", previousInputTranspose }
-    };
+        for (const auto& outputUnitId : unitMetaData.OutputUnitVector())
+        {
+            Tensor<T> tensor(unitMetaData.GetOutputShape(),
+                             unitMetaData.BatchSize(),
+                             unitMetaData.Device);
+            backwardInputMap[outputUnitId] = tensor;
+        }
+
+        Tensor<T> backwardOutputTensor(inputShape,
+                                       batchSize,
+                                       unitMetaData.Device);
+        backwardOutputMap[sourceUnitId] = backwardOutputTensor;
+
+        Tensor<T> weightUpdateMean(weightShape, unitMetaData.Device);
+        Tensor<T> biasUpdateMean(biasShape, unitMetaData.Device);
+        Tensor<T> delta(unitMetaData.GetOutputShape(), batchSize,
+                        unitMetaData.Device);
+
+        gradientTensorMap = {
+            { "weight", weightUpdateMean },
+            { "bias", biasUpdateMean },
+        };
+        internalTensorMap = {
+            { "delta", delta },
+        };
+    }
 
     auto denseUnit = DenseUnit<T>(
         unitId, sourceUnitId, forwardInputTensor,
         backwardInputMap, forwardOutputTensor,
-        backwardOutputTensor,
+        backwardOutputMap,
         internalTensorMap,
-        trainableUnitMap,
-        std::move(optimizer), batchSize);
+        trainableUnitMap, gradientTensorMap, batchSize, activation);
+
+    if (weightStorage == Compute::StorageType::BFloat16)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            denseUnit.m_bFloat16Weight =
+                std::make_unique<Tensor<Compute::BFloat16>>(
+                    weightShape, unitMetaData.Device);
+            Compute::Convert(weight, *denseUnit.m_bFloat16Weight);
+        }
+        else
+        {
+            throw std::runtime_error(
+                "Dense " + unitId.UnitName +
+                " - only float weights can be stored in bfloat16");
+        }
+    }
 
     return denseUnit;
 }
@@ -146,21 +177,39 @@ void DenseUnit<T>::Forward()
     const Tensor<T>& bias = TrainableTensorMap.at("bias");
     Tensor<T>& output = ForwardOutput;
 
-    Compute::Multiply(input, weight, output);
-    Compute::Add(bias, output, output);
+    if (m_isCalibrating)
+    {
+        const auto [min, max] = Compute::MinMax(input);
+        m_inputMin = std::min(m_inputMin, min);
+        m_inputMax = std::max(m_inputMax, max);
+    }
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+        if (m_quantizedWeight)
+        {
+            Compute::QuantizedMultiplyBiasActivation(
+                input, *m_quantizedWeight, m_inputRange, bias, output,
+                m_activation);
+            return;
+        }
+
+        if (m_bFloat16Weight)
+        {
+            Compute::MultiplyBiasActivation(input, *m_bFloat16Weight, bias,
+                                            output, m_activation);
+            return;
+        }
+    }
+
+    //! Bias and activation are applied in the GEMM epilogue
+    Compute::MultiplyBiasActivation(input, weight, bias, output, m_activation);
 }
 
 template <typename T>
 void DenseUnit<T>::AsyncForward(std::promise<bool> promise)
 {
-    const Tensor<T>& input = ForwardInputMap.at(m_sourceUnitId);
-    const Tensor<T>& weight = TrainableTensorMap.at("weight");
-    const Tensor<T>& bias = TrainableTensorMap.at("bias");
-    Tensor<T>& output = ForwardOutput;
-
-    Compute::Multiply(input, weight, output);
-    Compute::Add(bias, output, output);
-
+    Forward();
     promise.set_value(true);
 }
 
@@ -168,18 +217,11 @@ template <typename T>
 void DenseUnit<T>::Backward()
 {
     Tensor<T>& weight = TrainableTensorMap.at("weight");
-    Tensor<T>& weightTranspose = InternalTensorMap.at("weightTranspose");
-    Tensor<T>& weightUpdate = InternalTensorMap.at("weightUpdate");
-    Tensor<T>& weightUpdateMean = InternalTensorMap.at("weightUpdateMean");
-
-    Tensor<T>& bias = TrainableTensorMap.at("bias");
-    Tensor<T>& biasUpdateMean = InternalTensorMap.at("biasUpdateMean");
+    Tensor<T>& weightUpdateMean = GradientTensorMap.at("weight");
+    Tensor<T>& biasUpdateMean = GradientTensorMap.at("bias");
 
     Tensor<T>& delta = InternalTensorMap.at("delta");
 
-    Tensor<T>& previousInputTranspose =
-        InternalTensorMap.at("previousInputTranspose");
-
     Tensor<T>& previousForwardInput = ForwardInputMap.at(m_sourceUnitId);
     Tensor<T>& backwardOutput = BackwardOutputMap.at(m_sourceUnitId);
 
@@ -201,68 +243,114 @@ void DenseUnit<T>::Backward()
     }
 
     Compute::ScalarDiv(delta, static_cast<T>(BackwardInputMap.size()));
-    Compute::Transpose(weight, weightTranspose);
-    Compute::Multiply(delta, weightTranspose, backwardOutput);
+    Compute::ActivationGradient(ForwardOutput, delta, m_activation);
+
+    //! (batch x output) * (input x output)^T computed as single product
+    if constexpr (std::is_same_v<T, float>)
+    {
+        if (m_bFloat16Weight)
+            Compute::Multiply(delta, *m_bFloat16Weight, backwardOutput,
+                              TransposeOp::NT);
+        else
+            Compute::Multiply(delta, weight, backwardOutput, TransposeOp::NT);
+    }
+    else
+    {
+        Compute::Multiply(delta, weight, backwardOutput, TransposeOp::NT);
+    }
 
-    Compute::Transpose(previousForwardInput, previousInputTranspose);
-    Compute::Multiply(previousInputTranspose, delta, weightUpdate);
+    //! (batch x input)^T * (batch x output) sums gradients of whole batch
+    //! directly into weightUpdateMean, and the mean is taken in the epilogue
+    Compute::MultiplyReduce(previousForwardInput, delta, weightUpdateMean,
+                            TransposeOp::TN,
+                            static_cast<T>(1) / static_cast<T>(BatchSize));
 
-    Compute::Shrink(weightUpdate, weightUpdateMean);
     Compute::Shrink(delta, biasUpdateMean);
-
-    m_optimizer->Optimize(weight, weightUpdateMean);
-    m_optimizer->Optimize(bias, biasUpdateMean);
 }
 
 template <typename T>
 void DenseUnit<T>::AsyncBackward(std::promise<bool> promise)
 {
-    Tensor<T>& weight = TrainableTensorMap.at("weight");
-    Tensor<T>& weightTranspose = InternalTensorMap.at("weightTranspose");
-    Tensor<T>& weightUpdate = InternalTensorMap.at("weightUpdate");
-    Tensor<T>& weightUpdateMean = InternalTensorMap.at("weightUpdateMean");
-
-    Tensor<T>& bias = TrainableTensorMap.at("bias");
-    Tensor<T>& biasUpdateMean = InternalTensorMap.at("biasUpdateMean");
-
-    Tensor<T>& delta = InternalTensorMap.at("delta");
-
-    Tensor<T>& previousInputTranspose =
-        InternalTensorMap.at("previousInputTranspose");
+    Backward();
+    promise.set_value(true);
+}
 
-    Tensor<T>& previousForwardInput = ForwardInputMap.at(m_sourceUnitId);
-    Tensor<T>& backwardOutput = BackwardOutputMap.at(m_sourceUnitId);
+template <typename T>
+void DenseUnit<T>::SyncTrainableTensors()
+{
+    //! Optimizer updates the float weight, and products of the next cycle
+    //! read its rounded copy
+    if constexpr (std::is_same_v<T, float>)
+        if (m_bFloat16Weight)
+            Compute::Convert(TrainableTensorMap.at("weight"),
+                             *m_bFloat16Weight);
+}
 
-    const Compute::Zeros<T> zeroInitializer;
-    zeroInitializer.Initialize(delta);
+template <typename T>
+void DenseUnit<T>::BeginCalibration()
+{
+    m_isCalibrating = true;
+    m_inputMin = std::numeric_limits<T>::max();
+    m_inputMax = std::numeric_limits<T>::lowest();
+}
 
-    for (auto& [unitId, gradient] : BackwardInputMap)
+template <typename T>
+void DenseUnit<T>::Quantize()
+{
+    if constexpr (!std::is_same_v<T, float>)
     {
-        Compute::Add(gradient, delta);
+        throw std::runtime_error("Dense " + this->Id().UnitName +
+                                 " - only float units can be quantized");
     }
+    else
+    {
+        if (!BackwardOutputMap.empty())
+            throw std::runtime_error(
+                "Dense " + this->Id().UnitName +
+                " - only units compiled for inference can be quantized");
+
+        if (!m_isCalibrating || m_inputMin > m_inputMax)
+            throw std::runtime_error(
+                "Dense " + this->Id().UnitName +
+                " - input range should be calibrated before quantization");
+
+        const Tensor<T>& weight = TrainableTensorMap.at("weight");
+        m_quantizedWeight =
+            std::make_unique<Compute::CPU::Int8::QuantizedMatrix>(
+                Compute::CPU::Int8::QuantizeMatrix(
+                    weight.Data, weight.TensorShape.NumRow(),
+                    weight.TensorShape.NumCol(),
+                    weight.ColumnElementSize()));
+        m_inputRange =
+            Compute::CPU::Int8::ComputeInputRange(m_inputMin, m_inputMax);
+        m_isCalibrating = false;
+    }
+}
 
-    Compute::ScalarDiv(delta, static_cast<T>(BackwardInputMap.size()));
-    Compute::Transpose(weight, weightTranspose);
-    Compute::Multiply(delta, weightTranspose, backwardOutput);
-
-    Compute::Transpose(previousForwardInput, previousInputTranspose);
-    Compute::Multiply(previousInputTranspose, delta, weightUpdate);
-
-    Compute::Shrink(weightUpdate, weightUpdateMean);
-    Compute::Shrink(delta, biasUpdateMean);
+template <typename T>
+void DenseUnit<T>::TuneGemm()
+{
+    const Tensor<T>& input = ForwardInputMap.at(m_sourceUnitId);
+    const Tensor<T>& weight = TrainableTensorMap.at("weight");
+    Compute::TuneMultiply(input, weight, ForwardOutput, TransposeOp::NN);
 
-    m_optimizer->Optimize(weight, weightUpdateMean);
-    m_optimizer->Optimize(bias, biasUpdateMean);
+    if (BackwardOutputMap.empty())
+        return;
 
-    promise.set_value(true);
+    const Tensor<T>& delta = InternalTensorMap.at("delta");
+    const Tensor<T>& weightUpdateMean = GradientTensorMap.at("weight");
+    Compute::TuneMultiply(delta, weight, BackwardOutputMap.at(m_sourceUnitId),
+                          TransposeOp::NT);
+    Compute::TuneMultiply(input, delta, weightUpdateMean, TransposeOp::TN);
 }
 
 template <typename T>
 void DenseUnit<T>::ChangeBatchSize(std::size_t batchSize)
 {
     ComputableUnit<T>::ChangeBatchSize(batchSize);
-    Tensor<T>& weightUpdate = InternalTensorMap.at("weightUpdate");
-    weightUpdate.ChangeBatchSize(batchSize);
+    if (const auto itr = InternalTensorMap.find("delta");
+        itr != InternalTensorMap.end())
+        itr->second.ChangeBatchSize(batchSize);
 }
 
 
@@ -19,7 +19,8 @@ CrossEntropy<T>::CrossEntropy(const UnitId& unitId,
                               const UnitId& labelUnitId,
                               Tensor<T> predictionTensor,
                               Tensor<T> labelTensor,
-                              Tensor<T> backwardOutputTensor,
+                              std::unordered_map<UnitId, Tensor<T>>
+                              backwardOutputMap,
                               Tensor<T> outputTensor, Compute::Device device,
                               std::size_t batchSize)
     : ComputableUnit<T>(
@@ -27,7 +28,7 @@ CrossEntropy<T>::CrossEntropy(const UnitId& unitId,
           { { predictionUnitId, predictionTensor },
             { labelUnitId, labelTensor } },
           {}, outputTensor,
-          { { predictionUnitId, backwardOutputTensor } }, {},
+          std::move(backwardOutputMap), {},
           batchSize),
       m_predictionUnitId(predictionUnitId),
       m_labelUnitId(labelUnitId),
@@ -53,7 +54,7 @@ CrossEntropy<T>& CrossEntropy<T>::operator=(CrossEntropy<T>&& lossUnit) noexcept
 
 template <typename T>
 CrossEntropy<T> CrossEntropy<T>::CreateUnit(
-    const FrontEnd::UnitMetaData<T>& unitMetaData)
+    const FrontEnd::UnitMetaData<T>& unitMetaData, bool inferenceOnly)
 
 {
     const auto unitId = unitMetaData.Id();
@@ -70,11 +71,17 @@ CrossEntropy<T> CrossEntropy<T>::CreateUnit(
 
     auto predictionTensor = Tensor<T>(predictionShape, batchSize, device);
     auto labelTensor = Tensor<T>(labelShape, batchSize, device);
-    auto backwardOutputTensor = Tensor<T>(predictionShape, batchSize, device);
     auto outputTensor = Tensor<T>(predictionShape, batchSize, device);
 
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    if (!inferenceOnly)
+    {
+        Tensor<T> backwardOutputTensor(predictionShape, batchSize, device);
+        backwardOutputMap[predictionUnitId] = backwardOutputTensor;
+    }
+
     return CrossEntropy<T>(unitMetaData.Id(), predictionUnitId, labelUnitId,
-                           predictionTensor, labelTensor, backwardOutputTensor,
+                           predictionTensor, labelTensor, backwardOutputMap,
                            outputTensor, device, batchSize);
 }
 
@@ -89,22 +96,11 @@ void CrossEntropy<T>::Forward()
 
     if (m_device.Type() == Compute::DeviceType::CPU)
     {
-        const auto lambda = [](T val)
-        {
-            return static_cast<T>(-std::log(val));
-        };
-
-        Compute::Apply(prediction, ForwardOutput, lambda);
-        Compute::Dot(label, ForwardOutput, ForwardOutput);
-
-        const auto size = ForwardOutput.TensorShape.Size() * batchSize;
-
-        T sum = static_cast<T>(0);
-        for (std::size_t i = 0; i < size; ++i)
-        {
-            const auto output = ForwardOutput.At(i);
-            sum += output;
-        }
+        const auto sum = Compute::MapReduce(
+            [](auto labelValue, auto predictionValue) {
+                return -(labelValue * Compute::Vector::Log(predictionValue));
+            },
+            ForwardOutput, label, prediction);
 
         m_loss = sum / static_cast<T>(batchSize);
     }
@@ -121,22 +117,11 @@ void CrossEntropy<T>::AsyncForward(std::promise<bool> promise)
 
     if (m_device.Type() == Compute::DeviceType::CPU)
     {
-        const auto lambda = [](T val)
-        {
-            return static_cast<T>(-std::log(val));
-        };
-
-        Compute::Apply(prediction, ForwardOutput, lambda);
-        Compute::Dot(label, ForwardOutput, ForwardOutput);
-
-        const auto size = ForwardOutput.TensorShape.Size() * batchSize;
-
-        T sum = static_cast<T>(0);
-        for (std::size_t i = 0; i < size; ++i)
-        {
-            const auto output = ForwardOutput.At(i);
-            sum += output;
-        }
+        const auto sum = Compute::MapReduce(
+            [](auto labelValue, auto predictionValue) {
+                return -(labelValue * Compute::Vector::Log(predictionValue));
+            },
+            ForwardOutput, label, prediction);
 
         m_loss = sum / static_cast<T>(batchSize);
 
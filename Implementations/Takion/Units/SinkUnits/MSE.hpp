@@ -15,7 +15,8 @@ namespace Takion::Graph
 template <typename T>
 MSELoss<T>::MSELoss(const UnitId& unitId, const UnitId& predictionUnitId,
                     const UnitId& labelUnitId, Tensor<T> predictionTensor,
-                    Tensor<T> labelTensor, Tensor<T> backwardOutputTensor,
+                    Tensor<T> labelTensor,
+                    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
                     Tensor<T> outputTensor,
                     std::size_t batchSize)
     : ComputableUnit<T>(
@@ -24,7 +25,7 @@ MSELoss<T>::MSELoss(const UnitId& unitId, const UnitId& predictionUnitId,
             { labelUnitId, labelTensor } },
           {},
           outputTensor,
-          { { predictionUnitId, backwardOutputTensor } },
+          std::move(backwardOutputMap),
           {}, batchSize),
       m_predictionUnitId(predictionUnitId),
       m_labelUnitId(labelUnitId)
@@ -48,7 +49,8 @@ MSELoss<T>& MSELoss<T>::operator=(MSELoss<T>&& lossUnit) noexcept
 }
 
 template <typename T>
-MSELoss<T> MSELoss<T>::CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData)
+MSELoss<T> MSELoss<T>::CreateUnit(
+    const FrontEnd::UnitMetaData<T>& unitMetaData, bool inferenceOnly)
 
 {
     const auto unitId = unitMetaData.Id();
@@ -65,11 +67,17 @@ MSELoss<T> MSELoss<T>::CreateUnit(const FrontEnd::UnitMetaData<T>& unitMetaData)
     auto predictionTensor =
         Tensor<T>(predictionShape, batchSize, device);
     auto labelTensor = Tensor<T>(labelShape, batchSize, device);
-    auto backwardOutputTensor = Tensor<T>(predictionShape, batchSize, device);
     auto outputTensor = Tensor<T>(predictionShape, batchSize, device);
 
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    if (!inferenceOnly)
+    {
+        Tensor<T> backwardOutputTensor(predictionShape, batchSize, device);
+        backwardOutputMap[predictionUnitId] = backwardOutputTensor;
+    }
+
     return MSELoss<T>(unitMetaData.Id(), predictionUnitId, labelUnitId,
-                      predictionTensor, labelTensor, backwardOutputTensor,
+                      predictionTensor, labelTensor, backwardOutputMap,
                       outputTensor,
                       batchSize);
 }
@@ -84,17 +92,12 @@ void MSELoss<T>::Forward()
         ComputableUnit<T>::ForwardInputMap.at(m_labelUnitId);
     Tensor<T>& outputTensor = ForwardOutput;
 
-    Compute::Sub(label, prediction, outputTensor);
-    Compute::Dot(outputTensor, outputTensor);
-    Compute::ScalarDiv(outputTensor, static_cast<T>(2));
-
-    const auto size = ForwardOutput.TensorShape.Size() * batchSize;
-    T sum = static_cast<T>(0);
-    for (std::size_t i = 0; i < size; ++i)
-    {
-        const auto output = outputTensor.At(i);
-        sum += output;
-    }
+    const auto sum = Compute::MapReduce(
+        [](auto labelValue, auto predictionValue) {
+            const auto diff = labelValue - predictionValue;
+            return diff * diff / 2;
+        },
+        outputTensor, label, prediction);
 
     m_loss = sum / static_cast<T>(batchSize);
 }
@@ -109,17 +112,12 @@ void MSELoss<T>::AsyncForward(std::promise<bool> promise)
         ComputableUnit<T>::ForwardInputMap.at(m_labelUnitId);
     Tensor<T>& outputTensor = ForwardOutput;
 
-    Compute::Sub(label, prediction, outputTensor);
-    Compute::Dot(outputTensor, outputTensor);
-    Compute::ScalarDiv(outputTensor, static_cast<T>(2));
-
-    const auto size = ForwardOutput.TensorShape.Size() * batchSize;
-    T sum = static_cast<T>(0);
-    for (std::size_t i = 0; i < size; ++i)
-    {
-        const auto output = outputTensor.At(i);
-        sum += output;
-    }
+    const auto sum = Compute::MapReduce(
+        [](auto labelValue, auto predictionValue) {
+            const auto diff = labelValue - predictionValue;
+            return diff * diff / 2;
+        },
+        outputTensor, label, prediction);
 
     m_loss = sum / static_cast<T>(batchSize);
     std::cout << "Loss : " << m_loss << std::endl;
@@ -0,0 +1,141 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_GRAPH_SOFTMAXCROSSENTROPY_HPP
+#define TAKION_GRAPH_SOFTMAXCROSSENTROPY_HPP
+
+#include <Takion/Computations/GEMM/MathKernel.hpp>
+#include <Takion/Units/SinkUnits/SoftMaxCrossEntropyDecl.hpp>
+
+namespace Takion::Graph
+{
+template <typename T>
+SoftMaxCrossEntropy<T>::SoftMaxCrossEntropy(
+    const UnitId& unitId, const UnitId& predictionUnitId,
+    const UnitId& labelUnitId, Tensor<T> predictionTensor,
+    Tensor<T> labelTensor,
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap,
+    Tensor<T> outputTensor, Compute::Device device, std::size_t batchSize)
+    : ComputableUnit<T>(
+          unitId,
+          { { predictionUnitId, predictionTensor },
+            { labelUnitId, labelTensor } },
+          {}, outputTensor, std::move(backwardOutputMap), {}, batchSize),
+      m_predictionUnitId(predictionUnitId),
+      m_labelUnitId(labelUnitId),
+      m_device(std::move(device))
+{
+}
+
+template <typename T>
+SoftMaxCrossEntropy<T>::SoftMaxCrossEntropy(
+    SoftMaxCrossEntropy<T>&& lossUnit) noexcept
+    : ComputableUnit<T>(std::move(lossUnit)),
+      m_predictionUnitId(std::move(lossUnit.m_predictionUnitId)),
+      m_labelUnitId(std::move(lossUnit.m_labelUnitId)),
+      m_device(std::move(lossUnit.m_device))
+{
+}
+
+template <typename T>
+SoftMaxCrossEntropy<T>& SoftMaxCrossEntropy<T>::operator=(
+    SoftMaxCrossEntropy<T>&& lossUnit) noexcept
+{
+    ComputableUnit<T>::operator=(std::move(lossUnit));
+    m_predictionUnitId = std::move(lossUnit.m_predictionUnitId);
+    m_labelUnitId = std::move(lossUnit.m_labelUnitId);
+    m_device = std::move(lossUnit.m_device);
+    return *this;
+}
+
+template <typename T>
+SoftMaxCrossEntropy<T> SoftMaxCrossEntropy<T>::CreateUnit(
+    const FrontEnd::UnitMetaData<T>& unitMetaData, bool inferenceOnly)
+{
+    const auto unitId = unitMetaData.Id();
+    const auto predictionUnitId = unitMetaData.GetInputUnitId("prediction");
+    const auto labelUnitId = unitMetaData.GetInputUnitId("label");
+
+    const auto predictionShape = unitMetaData.GetInputShape("prediction");
+    const auto labelShape = unitMetaData.GetInputShape("label");
+    const auto batchSize = unitMetaData.BatchSize();
+    const auto device = unitMetaData.Device;
+
+    SoftMaxCrossEntropy<T>::m_checkArguments(predictionShape, labelShape,
+                                             unitId.UnitName);
+
+    auto predictionTensor = Tensor<T>(predictionShape, batchSize, device);
+    auto labelTensor = Tensor<T>(labelShape, batchSize, device);
+    auto outputTensor = Tensor<T>(predictionShape, batchSize, device);
+
+    std::unordered_map<UnitId, Tensor<T>> backwardOutputMap;
+    if (!inferenceOnly)
+    {
+        Tensor<T> backwardOutputTensor(predictionShape, batchSize, device);
+        backwardOutputMap[predictionUnitId] = backwardOutputTensor;
+    }
+
+    return SoftMaxCrossEntropy<T>(unitId, predictionUnitId, labelUnitId,
+                                  predictionTensor, labelTensor,
+                                  backwardOutputMap, outputTensor, device,
+                                  batchSize);
+}
+
+template <typename T>
+void SoftMaxCrossEntropy<T>::Forward()
+{
+    const auto batchSize = ComputableUnit<T>::BatchSize;
+    const Tensor<T>& prediction = ForwardInputMap.at(m_predictionUnitId);
+    const Tensor<T>& label = ForwardInputMap.at(m_labelUnitId);
+
+    const auto loss = Compute::SoftMaxCrossEntropy(prediction, label,
+                                                   ForwardOutput);
+    m_loss = loss / static_cast<T>(batchSize);
+}
+
+template <typename T>
+void SoftMaxCrossEntropy<T>::AsyncForward(std::promise<bool> promise)
+{
+    Forward();
+    promise.set_value(true);
+}
+
+template <typename T>
+void SoftMaxCrossEntropy<T>::Backward()
+{
+    const Tensor<T>& label = ForwardInputMap.at(m_labelUnitId);
+    Tensor<T>& backwardOutput = BackwardOutputMap.at(m_predictionUnitId);
+
+    Compute::SoftMaxCrossEntropyGradient(ForwardOutput, label,
+                                         backwardOutput);
+}
+
+template <typename T>
+void SoftMaxCrossEntropy<T>::AsyncBackward(std::promise<bool> promise)
+{
+    Backward();
+    promise.set_value(true);
+}
+
+template <typename T>
+void SoftMaxCrossEntropy<T>::m_checkArguments(const Shape& predictionShape,
+                                              const Shape& labelShape,
+                                              const std::string& unitName)
+{
+    if (predictionShape != labelShape)
+    {
+        const std::string errorMessage =
+            std::string("SoftMaxCrossEntropy ") + unitName +
+            " - prediction and label shape mismatch. " +
+            "prediction : " + predictionShape.ToString() +
+            " label : " + labelShape.ToString();
+
+        throw std::runtime_error(errorMessage);
+    }
+}
+}
+
+#endif
@@ -42,42 +42,13 @@ PlaceHolder<T> PlaceHolder<T>::CreateUnit(
 template <typename T>
 void PlaceHolder<T>::Forward()
 {
-    auto vector = (*m_loader)();
-    if (vector.size() !=
-        ForwardOutput.TensorShape.Size() * ForwardOutput.BatchSize)
-    {
-        const std::string errorMessage =
-            std::string("Loaded vector mismatches expected size ") +
-            "Given size including batch: " + std::to_string(
-                vector.size() * ForwardOutput.BatchSize) +
-            " Expected size : " +
-            std::to_string(ForwardOutput.TensorShape.Size());
-        throw std::runtime_error(errorMessage);
-    }
-
-    Compute::VectorInitializer<T> initializer(std::move(vector));
-    initializer.Initialize(ForwardOutput);
+    m_initialize(m_load());
 }
 
 template <typename T>
 void PlaceHolder<T>::AsyncForward(std::promise<bool> promise)
 {
-    auto vector = (*m_loader)();
-    if (vector.size() !=
-        ForwardOutput.TensorShape.Size() * ForwardOutput.BatchSize)
-    {
-        const std::string errorMessage =
-            std::string("Loaded vector mismatches expected size ") +
-            "Given size including batch: " +
-            std::to_string(vector.size() * ForwardOutput.BatchSize) +
-            " Expected size : " +
-            std::to_string(ForwardOutput.TensorShape.Size());
-        throw std::runtime_error(errorMessage);
-    }
-
-    Compute::VectorInitializer<T> initializer(std::move(vector));
-    initializer.Initialize(ForwardOutput);
-
+    m_initialize(m_load());
     promise.set_value(true);
 }
 
@@ -93,6 +64,65 @@ void PlaceHolder<T>::AsyncBackward(std::promise<bool> promise)
     // Do nothing
     promise.set_value(true);
 }
+
+template <typename T>
+void PlaceHolder<T>::Prefetch(std::size_t depth)
+{
+    auto* loader = m_loader.get();
+    while (m_prefetchQueue.size() < depth)
+    {
+        //! Loaders are stateful, so each load waits for the previous one to
+        //! keep the order of cycles
+        std::shared_future<std::vector<T>> previous;
+        if (!m_prefetchQueue.empty())
+            previous = m_prefetchQueue.back();
+
+        m_prefetchQueue.emplace_back(
+            std::async(std::launch::async, [loader, previous]() {
+                if (previous.valid())
+                    previous.wait();
+                return (*loader)();
+            }));
+    }
+}
+
+template <typename T>
+void PlaceHolder<T>::DiscardPrefetch()
+{
+    for (auto& future : m_prefetchQueue)
+        future.wait();
+    m_prefetchQueue.clear();
+}
+
+template <typename T>
+std::vector<T> PlaceHolder<T>::m_load()
+{
+    if (m_prefetchQueue.empty())
+        return (*m_loader)();
+
+    auto future = std::move(m_prefetchQueue.front());
+    m_prefetchQueue.pop_front();
+    return future.get();
+}
+
+template <typename T>
+void PlaceHolder<T>::m_initialize(std::vector<T> vector)
+{
+    if (vector.size() !=
+        ForwardOutput.TensorShape.Size() * ForwardOutput.BatchSize)
+    {
+        const std::string errorMessage =
+            std::string("Loaded vector mismatches expected size ") +
+            "Given size including batch: " + std::to_string(
+                vector.size() * ForwardOutput.BatchSize) +
+            " Expected size : " +
+            std::to_string(ForwardOutput.TensorShape.Size());
+        throw std::runtime_error(errorMessage);
+    }
+
+    Compute::VectorInitializer<T> initializer(std::move(vector));
+    initializer.Initialize(ForwardOutput);
+}
 }
 
 #endif
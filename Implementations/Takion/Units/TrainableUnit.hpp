@@ -14,9 +14,9 @@ namespace Takion::Graph
 template <typename T>
 TrainableUnit<T>::TrainableUnit(
     std::unordered_map<std::string, Tensor<T>> trainableTensorMap,
-    std::unique_ptr<Compute::Optimizer<T>> optimizer)
+    std::unordered_map<std::string, Tensor<T>> gradientTensorMap)
     : TrainableTensorMap(std::move(trainableTensorMap)),
-      m_optimizer(std::move(optimizer))
+      GradientTensorMap(std::move(gradientTensorMap))
 {
 }
 
@@ -32,7 +32,8 @@ TrainableUnit<T>& TrainableUnit<T>::operator=(TrainableUnit<T>&& trainableUnit)
 noexcept
 {
     TrainableTensorMap = std::move(trainableUnit.TrainableTensorMap);
-    m_optimizer = std::move(trainableUnit.m_optimizer);
+    GradientTensorMap = std::move(trainableUnit.GradientTensorMap);
+    OptimizerStateMap = std::move(trainableUnit.OptimizerStateMap);
 
     return *this;
 }
@@ -15,15 +15,30 @@ Device::Device(int id, DeviceType type, std::string name)
       m_name(std::move(name))
 {
     if (type == DeviceType::CPU)
-        m_padByteSize = 32;
+        SetInstructionSet(GetNativeInstructionSet());
     else if (type == DeviceType::GPU)
         m_padByteSize = 1;
 }
 
+void Device::SetInstructionSet(Compute::InstructionSet instructionSet)
+{
+    if (m_type != DeviceType::CPU)
+        throw std::invalid_argument(
+            "Instruction set can be only set for CPU device");
+    if (!IsSupported(instructionSet))
+        throw std::invalid_argument(
+            "Instruction set " + ToString(instructionSet) +
+            " is not supported on this machine");
+
+    m_instructionSet = instructionSet;
+    m_padByteSize = VectorByteSize(instructionSet);
+}
+
 bool Device::operator==(const Device& device) const
 {
     return m_id == device.m_id && m_type == device.m_type &&
-           m_name == device.m_name && m_padByteSize == device.m_padByteSize;
+           m_name == device.m_name && m_padByteSize == device.m_padByteSize &&
+           m_instructionSet == device.m_instructionSet;
 }
 
 bool Device::operator!=(const Device& device) const
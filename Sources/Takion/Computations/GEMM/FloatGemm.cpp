@@ -5,79 +5,928 @@
 // property of any third parties.
 
 #include <Takion/Computations/GEMM/FloatGemm.hpp>
+#include <Takion/Computations/GEMM/MicroKernel.hpp>
+#include <Takion/Computations/Vector/Transpose.hpp>
+#include <Takion/Computations/Vector/VectorMath.hpp>
 #include <Takion/Utils/Span.hpp>
 #include <immintrin.h>
 #include <xmmintrin.h>
+#include <omp.h>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace Takion::Compute::CPU::Float
 {
 using namespace Util;
 
-void MultiplyCpu(const Span<float> inputA, const Span<float> inputB,
-                 Span<float> out, std::size_t numRowA,
-                 std::size_t numColA, std::size_t numRowB,
-                 std::size_t numColB, std::size_t numMatrices)
+namespace
 {
-    const auto jb = std::min(static_cast<std::size_t>(512), numColB);
-    const auto kb = std::min(static_cast<std::size_t>(24), numRowB);
-    const auto sizeA = numRowA * numColA;
-    const auto sizeB = numRowB * numColB;
-    const auto sizeDest = numRowA * numColB;
+//! Register tile computed by the AVX2 micro kernel
+//! 6 x 16 tile keeps 12 accumulators + 2 B vectors + 1 broadcast A in the
+//! 16 ymm registers available on AVX2
+constexpr std::size_t MR = 6;
+constexpr std::size_t NR = 16;
 
-#pragma omp parallel for schedule(static) default(shared)
-    for (long matIdx = 0; static_cast<std::size_t>(matIdx) < numMatrices;
-         ++matIdx)
+//! Largest register tile of every micro kernel
+constexpr std::size_t MaxTileSize = 12 * 32;
+
+//! Tuned blockings replace a default only if they are faster by this ratio,
+//! so timing noise does not move shapes away from the defaults
+constexpr double TuningThreshold = 0.97;
+
+//! Aligned scratch buffer used for packing panels
+//! Grows on demand and is reused between calls on the same thread
+class PackBuffer
+{
+public:
+    PackBuffer() = default;
+
+    ~PackBuffer()
+    {
+        m_span.Clear();
+    }
+
+    PackBuffer(const PackBuffer& buffer) = delete;
+    PackBuffer& operator=(const PackBuffer& buffer) = delete;
+
+    float* Get(std::size_t size)
+    {
+        if (m_span.Length() < size)
+        {
+            m_span.Clear();
+            //! aligned_alloc requires size to be multiple of the alignment
+            const auto byteSize = (sizeof(float) * size + 63) / 64 * 64;
+#ifdef _MSC_VER
+            auto* ptr = static_cast<float*>(_aligned_malloc(byteSize, 64));
+#else
+            auto* ptr = static_cast<float*>(aligned_alloc(64, byteSize));
+#endif
+            if (ptr == nullptr)
+                throw std::runtime_error("Failed to allocate packing buffer");
+            m_span = Span<float>(ptr, size);
+        }
+        return m_span.Begin();
+    }
+
+private:
+    Span<float> m_span;
+};
+
+//! Packs mr rows of mc x kc block of op(A) into a row panel
+//! Block starts at (rowOffset, kOffset) of op(A)
+//! Panel is stored column by column (mr consecutive elements per k)
+//! Rows beyond mc are padded with zeros
+void PackA(const float* A, std::size_t lda, bool transA, std::size_t rowOffset,
+           std::size_t kOffset, std::size_t mc, std::size_t kc, float* packed,
+           std::size_t panelIdx, std::size_t mr)
+{
+    const auto rowBegin = rowOffset + panelIdx * mr;
+    const auto numRows = std::min(mr, mc - panelIdx * mr);
+    float* dest = packed + panelIdx * mr * kc;
+
+    if (transA)
+    {
+        for (std::size_t k = 0; k < kc; ++k)
+        {
+            const float* src = A + (kOffset + k) * lda + rowBegin;
+            std::size_t r = 0;
+            for (; r < numRows; ++r)
+                dest[k * mr + r] = src[r];
+            for (; r < mr; ++r)
+                dest[k * mr + r] = 0.0f;
+        }
+        return;
+    }
+
+    for (std::size_t k = 0; k < kc; ++k)
+    {
+        std::size_t r = 0;
+        for (; r < numRows; ++r)
+            dest[k * mr + r] = A[(rowBegin + r) * lda + kOffset + k];
+        for (; r < mr; ++r)
+            dest[k * mr + r] = 0.0f;
+    }
+}
+
+//! Loads 8 consecutive elements of B as float
+__m256 LoadFloat(const float* source)
+{
+    return _mm256_loadu_ps(source);
+}
+
+__m256 LoadFloat(const BFloat16* source)
+{
+    //! bfloat16 is the upper half of float
+    const auto bits = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16));
+}
+
+//! Rounds 8 floats to bfloat16 (see BFloat16::Round)
+__m128i RoundToBFloat16(__m256 value)
+{
+    const auto bits = _mm256_castps_si256(value);
+    const auto lsb =
+        _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    const auto rounded = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(0x7fff)),
+                         lsb),
+        16);
+    const auto quietNan = _mm256_or_si256(_mm256_srli_epi32(bits, 16),
+                                          _mm256_set1_epi32(0x40));
+    const auto isNan = _mm256_castps_si256(
+        _mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+    const auto result = _mm256_blendv_epi8(rounded, quietNan, isNan);
+
+    //! Packs within 128 bit lanes, then gathers lower halves of both lanes
+    const auto packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(result, result), 0x08);
+    return _mm256_castsi256_si128(packed);
+}
+
+//! Packs nr columns of kc x nc panel of op(B) into a column panel
+//! Panel starts at (kOffset, colOffset) of op(B)
+//! Panel is stored row by row (nr consecutive elements per k)
+//! Columns beyond nc are padded with zeros
+//! B may be stored in float or bfloat16, and is packed as float
+template <typename TB>
+void PackB(const TB* B, std::size_t ldb, bool transB, std::size_t kOffset,
+           std::size_t colOffset, std::size_t kc, std::size_t nc,
+           float* packed, std::size_t panelIdx, std::size_t nr)
+{
+    const auto colBegin = colOffset + panelIdx * nr;
+    const auto numCols = std::min(nr, nc - panelIdx * nr);
+    float* dest = packed + panelIdx * nr * kc;
+
+    if (transB)
+    {
+        std::size_t c = 0;
+        for (; c < numCols; ++c)
+        {
+            const TB* src = B + (colBegin + c) * ldb + kOffset;
+            for (std::size_t k = 0; k < kc; ++k)
+                dest[k * nr + c] = static_cast<float>(src[k]);
+        }
+        for (; c < nr; ++c)
+            for (std::size_t k = 0; k < kc; ++k)
+                dest[k * nr + c] = 0.0f;
+        return;
+    }
+
+    if (numCols == nr)
+    {
+        for (std::size_t k = 0; k < kc; ++k)
+        {
+            const TB* src = B + (kOffset + k) * ldb + colBegin;
+            for (std::size_t c = 0; c < nr; c += 8)
+                _mm256_store_ps(dest + k * nr + c, LoadFloat(src + c));
+        }
+        return;
+    }
+
+    for (std::size_t k = 0; k < kc; ++k)
+    {
+        const TB* src = B + (kOffset + k) * ldb + colBegin;
+        std::size_t c = 0;
+        for (; c < numCols; ++c)
+            dest[k * nr + c] = static_cast<float>(src[c]);
+        for (; c < nr; ++c)
+            dest[k * nr + c] = 0.0f;
+    }
+}
+
+//! Operations applied to a tile of C once its last k-block is accumulated
+//! Tile is multiplied by Scale, and bias (if given) is added to every row
+//! before the activation is applied
+struct Epilogue
+{
+    const float* Bias = nullptr;
+    Activation ActivationType = Activation::Linear;
+    float Scale = 1.0f;
+
+    [[nodiscard]] bool Empty() const
+    {
+        return Bias == nullptr && ActivationType == Activation::Linear &&
+               Scale == 1.0f;
+    }
+};
+
+//! Epilogue adding bias to every row before applying activation
+//! Only activations which ApplyActivation computes are supported
+Epilogue MakeEpilogue(const Span<float>& bias, Activation activation)
+{
+    if (activation != Activation::Linear &&
+        activation != Activation::Relu && activation != Activation::Sigmoid)
+        throw std::invalid_argument(
+            "Unsupported activation for fused GEMM epilogue");
+
+    Epilogue epilogue;
+    epilogue.Bias = bias.Base();
+    epilogue.ActivationType = activation;
+    return epilogue;
+}
+
+float ApplyActivation(float value, Activation activation)
+{
+    switch (activation)
+    {
+        case Activation::Relu:
+            return value > 0.0f ? value : 0.1f * value;
+        case Activation::Sigmoid:
+            return 1.0f / (1.0f + std::exp(-value));
+        default:
+            return value;
+    }
+}
+
+__m256 ApplyActivation(__m256 value, Activation activation)
+{
+    switch (activation)
+    {
+        case Activation::Relu:
+        {
+            //! Leaky ReLU identical to Graph::ReLU (0.1 slope below zero)
+            const auto isPositive =
+                _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_GT_OQ);
+            return _mm256_blendv_ps(
+                _mm256_mul_ps(value, _mm256_set1_ps(0.1f)), value, isPositive);
+        }
+        case Activation::Sigmoid:
+            return Vector::Sigmoid(value);
+        default:
+            return value;
+    }
+}
+
+//! Computes MR x NR tile of packed A * packed B using AVX2 and FMA
+void ComputeTileAvx2(std::size_t kc, const float* packedA,
+                     const float* packedB, float* tile)
+{
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (std::size_t k = 0; k < kc; ++k)
+    {
+        const auto b0 = _mm256_load_ps(packedB);
+        const auto b1 = _mm256_load_ps(packedB + 8);
+
+        auto a = _mm256_broadcast_ss(packedA);
+        c00 = _mm256_fmadd_ps(a, b0, c00);
+        c01 = _mm256_fmadd_ps(a, b1, c01);
+        a = _mm256_broadcast_ss(packedA + 1);
+        c10 = _mm256_fmadd_ps(a, b0, c10);
+        c11 = _mm256_fmadd_ps(a, b1, c11);
+        a = _mm256_broadcast_ss(packedA + 2);
+        c20 = _mm256_fmadd_ps(a, b0, c20);
+        c21 = _mm256_fmadd_ps(a, b1, c21);
+        a = _mm256_broadcast_ss(packedA + 3);
+        c30 = _mm256_fmadd_ps(a, b0, c30);
+        c31 = _mm256_fmadd_ps(a, b1, c31);
+        a = _mm256_broadcast_ss(packedA + 4);
+        c40 = _mm256_fmadd_ps(a, b0, c40);
+        c41 = _mm256_fmadd_ps(a, b1, c41);
+        a = _mm256_broadcast_ss(packedA + 5);
+        c50 = _mm256_fmadd_ps(a, b0, c50);
+        c51 = _mm256_fmadd_ps(a, b1, c51);
+
+        packedA += MR;
+        packedB += NR;
+    }
+
+    _mm256_store_ps(tile + 0 * NR, c00);
+    _mm256_store_ps(tile + 0 * NR + 8, c01);
+    _mm256_store_ps(tile + 1 * NR, c10);
+    _mm256_store_ps(tile + 1 * NR + 8, c11);
+    _mm256_store_ps(tile + 2 * NR, c20);
+    _mm256_store_ps(tile + 2 * NR + 8, c21);
+    _mm256_store_ps(tile + 3 * NR, c30);
+    _mm256_store_ps(tile + 3 * NR + 8, c31);
+    _mm256_store_ps(tile + 4 * NR, c40);
+    _mm256_store_ps(tile + 4 * NR + 8, c41);
+    _mm256_store_ps(tile + 5 * NR, c50);
+    _mm256_store_ps(tile + 5 * NR + 8, c51);
+}
+
+//! Writes mr x nr part of the tile (rows nrTile elements apart) back to C
+//! Result is added to C if accumulate is true, otherwise C is overwritten
+//! Epilogue is applied while the tile is written back, so bias and activation
+//! do not need separate passes over C
+void StoreTile(const float* tile, std::size_t nrTile, float* C,
+               std::size_t ldc, std::size_t mr, std::size_t nr,
+               bool accumulate, const Epilogue& epilogue)
+{
+    const auto hasEpilogue = !epilogue.Empty();
+
+    for (std::size_t r = 0; r < mr; ++r)
+    {
+        const float* src = tile + r * nrTile;
+        float* dest = C + r * ldc;
+
+        std::size_t c = 0;
+        for (; c + 8 <= nr; c += 8)
+        {
+            auto value = _mm256_load_ps(src + c);
+            if (accumulate)
+                value = _mm256_add_ps(value, _mm256_loadu_ps(dest + c));
+            if (hasEpilogue)
+            {
+                const auto bias = epilogue.Bias
+                                      ? _mm256_loadu_ps(epilogue.Bias + c)
+                                      : _mm256_setzero_ps();
+                value = ApplyActivation(
+                    _mm256_fmadd_ps(value, _mm256_set1_ps(epilogue.Scale),
+                                    bias),
+                    epilogue.ActivationType);
+            }
+            _mm256_storeu_ps(dest + c, value);
+        }
+
+        for (; c < nr; ++c)
+        {
+            auto value = src[c];
+            if (accumulate)
+                value += dest[c];
+            if (hasEpilogue)
+                value = ApplyActivation(
+                    value * epilogue.Scale +
+                        (epilogue.Bias ? epilogue.Bias[c] : 0.0f),
+                    epilogue.ActivationType);
+            dest[c] = value;
+        }
+    }
+}
+
+//! Micro kernel of the instruction set
+//! Kernels are looked up once, so the dispatch costs single branch per GEMM
+const MicroKernel& GetMicroKernel(InstructionSet instructionSet)
+{
+    static const MicroKernel avx2Kernel = GetAvx2MicroKernel();
+    static const MicroKernel avx512Kernel = GetAvx512MicroKernel();
+
+    //! Float GEMM has no use of VNNI, so it runs on the AVX512 kernel
+    return instructionSet == InstructionSet::AVX2 ? avx2Kernel
+                                                  : avx512Kernel;
+}
+
+//! Blocking of the shape, which is the default blocking unless the shape
+//! class was tuned with blocking the kernel supports
+GemmBlocking SelectBlocking(std::size_t m, std::size_t n, std::size_t k,
+                            std::size_t numMatrices, TransposeOp op,
+                            InstructionSet instructionSet)
+{
+    const auto& kernel = GetMicroKernel(instructionSet);
+    const auto blocking = GetGemmBlocking(
+        ClassifyGemm(m, n, k, numMatrices, op, instructionSet), numMatrices);
+    if (blocking.MC % kernel.MR != 0 || blocking.NC % kernel.NR != 0)
+        return DefaultGemmBlocking(numMatrices);
+    return blocking;
+}
+
+//! Computes C = op(A) * op(B) for single (m x k) * (k x n) matrix product
+//! lda, ldb and ldc are row strides of A, B and C as they are stored
+//! Work is shared between OpenMP threads if parallel is true
+//! Product is added to C if accumulateC is true, otherwise C is overwritten
+//! Epilogue is applied to each tile when its last k-block is written back
+//! KC x NR micro panel of B stays in L1, MC x KC block of packed A in L2 and
+//! KC x NC panel of packed B in L3 with the default blocking
+template <typename TB>
+void Gemm(const float* A, std::size_t lda, bool transA, const TB* B,
+          std::size_t ldb, bool transB, float* C, std::size_t ldc,
+          std::size_t m, std::size_t n, std::size_t k, bool parallel,
+          const Epilogue& epilogue, const MicroKernel& kernel,
+          const GemmBlocking& blocking, bool accumulateC = false)
+{
+    const auto MC = blocking.MC;
+    const auto KC = blocking.KC;
+    const auto NC = blocking.NC;
+
+    if (k == 0)
     {
-        const auto matOffsetA = sizeA * matIdx;
-        const auto matOffsetB = sizeB * matIdx;
-        const auto matOffsetDest = sizeDest * matIdx;
-        for (std::size_t jj = 0; jj < numColB; jj += jb)
+        for (std::size_t i = 0; i < m; ++i)
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                const auto value = accumulateC ? C[i * ldc + j] : 0.0f;
+                C[i * ldc + j] =
+                    epilogue.Empty()
+                        ? value
+                        : ApplyActivation(
+                              value * epilogue.Scale +
+                                  (epilogue.Bias ? epilogue.Bias[j] : 0.0f),
+                              epilogue.ActivationType);
+            }
+        return;
+    }
+
+    thread_local PackBuffer bufferA;
+    thread_local PackBuffer bufferB;
+
+    const auto mr = kernel.MR;
+    const auto nr = kernel.NR;
+    const auto mcMax = std::min(MC, (m + mr - 1) / mr * mr);
+    const auto ncMax = std::min(NC, (n + nr - 1) / nr * nr);
+    const auto kcMax = std::min(KC, k);
+    float* packedA = bufferA.Get(mcMax * kcMax);
+    float* packedB = bufferB.Get(kcMax * ncMax);
+
+#pragma omp parallel default(shared) if (parallel)
+    {
+        for (std::size_t jc = 0; jc < n; jc += NC)
         {
-            for (std::size_t kk = 0; kk < numRowB; kk += kb)
+            const auto nc = std::min(NC, n - jc);
+            const auto numPanelsB = (nc + nr - 1) / nr;
+
+            for (std::size_t pc = 0; pc < k; pc += KC)
             {
-                for (std::size_t i = 0; i < numRowA; i += 1)
+                const auto kc = std::min(KC, k - pc);
+                const auto accumulate = accumulateC || pc > 0;
+                const auto isLastBlock = pc + kc == k;
+
+#pragma omp for schedule(static)
+                for (long panelIdx = 0;
+                     panelIdx < static_cast<long>(numPanelsB); ++panelIdx)
+                    PackB(B, ldb, transB, pc, jc, kc, nc, packedB,
+                          static_cast<std::size_t>(panelIdx), nr);
+
+                for (std::size_t ic = 0; ic < m; ic += MC)
                 {
-                    for (std::size_t j = jj; j < std::min(jj + jb, numColB);
-                         j += 8)
+                    const auto mc = std::min(MC, m - ic);
+                    const auto numPanelsA = (mc + mr - 1) / mr;
+
+#pragma omp for schedule(static)
+                    for (long panelIdx = 0;
+                         panelIdx < static_cast<long>(numPanelsA); ++panelIdx)
+                        PackA(A, lda, transA, ic, pc, mc, kc, packedA,
+                              static_cast<std::size_t>(panelIdx), mr);
+
+                    const auto numTiles = numPanelsA * numPanelsB;
+#pragma omp for schedule(static)
+                    for (long tileIdx = 0;
+                         tileIdx < static_cast<long>(numTiles); ++tileIdx)
                     {
-                        __m256 sum;
-                        if (kk == 0)
-                            sum = _mm256_setzero_ps();
-                        else
-                        {
-                            sum = _mm256_load_ps(static_cast<float const*>(
-                                &out[matOffsetDest + i * numColB + j]));
-                        }
-                        const auto limit = std::min(
-                            static_cast<std::size_t>(numRowB), kk + kb);
-                        for (std::size_t k = kk; k < limit; k++)
+                        const auto jr = (static_cast<std::size_t>(tileIdx) /
+                                         numPanelsA) * nr;
+                        const auto ir = (static_cast<std::size_t>(tileIdx) %
+                                         numPanelsA) * mr;
+
+                        Epilogue tileEpilogue;
+                        if (isLastBlock)
                         {
-                            const auto input_a_offset =
-                                matOffsetA + i * numColA + k;
-                            const auto input_b_offset =
-                                matOffsetB + k * numColB + j;
-
-                            const auto bc_mat1_1 =
-                                _mm256_set1_ps(inputA[input_a_offset]);
-                            const auto vecA_mat2 =
-                                _mm256_load_ps(static_cast<float const*>(
-                                    &inputB[input_b_offset]));
-
-                            sum = _mm256_add_ps(
-                                sum, _mm256_mul_ps(bc_mat1_1, vecA_mat2));
+                            tileEpilogue.ActivationType =
+                                epilogue.ActivationType;
+                            tileEpilogue.Bias = epilogue.Bias
+                                                    ? epilogue.Bias + jc + jr
+                                                    : nullptr;
+                            tileEpilogue.Scale = epilogue.Scale;
                         }
-                        _mm256_store_ps(
-                            static_cast<float*>(
-                                &out[matOffsetDest + i * numColB + j]),
-                            sum);
+
+                        alignas(64) float tile[MaxTileSize];
+                        kernel.ComputeTile(kc, packedA + ir * kc,
+                                           packedB + jr * kc, tile);
+                        StoreTile(tile, nr, C + (ic + ir) * ldc + jc + jr,
+                                  ldc, std::min(mr, mc - ir),
+                                  std::min(nr, nc - jr), accumulate,
+                                  tileEpilogue);
                     }
                 }
             }
         }
     }
 }
+//! Computes batch of products described by GemmCpu
+template <typename TB>
+void BatchedGemm(const Span<float> inputA, const Span<TB> inputB,
+                 Span<float> out, std::size_t m, std::size_t n, std::size_t k,
+                 std::size_t lda, std::size_t ldb, std::size_t ldc,
+                 std::size_t strideA, std::size_t strideB,
+                 std::size_t numMatrices, TransposeOp op,
+                 const Epilogue& epilogue, InstructionSet instructionSet,
+                 const GemmBlocking& blocking)
+{
+    const auto& kernel = GetMicroKernel(instructionSet);
+    const auto transA = op == TransposeOp::TN;
+    const auto transB = op == TransposeOp::NT;
+    const auto strideOut = m * ldc;
+
+    //! Matrices of A and out are contiguous when B is broadcasted,
+    //! so batch of products is computed as single matrix product whose rows
+    //! are stacked along the batch. This reuses packed panels of B between
+    //! all rows instead of computing small product for each matrix
+    if (numMatrices > 1 && strideB == 0 && !transA && strideA == m * lda)
+    {
+        Gemm(inputA.Base(), lda, false, inputB.Base(), ldb, transB,
+             out.Begin(), ldc, m * numMatrices, n, k, true, epilogue, kernel,
+             blocking);
+        return;
+    }
+
+    //! Independent matrices are distributed between threads if the blocking
+    //! says so, otherwise each product is computed in parallel
+    if (blocking.ParallelOverMatrices)
+    {
+#pragma omp parallel for schedule(static) default(shared)
+        for (long matIdx = 0; matIdx < static_cast<long>(numMatrices);
+             ++matIdx)
+        {
+            Gemm(inputA.Base() + strideA * matIdx, lda, transA,
+                 inputB.Base() + strideB * matIdx, ldb, transB,
+                 out.Address(strideOut * matIdx), ldc, m, n, k, false,
+                 epilogue, kernel, blocking);
+        }
+        return;
+    }
+
+    for (std::size_t matIdx = 0; matIdx < numMatrices; ++matIdx)
+    {
+        Gemm(inputA.Base() + strideA * matIdx, lda, transA,
+             inputB.Base() + strideB * matIdx, ldb, transB,
+             out.Address(strideOut * matIdx), ldc, m, n, k, true,
+             epilogue, kernel, blocking);
+    }
+}
+
+//! Applies vectorFunction to groups of 8 elements and scalarFunction to the
+//! remaining tail
+template <typename VectorFunction, typename ScalarFunction>
+void ApplyCpu(const Span<float> input, Span<float> out, std::size_t size,
+              VectorFunction vectorFunction, ScalarFunction scalarFunction)
+{
+    const auto numVectors = static_cast<long>(size / 8);
+#pragma omp parallel for schedule(static) default(shared)
+    for (long vecIdx = 0; vecIdx < numVectors; ++vecIdx)
+        _mm256_storeu_ps(
+            out.Address(vecIdx * 8),
+            vectorFunction(_mm256_loadu_ps(input.Address(vecIdx * 8))));
+
+    const auto vecEnd = size - size % 8;
+
+    for (auto i = vecEnd; i < size; ++i)
+        out[i] = scalarFunction(input[i]);
+}
+
+//! Side of square tiles TransposeCpu processes at once
+//! 64 x 64 tile of input and output (32KB in total) stays in L1 and L2
+constexpr std::size_t TransposeTile = 64;
+
+//! Number of columns ShrinkCpu reduces in single task (16KB per row), so
+//! the block of partial sums stays in L1 while rows of the batch stream in
+constexpr std::size_t ShrinkColumnBlock = 4096;
+
+//! Number of batches summed serially in deterministic mode of ShrinkCpu
+constexpr std::size_t ShrinkBatchChunk = 32;
+
+//! Adds columns [colBegin, colEnd) of row to out
+void AddRow(const float* row, float* out, std::size_t colBegin,
+            std::size_t colEnd)
+{
+    auto colIdx = colBegin;
+    for (; colIdx + 8 <= colEnd; colIdx += 8)
+        _mm256_storeu_ps(out + colIdx,
+                         _mm256_add_ps(_mm256_loadu_ps(out + colIdx),
+                                       _mm256_loadu_ps(row + colIdx)));
+    for (; colIdx < colEnd; ++colIdx)
+        out[colIdx] += row[colIdx];
+}
+
+//! Writes softmax of single batch (numRow rows of numCol elements stored
+//! colSize apart) and returns its log-sum-exp
+//! Maximum is subtracted before exponentiation, so large inputs do not
+//! overflow, and exp is evaluated only once per element
+float SoftMaxBatch(const float* input, float* out, std::size_t numCol,
+                   std::size_t colSize, std::size_t numRow)
+{
+    const auto vecEnd = numCol - numCol % 8;
+
+    auto vecMax = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    float max = -std::numeric_limits<float>::infinity();
+    for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+    {
+        const auto* row = input + colSize * rowIdx;
+        for (std::size_t i = 0; i < vecEnd; i += 8)
+            vecMax = _mm256_max_ps(vecMax, _mm256_loadu_ps(row + i));
+        for (auto i = vecEnd; i < numCol; ++i)
+            max = std::max(max, row[i]);
+    }
+    max = std::max(max, Vector::HorizontalMax(vecMax));
+
+    const auto vecShift = _mm256_set1_ps(max);
+    auto vecExpSum = _mm256_setzero_ps();
+    float expSum = 0.0f;
+    for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+    {
+        const auto* row = input + colSize * rowIdx;
+        auto* outRow = out + colSize * rowIdx;
+        for (std::size_t i = 0; i < vecEnd; i += 8)
+        {
+            const auto e =
+                Vector::Exp(_mm256_sub_ps(_mm256_loadu_ps(row + i), vecShift));
+            _mm256_storeu_ps(outRow + i, e);
+            vecExpSum = _mm256_add_ps(vecExpSum, e);
+        }
+        for (auto i = vecEnd; i < numCol; ++i)
+        {
+            outRow[i] = std::exp(row[i] - max);
+            expSum += outRow[i];
+        }
+    }
+    expSum += Vector::HorizontalSum(vecExpSum);
+
+    const auto scale = 1.0f / expSum;
+    const auto vecScale = _mm256_set1_ps(scale);
+    for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+    {
+        auto* outRow = out + colSize * rowIdx;
+        for (std::size_t i = 0; i < vecEnd; i += 8)
+        {
+            const auto value = _mm256_loadu_ps(outRow + i);
+            _mm256_storeu_ps(outRow + i, _mm256_mul_ps(value, vecScale));
+        }
+        for (auto i = vecEnd; i < numCol; ++i)
+            outRow[i] *= scale;
+    }
+
+    return max + std::log(expSum);
+}
+
+//! Range [begin, end) of output positions whose input position
+//! (position * stride + offset - padding) lies inside [0, inputSize)
+std::pair<std::size_t, std::size_t> ValidOutputRange(std::size_t offset,
+                                                     std::size_t padding,
+                                                     std::size_t stride,
+                                                     std::size_t inputSize,
+                                                     std::size_t outputSize)
+{
+    if (inputSize + padding <= offset)
+        return { 0, 0 };
+
+    const auto begin = std::min(
+        padding > offset ? (padding - offset + stride - 1) / stride : 0,
+        outputSize);
+    const auto end = std::min(
+        (inputSize + padding - offset - 1) / stride + 1, outputSize);
+    return { begin, std::max(begin, end) };
+}
+} // namespace
+
+MicroKernel GetAvx2MicroKernel()
+{
+    return { MR, NR, ComputeTileAvx2 };
+}
+
+void GemmCpu(const Span<float> inputA, const Span<float> inputB,
+             Span<float> out, std::size_t m, std::size_t n, std::size_t k,
+             std::size_t lda, std::size_t ldb, std::size_t ldc,
+             std::size_t strideA, std::size_t strideB, std::size_t numMatrices,
+             TransposeOp op, InstructionSet instructionSet)
+{
+    BatchedGemm(inputA, inputB, out, m, n, k, lda, ldb, ldc, strideA, strideB,
+                numMatrices, op, Epilogue(), instructionSet,
+                SelectBlocking(m, n, k, numMatrices, op, instructionSet));
+}
+
+void GemmBiasActivationCpu(const Span<float> inputA, const Span<float> inputB,
+                           const Span<float> bias, Span<float> out,
+                           std::size_t m, std::size_t n, std::size_t k,
+                           std::size_t lda, std::size_t ldb, std::size_t ldc,
+                           std::size_t strideA, std::size_t strideB,
+                           std::size_t numMatrices, TransposeOp op,
+                           Activation activation,
+                           InstructionSet instructionSet)
+{
+    BatchedGemm(inputA, inputB, out, m, n, k, lda, ldb, ldc, strideA, strideB,
+                numMatrices, op, MakeEpilogue(bias, activation),
+                instructionSet,
+                SelectBlocking(m, n, k, numMatrices, op, instructionSet));
+}
+
+void GemmReduceCpu(const Span<float> inputA, const Span<float> inputB,
+                   Span<float> out, std::size_t m, std::size_t n,
+                   std::size_t k, std::size_t lda, std::size_t ldb,
+                   std::size_t ldc, std::size_t strideA, std::size_t strideB,
+                   std::size_t numMatrices, float scale, TransposeOp op,
+                   InstructionSet instructionSet)
+{
+    const auto& kernel = GetMicroKernel(instructionSet);
+    const auto transA = op == TransposeOp::TN;
+    const auto transB = op == TransposeOp::NT;
+    //! Products are accumulated one after another, so each of them is
+    //! computed by all threads with the blocking of single product
+    const auto blocking = SelectBlocking(m, n, k, 1, op, instructionSet);
+
+    Epilogue scaleEpilogue;
+    scaleEpilogue.Scale = scale;
+
+    for (std::size_t matIdx = 0; matIdx < numMatrices; ++matIdx)
+    {
+        const auto isLast = matIdx + 1 == numMatrices;
+        Gemm(inputA.Base() + strideA * matIdx, lda, transA,
+             inputB.Base() + strideB * matIdx, ldb, transB, out.Begin(), ldc,
+             m, n, k, true, isLast ? scaleEpilogue : Epilogue(), kernel,
+             blocking, matIdx > 0);
+    }
+}
+
+void GemmCpu(const Span<float> inputA, const Span<BFloat16> inputB,
+             Span<float> out, std::size_t m, std::size_t n, std::size_t k,
+             std::size_t lda, std::size_t ldb, std::size_t ldc,
+             std::size_t strideA, std::size_t strideB, std::size_t numMatrices,
+             TransposeOp op, InstructionSet instructionSet)
+{
+    BatchedGemm(inputA, inputB, out, m, n, k, lda, ldb, ldc, strideA, strideB,
+                numMatrices, op, Epilogue(), instructionSet,
+                SelectBlocking(m, n, k, numMatrices, op, instructionSet));
+}
+
+void GemmBiasActivationCpu(const Span<float> inputA,
+                           const Span<BFloat16> inputB,
+                           const Span<float> bias, Span<float> out,
+                           std::size_t m, std::size_t n, std::size_t k,
+                           std::size_t lda, std::size_t ldb, std::size_t ldc,
+                           std::size_t strideA, std::size_t strideB,
+                           std::size_t numMatrices, TransposeOp op,
+                           Activation activation,
+                           InstructionSet instructionSet)
+{
+    BatchedGemm(inputA, inputB, out, m, n, k, lda, ldb, ldc, strideA, strideB,
+                numMatrices, op, MakeEpilogue(bias, activation),
+                instructionSet,
+                SelectBlocking(m, n, k, numMatrices, op, instructionSet));
+}
+
+GemmBlocking TuneGemmCpu(std::size_t m, std::size_t n, std::size_t k,
+                         std::size_t numMatrices, bool broadcastB,
+                         TransposeOp op, InstructionSet instructionSet)
+{
+    const auto shapeClass =
+        ClassifyGemm(m, n, k, numMatrices, op, instructionSet);
+    if (IsGemmTuned(shapeClass) || m == 0 || n == 0 || numMatrices == 0)
+        return SelectBlocking(m, n, k, numMatrices, op, instructionSet);
+
+    const auto& kernel = GetMicroKernel(instructionSet);
+    const auto transA = op == TransposeOp::TN;
+    const auto transB = op == TransposeOp::NT;
+    const auto lda = transA ? m : k;
+    const auto ldb = transB ? k : n;
+    const auto strideA = m * k;
+    const auto strideB = broadcastB ? 0 : k * n;
+
+    //! Operands are filled with ones, so no denormals slow down the products
+    std::vector<float> A(strideA * numMatrices, 1.0f);
+    std::vector<float> B(broadcastB ? k * n : k * n * numMatrices, 1.0f);
+    std::vector<float> C(m * n * numMatrices);
+
+    //! Returns the shortest time of single product over repetitions
+    //! Small products are repeated for about a millisecond per measurement
+    const auto measure = [&](const GemmBlocking& blocking) {
+        const auto run = [&]() {
+            BatchedGemm(Span<float>(A.data(), A.size()),
+                        Span<float>(B.data(), B.size()),
+                        Span<float>(C.data(), C.size()), m, n, k, lda, ldb, n,
+                        strideA, strideB, numMatrices, op, Epilogue(),
+                        instructionSet, blocking);
+        };
+        const auto time = [&run](std::size_t numRuns) {
+            const auto begin = std::chrono::steady_clock::now();
+            for (std::size_t runIdx = 0; runIdx < numRuns; ++runIdx)
+                run();
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - begin;
+            return elapsed.count() / static_cast<double>(numRuns);
+        };
+
+        const auto warmUpTime = time(1);
+        const auto numRuns = static_cast<std::size_t>(
+            std::clamp(1e-3 / warmUpTime, 1.0, 100.0));
+        auto best = std::numeric_limits<double>::max();
+        for (std::size_t trialIdx = 0; trialIdx < 3; ++trialIdx)
+            best = std::min(best, time(numRuns));
+        return best;
+    };
+
+    //! Candidates larger than the dimension behave alike, so only the
+    //! smallest of them is kept
+    const auto candidates = [](std::vector<std::size_t> values,
+                               std::size_t extent, std::size_t multiple) {
+        std::vector<std::size_t> result;
+        for (const auto value : values)
+        {
+            if (value % multiple != 0)
+                continue;
+            result.emplace_back(value);
+            if (value >= extent)
+                break;
+        }
+        return result;
+    };
+
+    //! Each parameter is tuned in turn while the others keep their best
+    //! value so far, which needs far fewer benchmarks than the full grid
+    auto best = DefaultGemmBlocking(numMatrices);
+    auto bestTime = measure(best);
+    const auto tryBlocking = [&](const GemmBlocking& blocking) {
+        const auto time = measure(blocking);
+        if (time < bestTime * TuningThreshold)
+        {
+            best = blocking;
+            bestTime = time;
+        }
+    };
+
+    for (const auto kc : candidates({ 64, 128, 256, 384, 512, 768 }, k, 1))
+    {
+        auto blocking = best;
+        blocking.KC = kc;
+        tryBlocking(blocking);
+    }
+
+    //! M of products with broadcasted B is stacked along the batch
+    const auto stackedM = broadcastB && !transA ? m * numMatrices : m;
+    for (const auto mc :
+         candidates({ 48, 96, 144, 192, 288, 384 }, stackedM, kernel.MR))
+    {
+        auto blocking = best;
+        blocking.MC = mc;
+        tryBlocking(blocking);
+    }
+
+    for (const auto nc :
+         candidates({ 512, 1024, 2048, 4096, 8192 }, n, kernel.NR))
+    {
+        auto blocking = best;
+        blocking.NC = nc;
+        tryBlocking(blocking);
+    }
+
+    if (numMatrices > 1 && !(broadcastB && !transA))
+    {
+        auto blocking = best;
+        blocking.ParallelOverMatrices = !blocking.ParallelOverMatrices;
+        tryBlocking(blocking);
+    }
+
+    SetGemmBlocking(shapeClass, best);
+    return best;
+}
+
+void ConvertToBFloat16Cpu(const Span<float> input, Span<BFloat16> output,
+                          std::size_t numRow, std::size_t numCol,
+                          std::size_t ldIn, std::size_t ldOut)
+{
+    const auto* inputData = input.Base();
+    auto* outputData = output.Begin();
+
+#pragma omp parallel for schedule(static)
+    for (long rowIdx = 0; rowIdx < static_cast<long>(numRow); ++rowIdx)
+    {
+        const auto* src = inputData + ldIn * rowIdx;
+        auto* dest = outputData + ldOut * rowIdx;
+        std::size_t colIdx = 0;
+        for (; colIdx + 8 <= numCol; colIdx += 8)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + colIdx),
+                             RoundToBFloat16(_mm256_loadu_ps(src + colIdx)));
+        for (; colIdx < numCol; ++colIdx)
+            dest[colIdx] = BFloat16(src[colIdx]);
+    }
+}
+
+void ConvertFromBFloat16Cpu(const Span<BFloat16> input, Span<float> output,
+                            std::size_t numRow, std::size_t numCol,
+                            std::size_t ldIn, std::size_t ldOut)
+{
+    const auto* inputData = input.Base();
+    auto* outputData = output.Begin();
+
+#pragma omp parallel for schedule(static)
+    for (long rowIdx = 0; rowIdx < static_cast<long>(numRow); ++rowIdx)
+    {
+        const auto* src = inputData + ldIn * rowIdx;
+        auto* dest = outputData + ldOut * rowIdx;
+        std::size_t colIdx = 0;
+        for (; colIdx + 8 <= numCol; colIdx += 8)
+            _mm256_storeu_ps(dest + colIdx, LoadFloat(src + colIdx));
+        for (; colIdx < numCol; ++colIdx)
+            dest[colIdx] = static_cast<float>(src[colIdx]);
+    }
+}
+
+void MultiplyCpu(const Span<float> inputA, const Span<float> inputB,
+                 Span<float> out, std::size_t numRowA,
+                 std::size_t numColA, std::size_t numRowB,
+                 std::size_t numColB, std::size_t numMatrices)
+{
+    GemmCpu(inputA, inputB, out, numRowA, numColB, numRowB, numColA, numColB,
+            numColB, numRowA * numColA, numRowB * numColB, numMatrices,
+            TransposeOp::NN, GetNativeInstructionSet());
+}
 
 void MultiplyWithBroadcastCpu(const Span<float> inputA,
                               const Span<float> inputB, Span<float> out,
@@ -85,98 +934,326 @@ void MultiplyWithBroadcastCpu(const Span<float> inputA,
                               std::size_t numRowB, std::size_t numColB,
                               std::size_t numMatrices, bool broadCastA)
 {
-    const auto jb = std::min(static_cast<std::size_t>(512), numColB);
-    const auto kb = std::min(static_cast<std::size_t>(24), numRowB);
-    const auto sizeA = numRowA * numColA;
-    const auto sizeB = numRowB * numColB;
-    const auto sizeDest = numRowA * numColB;
+    const auto strideA = broadCastA ? 0 : numRowA * numColA;
+    const auto strideB = broadCastA ? numRowB * numColB : 0;
+    GemmCpu(inputA, inputB, out, numRowA, numColB, numRowB, numColA, numColB,
+            numColB, strideA, strideB, numMatrices, TransposeOp::NN,
+            GetNativeInstructionSet());
+}
+
+void TransposeCpu(const Span<float> input, Span<float> output,
+                  std::size_t numRow, std::size_t numCol, std::size_t ldIn,
+                  std::size_t ldOut, std::size_t numMatrices)
+{
+    const auto numTileRows = (numRow + TransposeTile - 1) / TransposeTile;
+    const auto numTileCols = (numCol + TransposeTile - 1) / TransposeTile;
+    const auto numTilesPerMatrix = numTileRows * numTileCols;
+    const auto numTasks = static_cast<long>(numMatrices * numTilesPerMatrix);
+
+#pragma omp parallel for schedule(static) default(shared)
+    for (long taskIdx = 0; taskIdx < numTasks; ++taskIdx)
+    {
+        const auto matIdx =
+            static_cast<std::size_t>(taskIdx) / numTilesPerMatrix;
+        const auto tileIdx =
+            static_cast<std::size_t>(taskIdx) % numTilesPerMatrix;
+        const auto rowBegin = (tileIdx / numTileCols) * TransposeTile;
+        const auto colBegin = (tileIdx % numTileCols) * TransposeTile;
+        const auto rowEnd = std::min(numRow, rowBegin + TransposeTile);
+        const auto colEnd = std::min(numCol, colBegin + TransposeTile);
+
+        const float* in = input.Base() + matIdx * numRow * ldIn;
+        float* out = output.Address(matIdx * numCol * ldOut);
+
+        auto rowIdx = rowBegin;
+        for (; rowIdx + 8 <= rowEnd; rowIdx += 8)
+        {
+            auto colIdx = colBegin;
+            for (; colIdx + 8 <= colEnd; colIdx += 8)
+                Vector::Transpose8x8(in + rowIdx * ldIn + colIdx, ldIn,
+                                     out + colIdx * ldOut + rowIdx, ldOut);
+            for (; colIdx < colEnd; ++colIdx)
+                for (auto idx = rowIdx; idx < rowIdx + 8; ++idx)
+                    out[colIdx * ldOut + idx] = in[idx * ldIn + colIdx];
+        }
+        for (; rowIdx < rowEnd; ++rowIdx)
+            for (auto colIdx = colBegin; colIdx < colEnd; ++colIdx)
+                out[colIdx * ldOut + rowIdx] = in[rowIdx * ldIn + colIdx];
+    }
+}
+
+void ShrinkCpu(const Span<float> input, Span<float> output,
+               std::size_t size, std::size_t batchSize, bool deterministic)
+{
+    if (size == 0 || batchSize == 0)
+        return;
+
+    const auto numColBlocks =
+        (size + ShrinkColumnBlock - 1) / ShrinkColumnBlock;
+    const auto numThreads = static_cast<std::size_t>(omp_get_max_threads());
+
+    //! Batch is split only if column blocks cannot keep every thread busy
+    //! Deterministic mode splits the batch into chunks of fixed size, so
+    //! the order of additions does not depend on the number of threads
+    std::size_t numChunks = 1;
+    if (deterministic)
+        numChunks = (batchSize + ShrinkBatchChunk - 1) / ShrinkBatchChunk;
+    else if (numColBlocks < numThreads)
+        numChunks = std::min(
+            batchSize, (numThreads + numColBlocks - 1) / numColBlocks);
+    const auto chunkSize = (batchSize + numChunks - 1) / numChunks;
+    numChunks = (batchSize + chunkSize - 1) / chunkSize;
+
+    //! Partial sum of the first chunk is written to output directly
+    thread_local PackBuffer partialBuffer;
+    float* partialSums =
+        numChunks > 1 ? partialBuffer.Get((numChunks - 1) * size) : nullptr;
+    const auto partial = [&](std::size_t chunkIdx) {
+        return chunkIdx == 0 ? output.Begin()
+                             : partialSums + (chunkIdx - 1) * size;
+    };
+
+    const auto numTasks = static_cast<long>(numChunks * numColBlocks);
+#pragma omp parallel for schedule(static) default(shared)
+    for (long taskIdx = 0; taskIdx < numTasks; ++taskIdx)
+    {
+        const auto chunkIdx = static_cast<std::size_t>(taskIdx) / numColBlocks;
+        const auto blockIdx = static_cast<std::size_t>(taskIdx) % numColBlocks;
+        const auto colBegin = blockIdx * ShrinkColumnBlock;
+        const auto colEnd = std::min(size, colBegin + ShrinkColumnBlock);
+        const auto batchBegin = chunkIdx * chunkSize;
+        const auto batchEnd = std::min(batchSize, batchBegin + chunkSize);
+
+        float* out = partial(chunkIdx);
+        std::copy(input.Base() + batchBegin * size + colBegin,
+                  input.Base() + batchBegin * size + colEnd, out + colBegin);
+        for (auto batchIdx = batchBegin + 1; batchIdx < batchEnd; ++batchIdx)
+            AddRow(input.Base() + batchIdx * size, out, colBegin, colEnd);
+    }
+
+    //! Partial sums are combined pairwise in fixed order
+    for (std::size_t stride = 1; stride < numChunks; stride *= 2)
+    {
+        const auto numPairs = (numChunks + stride - 1) / (2 * stride);
+        const auto numPairTasks = static_cast<long>(numPairs * numColBlocks);
+#pragma omp parallel for schedule(static) default(shared)
+        for (long taskIdx = 0; taskIdx < numPairTasks; ++taskIdx)
+        {
+            const auto pairIdx =
+                static_cast<std::size_t>(taskIdx) / numColBlocks;
+            const auto blockIdx =
+                static_cast<std::size_t>(taskIdx) % numColBlocks;
+            const auto colBegin = blockIdx * ShrinkColumnBlock;
+            const auto colEnd = std::min(size, colBegin + ShrinkColumnBlock);
+            const auto chunkIdx = pairIdx * 2 * stride;
+
+            AddRow(partial(chunkIdx + stride), partial(chunkIdx), colBegin,
+                   colEnd);
+        }
+    }
+
+    const auto vecDiv = _mm256_set1_ps(static_cast<float>(batchSize));
+    const auto numVectors = static_cast<long>(size / 8);
+#pragma omp parallel for schedule(static) default(shared)
+    for (long vecIdx = 0; vecIdx < numVectors; ++vecIdx)
+        _mm256_storeu_ps(
+            output.Address(vecIdx * 8),
+            _mm256_div_ps(_mm256_loadu_ps(output.Address(vecIdx * 8)), vecDiv));
+
+    for (auto i = size - size % 8; i < size; ++i)
+        output[i] /= static_cast<float>(batchSize);
+}
+
+void Im2ColCpu(const Span<float> input, Span<float> column,
+               const Conv2DGeometry& geometry, std::size_t ldInput,
+               std::size_t ldOutput, std::size_t batchSize)
+{
+    const auto outputHeight = geometry.OutputHeight();
+    const auto outputWidth = geometry.OutputWidth();
+    const auto numPixel = outputHeight * ldOutput;
+    const auto patchSize = geometry.PatchSize();
+    const auto kernelSize = geometry.KernelHeight * geometry.KernelWidth;
+    const auto planeSize = geometry.InputHeight * ldInput;
+    const auto numRows = static_cast<long>(batchSize * patchSize);
 
+    //! Each row of the column matrix is a kernel element of single channel,
+    //! which reads the plane shifted by the element offset
 #pragma omp parallel for schedule(static) default(shared)
-    for (long matIdx = 0; static_cast<std::size_t>(matIdx) < numMatrices;
-         ++matIdx)
+    for (long rowIdx = 0; rowIdx < numRows; ++rowIdx)
     {
-        const auto batchOffsetA = broadCastA ? 0 : sizeA * matIdx;
-        const auto batchOffsetB = !broadCastA ? 0 : sizeB * matIdx;
-        const auto batchOffsetDest = sizeDest * matIdx;
-        for (std::size_t jj = 0; jj < numColB; jj += jb)
+        const auto row = static_cast<std::size_t>(rowIdx);
+        const auto batchIdx = row / patchSize;
+        const auto channel = row % patchSize / kernelSize;
+        const auto kernelY = row % kernelSize / geometry.KernelWidth;
+        const auto kernelX = row % geometry.KernelWidth;
+        const auto offsetY = kernelY * geometry.DilationHeight;
+        const auto offsetX = kernelX * geometry.DilationWidth;
+
+        const float* plane = input.Base() +
+                             (batchIdx * geometry.InputChannels + channel) *
+                                 planeSize;
+        float* dest = column.Address(row * numPixel);
+
+        const auto [yBegin, yEnd] = ValidOutputRange(
+            offsetY, geometry.PaddingHeight, geometry.StrideHeight,
+            geometry.InputHeight, outputHeight);
+        const auto [xBegin, xEnd] = ValidOutputRange(
+            offsetX, geometry.PaddingWidth, geometry.StrideWidth,
+            geometry.InputWidth, outputWidth);
+
+        std::fill(dest, dest + yBegin * ldOutput, 0.0f);
+        for (auto y = yBegin; y < yEnd; ++y)
         {
-            for (std::size_t kk = 0; kk < numRowB; kk += kb)
+            const float* src =
+                plane + (y * geometry.StrideHeight + offsetY -
+                         geometry.PaddingHeight) * ldInput;
+            float* out = dest + y * ldOutput;
+
+            std::fill(out, out + xBegin, 0.0f);
+            if (geometry.StrideWidth == 1)
             {
-                for (std::size_t i = 0; i < numRowA; i += 1)
-                {
-                    for (std::size_t j = jj; j < std::min(jj + jb, numColB);
-                         j += 8)
-                    {
-                        __m256 sum;
-                        if (kk == 0)
-                            sum = _mm256_setzero_ps();
-                        else
-                        {
-                            sum = _mm256_load_ps(static_cast<float const*>(
-                                &out[batchOffsetDest + i * numColB + j]));
-                        }
-                        const auto limit = std::min(
-                            static_cast<std::size_t>(numRowB), kk + kb);
-                        for (std::size_t k = kk; k < limit; k++)
-                        {
-                            const auto input_a_offset =
-                                batchOffsetA + i * numColA + k;
-                            const auto input_b_offset =
-                                batchOffsetB + k * numColB + j;
-
-                            const auto bc_mat1_1 =
-                                _mm256_set1_ps(inputA[input_a_offset]);
-                            const auto vecA_mat2 =
-                                _mm256_load_ps(static_cast<float const*>(
-                                    &inputB[input_b_offset]));
-
-                            sum = _mm256_add_ps(
-                                sum, _mm256_mul_ps(bc_mat1_1, vecA_mat2));
-                        }
-                        _mm256_store_ps(
-                            static_cast<float*>(
-                                &out[batchOffsetDest + i * numColB + j]),
-                            sum);
-                    }
-                }
+                const auto* begin = src + xBegin + offsetX -
+                                    geometry.PaddingWidth;
+                std::copy(begin, begin + (xEnd - xBegin), out + xBegin);
+            }
+            else
+            {
+                for (auto x = xBegin; x < xEnd; ++x)
+                    out[x] = src[x * geometry.StrideWidth + offsetX -
+                                 geometry.PaddingWidth];
             }
+            std::fill(out + xEnd, out + ldOutput, 0.0f);
         }
+        std::fill(dest + yEnd * ldOutput, dest + numPixel, 0.0f);
     }
 }
 
-void ShrinkCpu(const Span<float> input, Span<float> output,
-               std::size_t size, std::size_t batchSize)
+void Col2ImCpu(const Span<float> column, Span<float> input,
+               const Conv2DGeometry& geometry, std::size_t ldInput,
+               std::size_t ldOutput, std::size_t batchSize)
 {
-    //#pragma omp parallel for schedule(static) default(shared)
-    for (long batchIdx = 0; static_cast<std::size_t>(batchIdx) < batchSize;
-         batchIdx++)
+    const auto outputHeight = geometry.OutputHeight();
+    const auto outputWidth = geometry.OutputWidth();
+    const auto numPixel = outputHeight * ldOutput;
+    const auto kernelSize = geometry.KernelHeight * geometry.KernelWidth;
+    const auto planeSize = geometry.InputHeight * ldInput;
+    const auto numPlanes = static_cast<long>(batchSize *
+                                             geometry.InputChannels);
+
+    //! Every plane gathers rows of its own channel, so threads never write
+    //! to the same element
+#pragma omp parallel for schedule(static) default(shared)
+    for (long planeIdx = 0; planeIdx < numPlanes; ++planeIdx)
     {
-        const auto batchOffset = size * batchIdx;
-        for (std::size_t i = 0; i < size; i += 8)
+        float* dest = input.Address(planeIdx * planeSize);
+        const float* planeColumn =
+            column.Base() + planeIdx * kernelSize * numPixel;
+        std::fill(dest, dest + planeSize, 0.0f);
+
+        for (std::size_t kernelIdx = 0; kernelIdx < kernelSize; ++kernelIdx)
         {
-            const auto vecA = _mm256_load_ps(
-                static_cast<float const*>(&input[batchOffset + i]));
-            const auto vecB =
-                _mm256_load_ps(static_cast<float const*>(&output[i]));
-            const auto sum = _mm256_add_ps(vecA, vecB);
+            const auto offsetY =
+                kernelIdx / geometry.KernelWidth * geometry.DilationHeight;
+            const auto offsetX =
+                kernelIdx % geometry.KernelWidth * geometry.DilationWidth;
+            const float* src = planeColumn + kernelIdx * numPixel;
 
-            //#pragma omp critical
+            const auto [yBegin, yEnd] = ValidOutputRange(
+                offsetY, geometry.PaddingHeight, geometry.StrideHeight,
+                geometry.InputHeight, outputHeight);
+            const auto [xBegin, xEnd] = ValidOutputRange(
+                offsetX, geometry.PaddingWidth, geometry.StrideWidth,
+                geometry.InputWidth, outputWidth);
+
+            for (auto y = yBegin; y < yEnd; ++y)
             {
-                _mm256_store_ps(static_cast<float*>(&output[i]), sum);
+                float* out = dest + (y * geometry.StrideHeight + offsetY -
+                                     geometry.PaddingHeight) * ldInput +
+                             offsetX - geometry.PaddingWidth;
+                const float* srcRow = src + y * ldOutput;
+                for (auto x = xBegin; x < xEnd; ++x)
+                    out[x * geometry.StrideWidth] += srcRow[x];
             }
         }
     }
+}
+
+void ChannelBiasActivationCpu(Span<float> data, const Span<float> bias,
+                              std::size_t numChannel, std::size_t numRow,
+                              std::size_t numCol, std::size_t ld,
+                              std::size_t batchSize, Activation activation)
+{
+    const auto epilogue = MakeEpilogue(bias, activation);
+    const auto numPlanes = static_cast<long>(batchSize * numChannel);
 
 #pragma omp parallel for schedule(static) default(shared)
-    for (long i = 0; static_cast<std::size_t>(i) < size; i += 8)
+    for (long planeIdx = 0; planeIdx < numPlanes; ++planeIdx)
     {
-        const auto vecDiv = _mm256_set1_ps(static_cast<float>(batchSize));
-        const auto vecA = _mm256_load_ps(static_cast<float const*>(&output[i]));
-        const auto div = _mm256_div_ps(vecA, vecDiv);
-        _mm256_store_ps(static_cast<float*>(&output[i]), div);
+        const auto channelBias =
+            epilogue.Bias[static_cast<std::size_t>(planeIdx) % numChannel];
+        const auto vecBias = _mm256_set1_ps(channelBias);
+
+        for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+        {
+            float* row = data.Address((planeIdx * numRow + rowIdx) * ld);
+            std::size_t colIdx = 0;
+            for (; colIdx + 8 <= numCol; colIdx += 8)
+                _mm256_storeu_ps(
+                    row + colIdx,
+                    ApplyActivation(
+                        _mm256_add_ps(_mm256_loadu_ps(row + colIdx), vecBias),
+                        epilogue.ActivationType));
+            for (; colIdx < numCol; ++colIdx)
+                row[colIdx] = ApplyActivation(row[colIdx] + channelBias,
+                                              epilogue.ActivationType);
+        }
     }
 }
 
+void ShrinkChannelCpu(const Span<float> input, Span<float> output,
+                      std::size_t numChannel, std::size_t numRow,
+                      std::size_t numCol, std::size_t ld,
+                      std::size_t batchSize)
+{
+#pragma omp parallel for schedule(static) default(shared)
+    for (long channel = 0; channel < static_cast<long>(numChannel); ++channel)
+    {
+        auto vecSum = _mm256_setzero_ps();
+        auto sum = 0.0f;
+        for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+            for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+            {
+                const float* row =
+                    input.Base() +
+                    ((batchIdx * numChannel + channel) * numRow + rowIdx) * ld;
+                std::size_t colIdx = 0;
+                for (; colIdx + 8 <= numCol; colIdx += 8)
+                    vecSum =
+                        _mm256_add_ps(vecSum, _mm256_loadu_ps(row + colIdx));
+                for (; colIdx < numCol; ++colIdx)
+                    sum += row[colIdx];
+            }
+
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, vecSum);
+        for (const auto lane : lanes)
+            sum += lane;
+        output[channel] = sum / static_cast<float>(batchSize);
+    }
+}
+
+void ClearPaddingCpu(Span<float> data, std::size_t numRow, std::size_t numCol,
+                     std::size_t ld)
+{
+    if (numCol == ld)
+        return;
+
+#pragma omp parallel for schedule(static) default(shared)
+    for (long rowIdx = 0; rowIdx < static_cast<long>(numRow); ++rowIdx)
+        std::fill(data.Address(rowIdx * ld + numCol),
+                  data.Address((rowIdx + 1) * ld), 0.0f);
+}
+
 void AddCpu(const Span<float> inputA, const Span<float> inputB,
             Span<float> out, std::size_t size, std::size_t batchSize)
 {
@@ -391,6 +1468,91 @@ void ScalarDivCpu(const Span<float> input, float toDiv, Span<float> out,
     }
 }
 
+void SgdUpdateCpu(Span<float> tensor, const Span<float> update,
+                  Span<float> velocity, std::size_t size, float learningRate,
+                  float momentum, bool nesterov, float weightDecay)
+{
+    const auto vecLearningRate = _mm256_set1_ps(learningRate);
+    const auto vecMomentum = _mm256_set1_ps(momentum);
+    const auto vecWeightDecay = _mm256_set1_ps(weightDecay);
+    const auto numVectors = static_cast<long>(size / 8);
+
+#pragma omp parallel for schedule(static) default(shared)
+    for (long vecIdx = 0; vecIdx < numVectors; ++vecIdx)
+    {
+        const auto idx = static_cast<std::size_t>(vecIdx) * 8;
+        auto weight = _mm256_load_ps(tensor.Address(idx));
+        //! d = update - weightDecay * w
+        auto descent = _mm256_fnmadd_ps(vecWeightDecay, weight,
+                                        _mm256_load_ps(update.Address(idx)));
+        if (momentum != 0.0f)
+        {
+            const auto vecVelocity = _mm256_fmadd_ps(
+                vecMomentum, _mm256_load_ps(velocity.Address(idx)), descent);
+            _mm256_store_ps(velocity.Address(idx), vecVelocity);
+            descent = nesterov
+                          ? _mm256_fmadd_ps(vecMomentum, vecVelocity, descent)
+                          : vecVelocity;
+        }
+        weight = _mm256_fmadd_ps(vecLearningRate, descent, weight);
+        _mm256_store_ps(tensor.Address(idx), weight);
+    }
+}
+
+void AdamUpdateCpu(Span<float> tensor, const Span<float> update,
+                   Span<float> firstMoment, Span<float> secondMoment,
+                   std::size_t size, float learningRate, float beta1,
+                   float beta2, float epsilon, float weightDecay,
+                   bool decoupledWeightDecay, std::size_t step)
+{
+    //! Bias corrections of both moments are folded into the step size and
+    //! the scale of the second moment
+    const auto exponent = static_cast<float>(step);
+    const auto stepSize = learningRate / (1.0f - std::pow(beta1, exponent));
+    const auto secondMomentScale = 1.0f / (1.0f - std::pow(beta2, exponent));
+
+    const auto vecBeta1 = _mm256_set1_ps(beta1);
+    const auto vecOneMinusBeta1 = _mm256_set1_ps(1.0f - beta1);
+    const auto vecBeta2 = _mm256_set1_ps(beta2);
+    const auto vecOneMinusBeta2 = _mm256_set1_ps(1.0f - beta2);
+    const auto vecEpsilon = _mm256_set1_ps(epsilon);
+    const auto vecStepSize = _mm256_set1_ps(stepSize);
+    const auto vecSecondMomentScale = _mm256_set1_ps(secondMomentScale);
+    //! Decoupled decay scales the weight by (1 - learningRate * weightDecay)
+    const auto vecCoupledDecay =
+        _mm256_set1_ps(decoupledWeightDecay ? 0.0f : weightDecay);
+    const auto vecDecoupledDecay = _mm256_set1_ps(
+        decoupledWeightDecay ? 1.0f - learningRate * weightDecay : 1.0f);
+    const auto numVectors = static_cast<long>(size / 8);
+
+#pragma omp parallel for schedule(static) default(shared)
+    for (long vecIdx = 0; vecIdx < numVectors; ++vecIdx)
+    {
+        const auto idx = static_cast<std::size_t>(vecIdx) * 8;
+        const auto weight = _mm256_load_ps(tensor.Address(idx));
+        const auto descent =
+            _mm256_fnmadd_ps(vecCoupledDecay, weight,
+                             _mm256_load_ps(update.Address(idx)));
+
+        const auto first = _mm256_fmadd_ps(
+            vecBeta1, _mm256_load_ps(firstMoment.Address(idx)),
+            _mm256_mul_ps(vecOneMinusBeta1, descent));
+        const auto second = _mm256_fmadd_ps(
+            vecBeta2, _mm256_load_ps(secondMoment.Address(idx)),
+            _mm256_mul_ps(vecOneMinusBeta2, _mm256_mul_ps(descent, descent)));
+        _mm256_store_ps(firstMoment.Address(idx), first);
+        _mm256_store_ps(secondMoment.Address(idx), second);
+
+        const auto denominator = _mm256_add_ps(
+            _mm256_sqrt_ps(_mm256_mul_ps(second, vecSecondMomentScale)),
+            vecEpsilon);
+        const auto delta =
+            _mm256_div_ps(_mm256_mul_ps(vecStepSize, first), denominator);
+        _mm256_store_ps(tensor.Address(idx),
+                        _mm256_fmadd_ps(weight, vecDecoupledDecay, delta));
+    }
+}
+
 void SetCpu(Span<float> data, float toSet, std::size_t size,
             std::size_t batchSize)
 {
@@ -406,4 +1568,139 @@ void SetCpu(Span<float> data, float toSet, std::size_t size,
         }
     }
 }
+void ExpCpu(const Span<float> input, Span<float> out, std::size_t size,
+            std::size_t batchSize)
+{
+    ApplyCpu(input, out, size * batchSize, Vector::Exp,
+             [](float value) { return std::exp(value); });
+}
+
+void LogCpu(const Span<float> input, Span<float> out, std::size_t size,
+            std::size_t batchSize)
+{
+    ApplyCpu(input, out, size * batchSize, Vector::Log,
+             [](float value) { return std::log(value); });
+}
+
+void SigmoidCpu(const Span<float> input, Span<float> out, std::size_t size,
+                std::size_t batchSize)
+{
+    ApplyCpu(input, out, size * batchSize, Vector::Sigmoid,
+             [](float value) { return 1.0f / (1.0f + std::exp(-value)); });
+}
+
+void TanhCpu(const Span<float> input, Span<float> out, std::size_t size,
+             std::size_t batchSize)
+{
+    ApplyCpu(input, out, size * batchSize, Vector::Tanh,
+             [](float value) { return std::tanh(value); });
+}
+
+void SoftMaxCpu(const Span<float> input, Span<float> out, std::size_t numCol,
+                std::size_t colSize, std::size_t numRow, std::size_t batchSize)
+{
+#pragma omp parallel for schedule(static) default(shared)
+    for (long batchIdx = 0; static_cast<std::size_t>(batchIdx) < batchSize;
+         ++batchIdx)
+    {
+        const auto batchOffset = numRow * colSize * batchIdx;
+        SoftMaxBatch(input.Base() + batchOffset, out.Address(batchOffset),
+                     numCol, colSize, numRow);
+    }
+}
+
+float SoftMaxCrossEntropyCpu(const Span<float> logit, const Span<float> label,
+                             Span<float> probability, std::size_t numCol,
+                             std::size_t colSize, std::size_t numRow,
+                             std::size_t batchSize)
+{
+    const auto vecEnd = numCol - numCol % 8;
+    float loss = 0.0f;
+
+#pragma omp parallel for schedule(static) default(shared) reduction(+ : loss)
+    for (long batchIdx = 0; static_cast<std::size_t>(batchIdx) < batchSize;
+         ++batchIdx)
+    {
+        const auto batchOffset = numRow * colSize * batchIdx;
+        const auto logSumExp =
+            SoftMaxBatch(logit.Base() + batchOffset,
+                         probability.Address(batchOffset), numCol, colSize,
+                         numRow);
+
+        //! -sum(label * log(probability))
+        //! = sum(label) * logSumExp - sum(label * logit)
+        auto vecLabelSum = _mm256_setzero_ps();
+        auto vecLabelLogitSum = _mm256_setzero_ps();
+        float labelSum = 0.0f;
+        float labelLogitSum = 0.0f;
+        for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+        {
+            const auto rowOffset = batchOffset + colSize * rowIdx;
+            for (std::size_t i = 0; i < vecEnd; i += 8)
+            {
+                const auto z = _mm256_loadu_ps(logit.Address(rowOffset + i));
+                const auto y = _mm256_loadu_ps(label.Address(rowOffset + i));
+                vecLabelSum = _mm256_add_ps(vecLabelSum, y);
+                vecLabelLogitSum = _mm256_fmadd_ps(y, z, vecLabelLogitSum);
+            }
+            for (auto i = vecEnd; i < numCol; ++i)
+            {
+                labelSum += label[rowOffset + i];
+                labelLogitSum += label[rowOffset + i] * logit[rowOffset + i];
+            }
+        }
+        labelSum += Vector::HorizontalSum(vecLabelSum);
+        labelLogitSum += Vector::HorizontalSum(vecLabelLogitSum);
+
+        loss += labelSum * logSumExp - labelLogitSum;
+    }
+
+    return loss;
+}
+
+void SoftMaxCrossEntropyGradientCpu(const Span<float> probability,
+                                    const Span<float> label, Span<float> out,
+                                    std::size_t numCol, std::size_t colSize,
+                                    std::size_t numRow, std::size_t batchSize)
+{
+    const auto vecEnd = numCol - numCol % 8;
+
+#pragma omp parallel for schedule(static) default(shared)
+    for (long batchIdx = 0; static_cast<std::size_t>(batchIdx) < batchSize;
+         ++batchIdx)
+    {
+        const auto batchOffset = numRow * colSize * batchIdx;
+
+        //! Labels are usually one-hot or normalized, which makes the sum 1
+        auto vecLabelSum = _mm256_setzero_ps();
+        float labelSum = 0.0f;
+        for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+        {
+            const auto rowOffset = batchOffset + colSize * rowIdx;
+            for (std::size_t i = 0; i < vecEnd; i += 8)
+                vecLabelSum = _mm256_add_ps(
+                    vecLabelSum, _mm256_loadu_ps(label.Address(rowOffset + i)));
+            for (auto i = vecEnd; i < numCol; ++i)
+                labelSum += label[rowOffset + i];
+        }
+        labelSum += Vector::HorizontalSum(vecLabelSum);
+
+        const auto vecLabelSumBroadcast = _mm256_set1_ps(labelSum);
+        for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+        {
+            const auto rowOffset = batchOffset + colSize * rowIdx;
+            for (std::size_t i = 0; i < vecEnd; i += 8)
+            {
+                const auto p =
+                    _mm256_loadu_ps(probability.Address(rowOffset + i));
+                const auto y = _mm256_loadu_ps(label.Address(rowOffset + i));
+                _mm256_storeu_ps(out.Address(rowOffset + i),
+                                 _mm256_fnmadd_ps(vecLabelSumBroadcast, p, y));
+            }
+            for (auto i = vecEnd; i < numCol; ++i)
+                out[rowOffset + i] = label[rowOffset + i] -
+                                     labelSum * probability[rowOffset + i];
+        }
+    }
+}
 } // namespace Takion::Compute::CPU
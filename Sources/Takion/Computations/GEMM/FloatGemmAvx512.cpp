@@ -0,0 +1,116 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+//! This translation unit is compiled with AVX-512 enabled
+//! Only headers without inline functions may be included, otherwise the
+//! linker could pick their AVX-512 copies for machines without AVX-512
+
+#include <Takion/Computations/GEMM/MicroKernel.hpp>
+#include <immintrin.h>
+
+namespace Takion::Compute::CPU::Float
+{
+namespace
+{
+//! 12 x 32 tile keeps 24 accumulators + 2 B vectors + 1 broadcast A in the
+//! 32 zmm registers
+constexpr std::size_t MR = 12;
+constexpr std::size_t NR = 32;
+
+void ComputeTile(std::size_t kc, const float* packedA, const float* packedB,
+                 float* tile)
+{
+    __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+    __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+    __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+    __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+    __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+    __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+    __m512 c60 = _mm512_setzero_ps(), c61 = _mm512_setzero_ps();
+    __m512 c70 = _mm512_setzero_ps(), c71 = _mm512_setzero_ps();
+    __m512 c80 = _mm512_setzero_ps(), c81 = _mm512_setzero_ps();
+    __m512 c90 = _mm512_setzero_ps(), c91 = _mm512_setzero_ps();
+    __m512 ca0 = _mm512_setzero_ps(), ca1 = _mm512_setzero_ps();
+    __m512 cb0 = _mm512_setzero_ps(), cb1 = _mm512_setzero_ps();
+
+    for (std::size_t k = 0; k < kc; ++k)
+    {
+        const auto b0 = _mm512_load_ps(packedB);
+        const auto b1 = _mm512_load_ps(packedB + 16);
+
+        auto a = _mm512_set1_ps(packedA[0]);
+        c00 = _mm512_fmadd_ps(a, b0, c00);
+        c01 = _mm512_fmadd_ps(a, b1, c01);
+        a = _mm512_set1_ps(packedA[1]);
+        c10 = _mm512_fmadd_ps(a, b0, c10);
+        c11 = _mm512_fmadd_ps(a, b1, c11);
+        a = _mm512_set1_ps(packedA[2]);
+        c20 = _mm512_fmadd_ps(a, b0, c20);
+        c21 = _mm512_fmadd_ps(a, b1, c21);
+        a = _mm512_set1_ps(packedA[3]);
+        c30 = _mm512_fmadd_ps(a, b0, c30);
+        c31 = _mm512_fmadd_ps(a, b1, c31);
+        a = _mm512_set1_ps(packedA[4]);
+        c40 = _mm512_fmadd_ps(a, b0, c40);
+        c41 = _mm512_fmadd_ps(a, b1, c41);
+        a = _mm512_set1_ps(packedA[5]);
+        c50 = _mm512_fmadd_ps(a, b0, c50);
+        c51 = _mm512_fmadd_ps(a, b1, c51);
+        a = _mm512_set1_ps(packedA[6]);
+        c60 = _mm512_fmadd_ps(a, b0, c60);
+        c61 = _mm512_fmadd_ps(a, b1, c61);
+        a = _mm512_set1_ps(packedA[7]);
+        c70 = _mm512_fmadd_ps(a, b0, c70);
+        c71 = _mm512_fmadd_ps(a, b1, c71);
+        a = _mm512_set1_ps(packedA[8]);
+        c80 = _mm512_fmadd_ps(a, b0, c80);
+        c81 = _mm512_fmadd_ps(a, b1, c81);
+        a = _mm512_set1_ps(packedA[9]);
+        c90 = _mm512_fmadd_ps(a, b0, c90);
+        c91 = _mm512_fmadd_ps(a, b1, c91);
+        a = _mm512_set1_ps(packedA[10]);
+        ca0 = _mm512_fmadd_ps(a, b0, ca0);
+        ca1 = _mm512_fmadd_ps(a, b1, ca1);
+        a = _mm512_set1_ps(packedA[11]);
+        cb0 = _mm512_fmadd_ps(a, b0, cb0);
+        cb1 = _mm512_fmadd_ps(a, b1, cb1);
+
+        packedA += MR;
+        packedB += NR;
+    }
+
+    _mm512_store_ps(tile + 0 * NR, c00);
+    _mm512_store_ps(tile + 0 * NR + 16, c01);
+    _mm512_store_ps(tile + 1 * NR, c10);
+    _mm512_store_ps(tile + 1 * NR + 16, c11);
+    _mm512_store_ps(tile + 2 * NR, c20);
+    _mm512_store_ps(tile + 2 * NR + 16, c21);
+    _mm512_store_ps(tile + 3 * NR, c30);
+    _mm512_store_ps(tile + 3 * NR + 16, c31);
+    _mm512_store_ps(tile + 4 * NR, c40);
+    _mm512_store_ps(tile + 4 * NR + 16, c41);
+    _mm512_store_ps(tile + 5 * NR, c50);
+    _mm512_store_ps(tile + 5 * NR + 16, c51);
+    _mm512_store_ps(tile + 6 * NR, c60);
+    _mm512_store_ps(tile + 6 * NR + 16, c61);
+    _mm512_store_ps(tile + 7 * NR, c70);
+    _mm512_store_ps(tile + 7 * NR + 16, c71);
+    _mm512_store_ps(tile + 8 * NR, c80);
+    _mm512_store_ps(tile + 8 * NR + 16, c81);
+    _mm512_store_ps(tile + 9 * NR, c90);
+    _mm512_store_ps(tile + 9 * NR + 16, c91);
+    _mm512_store_ps(tile + 10 * NR, ca0);
+    _mm512_store_ps(tile + 10 * NR + 16, ca1);
+    _mm512_store_ps(tile + 11 * NR, cb0);
+    _mm512_store_ps(tile + 11 * NR + 16, cb1);
+}
+} // namespace
+
+MicroKernel GetAvx512MicroKernel()
+{
+    return { MR, NR, ComputeTile };
+}
+} // namespace Takion::Compute::CPU::Float
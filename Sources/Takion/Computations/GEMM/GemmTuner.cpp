@@ -0,0 +1,260 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <Takion/Computations/GEMM/GemmTuner.hpp>
+#include <omp.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace Takion::Compute::CPU::Float
+{
+namespace
+{
+//! Tuned blockings shared by every model of the process
+//! Looked up once per GEMM call, so a single lock is cheap enough
+std::mutex& GetBlockingMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::map<GemmShapeClass, GemmBlocking>& GetBlockingMap()
+{
+    static std::map<GemmShapeClass, GemmBlocking> blockingMap;
+    return blockingMap;
+}
+
+std::size_t CeilLog2(std::size_t value)
+{
+    std::size_t log = 0;
+    while ((std::size_t{ 1 } << log) < value)
+        ++log;
+    return log;
+}
+
+//! Blockings depend on the caches and the number of threads sharing them,
+//! so each processor and thread count has its own section in the cache file
+std::string GetSectionHeader()
+{
+    return "[" + GetProcessorName() + " | " +
+           std::to_string(omp_get_max_threads()) + " threads]";
+}
+
+std::string ToString(TransposeOp op)
+{
+    switch (op)
+    {
+        case TransposeOp::NN:
+            return "NN";
+        case TransposeOp::NT:
+            return "NT";
+        case TransposeOp::TN:
+            return "TN";
+    }
+    throw std::invalid_argument("Unknown transpose operation");
+}
+
+//! Parses single cache entry
+//! "<instruction set> <op> <log m> <log n> <log k> <log numMatrices>
+//!  <MC> <KC> <NC> <parallel over matrices>"
+bool ParseEntry(const std::string& line, GemmShapeClass& shapeClass,
+                GemmBlocking& blocking)
+{
+    std::istringstream stream(line);
+    std::string instructionSetName;
+    std::string opName;
+    int parallelOverMatrices = 0;
+    stream >> instructionSetName >> opName >> shapeClass.LogM >>
+        shapeClass.LogN >> shapeClass.LogK >> shapeClass.LogNumMatrices >>
+        blocking.MC >> blocking.KC >> blocking.NC >> parallelOverMatrices;
+
+    std::string rest;
+    if (stream.fail() || (stream >> rest) || blocking.MC == 0 ||
+        blocking.KC == 0 || blocking.NC == 0)
+        return false;
+    blocking.ParallelOverMatrices = parallelOverMatrices != 0;
+
+    auto found = false;
+    for (const auto instructionSet :
+         { InstructionSet::AVX2, InstructionSet::AVX512,
+           InstructionSet::AVX512VNNI })
+        if (Compute::ToString(instructionSet) == instructionSetName)
+        {
+            shapeClass.TargetInstructionSet = instructionSet;
+            found = true;
+        }
+    if (!found)
+        return false;
+
+    for (const auto op : { TransposeOp::NN, TransposeOp::NT, TransposeOp::TN })
+        if (ToString(op) == opName)
+        {
+            shapeClass.Op = op;
+            return true;
+        }
+    return false;
+}
+
+//! Reads lines of the file with line endings removed
+std::vector<std::string> ReadLines(const std::string& path)
+{
+    std::vector<std::string> lineVector;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        lineVector.emplace_back(line);
+    }
+    return lineVector;
+}
+} // namespace
+
+bool GemmShapeClass::operator<(const GemmShapeClass& other) const
+{
+    return std::tie(TargetInstructionSet, Op, LogM, LogN, LogK,
+                    LogNumMatrices) <
+           std::tie(other.TargetInstructionSet, other.Op, other.LogM,
+                    other.LogN, other.LogK, other.LogNumMatrices);
+}
+
+bool GemmShapeClass::operator==(const GemmShapeClass& other) const
+{
+    return !(*this < other) && !(other < *this);
+}
+
+GemmShapeClass ClassifyGemm(std::size_t m, std::size_t n, std::size_t k,
+                            std::size_t numMatrices, TransposeOp op,
+                            InstructionSet instructionSet)
+{
+    GemmShapeClass shapeClass;
+    shapeClass.TargetInstructionSet = instructionSet;
+    shapeClass.Op = op;
+    shapeClass.LogM = CeilLog2(m);
+    shapeClass.LogN = CeilLog2(n);
+    shapeClass.LogK = CeilLog2(k);
+    shapeClass.LogNumMatrices = CeilLog2(numMatrices);
+    return shapeClass;
+}
+
+GemmBlocking DefaultGemmBlocking(std::size_t numMatrices)
+{
+    GemmBlocking blocking;
+    blocking.ParallelOverMatrices =
+        numMatrices >= static_cast<std::size_t>(omp_get_max_threads());
+    return blocking;
+}
+
+GemmBlocking GetGemmBlocking(const GemmShapeClass& shapeClass,
+                             std::size_t numMatrices)
+{
+    {
+        std::lock_guard<std::mutex> lock(GetBlockingMutex());
+        const auto& blockingMap = GetBlockingMap();
+        const auto itr = blockingMap.find(shapeClass);
+        if (itr != blockingMap.end())
+            return itr->second;
+    }
+    return DefaultGemmBlocking(numMatrices);
+}
+
+bool IsGemmTuned(const GemmShapeClass& shapeClass)
+{
+    std::lock_guard<std::mutex> lock(GetBlockingMutex());
+    return GetBlockingMap().count(shapeClass) > 0;
+}
+
+void SetGemmBlocking(const GemmShapeClass& shapeClass,
+                     const GemmBlocking& blocking)
+{
+    std::lock_guard<std::mutex> lock(GetBlockingMutex());
+    GetBlockingMap()[shapeClass] = blocking;
+}
+
+void ClearGemmBlocking()
+{
+    std::lock_guard<std::mutex> lock(GetBlockingMutex());
+    GetBlockingMap().clear();
+}
+
+std::size_t LoadGemmTuningCache(const std::string& path)
+{
+    const auto sectionHeader = GetSectionHeader();
+    std::map<GemmShapeClass, GemmBlocking> loadedMap;
+    auto inSection = false;
+
+    for (const auto& line : ReadLines(path))
+    {
+        if (line.empty() || line.front() == '#')
+            continue;
+        if (line.front() == '[')
+        {
+            inSection = line == sectionHeader;
+            continue;
+        }
+        if (!inSection)
+            continue;
+
+        GemmShapeClass shapeClass;
+        GemmBlocking blocking;
+        if (!ParseEntry(line, shapeClass, blocking))
+            throw std::runtime_error("Malformed entry in GEMM tuning cache " +
+                                     path + " : " + line);
+        loadedMap[shapeClass] = blocking;
+    }
+
+    std::lock_guard<std::mutex> lock(GetBlockingMutex());
+    for (const auto& [shapeClass, blocking] : loadedMap)
+        GetBlockingMap()[shapeClass] = blocking;
+    return loadedMap.size();
+}
+
+void SaveGemmTuningCache(const std::string& path)
+{
+    const auto sectionHeader = GetSectionHeader();
+
+    //! Sections of other processors are copied as they are
+    std::vector<std::string> otherLineVector;
+    auto inSection = false;
+    for (const auto& line : ReadLines(path))
+    {
+        if (!line.empty() && line.front() == '[')
+            inSection = line == sectionHeader;
+        if (!inSection && !line.empty() && line.front() != '#')
+            otherLineVector.emplace_back(line);
+    }
+
+    std::ostringstream stream;
+    stream << "# Takion GEMM tuning cache\n"
+           << "# instruction set, op, log2 of m n k numMatrices, MC KC NC, "
+              "parallel over matrices\n";
+    for (const auto& line : otherLineVector)
+        stream << line << "\n";
+
+    stream << sectionHeader << "\n";
+    {
+        std::lock_guard<std::mutex> lock(GetBlockingMutex());
+        for (const auto& [shapeClass, blocking] : GetBlockingMap())
+            stream << Compute::ToString(shapeClass.TargetInstructionSet) << " "
+                   << ToString(shapeClass.Op) << " " << shapeClass.LogM << " "
+                   << shapeClass.LogN << " " << shapeClass.LogK << " "
+                   << shapeClass.LogNumMatrices << " " << blocking.MC << " "
+                   << blocking.KC << " " << blocking.NC << " "
+                   << (blocking.ParallelOverMatrices ? 1 : 0) << "\n";
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    file << stream.str();
+    if (!file)
+        throw std::runtime_error("Failed to write GEMM tuning cache " + path);
+}
+} // namespace Takion::Compute::CPU::Float
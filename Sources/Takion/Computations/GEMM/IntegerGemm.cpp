@@ -4,14 +4,92 @@
 // personal capacity and are not conveying any rights to any intellectual
 // property of any third parties.
 
+#include <Takion/Computations/GEMM/FloatGemm.hpp>
 #include <Takion/Computations/GEMM/IntegerGemm.hpp>
 #include <Takion/Utils/Span.hpp>
 #include <immintrin.h>
+#include <omp.h>
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
 namespace Takion::Compute::CPU::Int
 {
+namespace
+{
+//! Number of columns ShrinkCpu reduces in single task
+constexpr std::size_t ShrinkColumnBlock = 4096;
+
+//! Adds columns [colBegin, colEnd) of row to out
+void AddRow(const int* row, int* out, std::size_t colBegin, std::size_t colEnd)
+{
+    auto colIdx = colBegin;
+    for (; colIdx + 8 <= colEnd; colIdx += 8)
+    {
+        const auto sum = _mm256_add_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + colIdx)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + colIdx)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + colIdx), sum);
+    }
+    for (; colIdx < colEnd; ++colIdx)
+        out[colIdx] += row[colIdx];
+}
+} // namespace
+
+void GemmCpu(const Span<int> inputA, const Span<int> inputB, Span<int> out,
+             std::size_t m, std::size_t n, std::size_t k, std::size_t lda,
+             std::size_t ldb, std::size_t ldc, std::size_t strideA,
+             std::size_t strideB, std::size_t numMatrices, TransposeOp op)
+{
+    const auto strideOut = m * ldc;
+    const auto numRows = m * numMatrices;
+
+#pragma omp parallel for schedule(static) default(shared)
+    for (long rowIdx = 0; static_cast<std::size_t>(rowIdx) < numRows; ++rowIdx)
+    {
+        const auto matIdx = static_cast<std::size_t>(rowIdx) / m;
+        const auto i = static_cast<std::size_t>(rowIdx) % m;
+        const int* A = inputA.Base() + strideA * matIdx;
+        const int* B = inputB.Base() + strideB * matIdx;
+        int* C = out.Address(strideOut * matIdx + i * ldc);
+
+        //! Rows of B are not contiguous along n when B is transposed,
+        //! so each element is computed as dot product of two rows
+        if (op == TransposeOp::NT)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                int sum = 0;
+                for (std::size_t p = 0; p < k; ++p)
+                    sum += A[i * lda + p] * B[j * ldb + p];
+                C[j] = sum;
+            }
+            continue;
+        }
+
+        std::fill(C, C + n, 0);
+        for (std::size_t p = 0; p < k; ++p)
+        {
+            const int a =
+                op == TransposeOp::TN ? A[p * lda + i] : A[i * lda + p];
+            const auto broadcastA = _mm256_set1_epi32(a);
+            const int* rowB = B + p * ldb;
+            std::size_t j = 0;
+            for (; j + 8 <= n; j += 8)
+            {
+                const auto vecB = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(rowB + j));
+                auto* dest = reinterpret_cast<__m256i*>(C + j);
+                const auto product = _mm256_mullo_epi32(broadcastA, vecB);
+                _mm256_storeu_si256(
+                    dest, _mm256_add_epi32(_mm256_loadu_si256(dest), product));
+            }
+            for (; j < n; ++j)
+                C[j] += a * rowB[j];
+        }
+    }
+}
+
 void MultiplyCpu(const Span<int> inputA, const Span<int> inputB,
                  Span<int> out, std::size_t numRowA, std::size_t numColA,
                  std::size_t numRowB, std::size_t numColB,
@@ -141,81 +219,71 @@ void MultiplyWithBroadcastCpu(const Span<int> inputA,
 }
 
 
-void CpuTranspose(const Span<int> input, Span<int> output,
-                  std::size_t numRowInput, std::size_t numColInput,
-                  std::size_t batchSize)
+void TransposeCpu(const Span<int> input, Span<int> output,
+                  std::size_t numRow, std::size_t numCol, std::size_t ldIn,
+                  std::size_t ldOut, std::size_t numMatrices)
 {
-    const auto blockSize = 4;
-    const auto matrixSize = numRowInput * numColInput;
-#pragma omp parallel for schedule(static) default(shared)
-    for (long batchIdx = 0; static_cast<std::size_t>(batchIdx) < batchSize;
-         ++batchIdx)
-    {
-        for (std::size_t ii = 0; ii < numRowInput; ii += blockSize)
-            for (std::size_t jj = 0; jj < numColInput; jj += blockSize)
-            {
-                std::size_t i_lim = ii + blockSize;
-                if (i_lim > numRowInput)
-                    i_lim = numRowInput;
-
-                std::size_t j_lim = jj + blockSize;
-                if (j_lim > numColInput)
-                    j_lim = numColInput;
-
-                for (std::size_t i = ii; i < i_lim; i++)
-                    for (std::size_t j = jj; j < j_lim; j++)
-                        output[batchIdx * matrixSize + j * numRowInput + i] =
-                            input[batchIdx * matrixSize + i * numColInput + j];
-            }
-    }
+    //! Transpose only moves 32 bit elements, so the float kernel is reused
+    const Span<float> floatInput(
+        reinterpret_cast<float*>(const_cast<int*>(input.Base())),
+        numMatrices * numRow * ldIn);
+    Span<float> floatOutput(reinterpret_cast<float*>(output.Begin()),
+                            numMatrices * numCol * ldOut);
+    Float::TransposeCpu(floatInput, floatOutput, numRow, numCol, ldIn, ldOut,
+                        numMatrices);
 }
 
 
 void ShrinkCpu(const Span<int> input, Span<int> output, std::size_t size,
                std::size_t batchSize)
 {
-    // #pragma omp parallel for schedule(static) default(shared)
-    for (long batchIdx = 0; static_cast<std::size_t>(batchIdx) < batchSize;
-         batchIdx++)
-    {
-        const auto batchOffset = size * batchIdx;
-        for (std::size_t i = 0; i < size; i += 8)
-        {
-            const auto vecA =
-                _mm256_loadu_si256((__m256i*)&input[batchOffset + i]);
-            const auto vecB = _mm256_loadu_si256((__m256i*)&output[i]);
-            const auto sum = _mm256_add_epi32(vecA, vecB);
-            // #pragma omp critical
-            {
-                _mm256_storeu_si256((__m256i*)&output[i], sum);
-            }
-        }
-    }
-
-#ifdef _MSC_VER
-#if _MSC_VER >= 1920
+    if (size == 0 || batchSize == 0)
+        return;
+
+    //! Integer sums do not depend on the order of additions, so the batch is
+    //! split between threads whenever column blocks cannot keep them busy
+    const auto numColBlocks =
+        (size + ShrinkColumnBlock - 1) / ShrinkColumnBlock;
+    const auto numThreads = static_cast<std::size_t>(omp_get_max_threads());
+    std::size_t numChunks = 1;
+    if (numColBlocks < numThreads)
+        numChunks = std::min(
+            batchSize, (numThreads + numColBlocks - 1) / numColBlocks);
+    const auto chunkSize = (batchSize + numChunks - 1) / numChunks;
+    numChunks = (batchSize + chunkSize - 1) / chunkSize;
+
+    std::vector<int> partialSums((numChunks - 1) * size);
+    const auto partial = [&](std::size_t chunkIdx) {
+        return chunkIdx == 0 ? output.Begin()
+                             : partialSums.data() + (chunkIdx - 1) * size;
+    };
+
+    const auto numTasks = static_cast<long>(numChunks * numColBlocks);
 #pragma omp parallel for schedule(static) default(shared)
-    for (long i = 0; static_cast<std::size_t>(i) < size; i += 8)
+    for (long taskIdx = 0; taskIdx < numTasks; ++taskIdx)
     {
-        const auto vecDiv = _mm256_set1_epi32(static_cast<int>(batchSize));
-        const auto vec = _mm256_loadu_si256((__m256i*)&output[i]);
-        const auto div = _mm256_div_epi32(vec, vecDiv);
-        _mm256_storeu_si256((__m256i*)&output[i], div);
+        const auto chunkIdx = static_cast<std::size_t>(taskIdx) / numColBlocks;
+        const auto blockIdx = static_cast<std::size_t>(taskIdx) % numColBlocks;
+        const auto colBegin = blockIdx * ShrinkColumnBlock;
+        const auto colEnd = std::min(size, colBegin + ShrinkColumnBlock);
+        const auto batchBegin = chunkIdx * chunkSize;
+        const auto batchEnd = std::min(batchSize, batchBegin + chunkSize);
+
+        int* out = partial(chunkIdx);
+        std::copy(input.Base() + batchBegin * size + colBegin,
+                  input.Base() + batchBegin * size + colEnd, out + colBegin);
+        for (auto batchIdx = batchBegin + 1; batchIdx < batchEnd; ++batchIdx)
+            AddRow(input.Base() + batchIdx * size, out, colBegin, colEnd);
     }
-#else
-#pragma omp parallel for schedule(static) default(shared)
-    for (long i = 0; static_cast<std::size_t>(i) < size; i += 1)
-    {
-        output[i] /= static_cast<int>(batchSize);
-    }
-#endif
-#else
+
+    for (std::size_t chunkIdx = 1; chunkIdx < numChunks; ++chunkIdx)
+        AddRow(partial(chunkIdx), output.Begin(), 0, size);
+
 #pragma omp parallel for schedule(static) default(shared)
     for (long i = 0; static_cast<std::size_t>(i) < size; i += 1)
     {
         output[i] /= static_cast<int>(batchSize);
     }
-#endif
 }
 
 
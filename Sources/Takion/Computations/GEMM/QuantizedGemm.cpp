@@ -0,0 +1,358 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <Takion/Computations/GEMM/QuantizedGemm.hpp>
+#include <Takion/Computations/GEMM/MicroKernel.hpp>
+#include <Takion/Computations/Vector/VectorMath.hpp>
+#include <immintrin.h>
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Takion::Compute::CPU::Int8
+{
+namespace
+{
+//! Register tile computed by the AVX2 micro kernel
+//! 4 x 16 tile keeps 8 int32 accumulators + 2 weight vectors + 1 broadcast
+//! input + temporaries in the 16 ymm registers
+constexpr std::size_t MR = 4;
+constexpr std::size_t NR = 16;
+
+//! Largest register tile of every micro kernel
+constexpr std::size_t MaxTileSize = 8 * 32;
+
+//! Columns of packed weight are padded to multiple of NR of every kernel
+constexpr std::size_t ColumnAlignment = 32;
+
+//! Number of rows quantized together in single group of packed weight
+constexpr std::size_t GroupSize = 4;
+
+std::size_t RoundUp(std::size_t value, std::size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+float ApplyActivation(float value, Activation activation)
+{
+    switch (activation)
+    {
+        case Activation::Relu:
+            return value > 0.0f ? value : 0.1f * value;
+        case Activation::Sigmoid:
+            return 1.0f / (1.0f + std::exp(-value));
+        default:
+            return value;
+    }
+}
+
+__m256 ApplyActivation(__m256 value, Activation activation)
+{
+    switch (activation)
+    {
+        case Activation::Relu:
+        {
+            const auto isPositive =
+                _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_GT_OQ);
+            return _mm256_blendv_ps(
+                _mm256_mul_ps(value, _mm256_set1_ps(0.1f)), value, isPositive);
+        }
+        case Activation::Sigmoid:
+            return Vector::Sigmoid(value);
+        default:
+            return value;
+    }
+}
+
+//! Quantizes numCol elements of input to [0, MaxInputValue]
+void QuantizeRow(const float* input, std::size_t numCol, float inverseScale,
+                 std::int32_t zeroPoint, std::uint8_t* output)
+{
+    const auto scale = _mm256_set1_ps(inverseScale);
+    const auto offset = _mm256_set1_ps(static_cast<float>(zeroPoint));
+    const auto lower = _mm256_setzero_si256();
+    const auto upper = _mm256_set1_epi32(MaxInputValue);
+
+    std::size_t colIdx = 0;
+    for (; colIdx + 8 <= numCol; colIdx += 8)
+    {
+        //! Conversion rounds to nearest
+        auto value = _mm256_cvtps_epi32(
+            _mm256_fmadd_ps(_mm256_loadu_ps(input + colIdx), scale, offset));
+        value = _mm256_min_epi32(_mm256_max_epi32(value, lower), upper);
+        const auto packed = _mm_packus_epi32(
+            _mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + colIdx),
+                         _mm_packus_epi16(packed, packed));
+    }
+    for (; colIdx < numCol; ++colIdx)
+    {
+        const auto value = static_cast<std::int32_t>(
+            std::nearbyint(input[colIdx] * inverseScale + zeroPoint));
+        output[colIdx] = static_cast<std::uint8_t>(
+            std::clamp(value, 0, MaxInputValue));
+    }
+}
+
+//! Broadcasts 4 quantized inputs to every 32 bit lane
+__m256i Broadcast(const std::uint8_t* input)
+{
+    std::int32_t word;
+    std::memcpy(&word, input, sizeof(word));
+    return _mm256_set1_epi32(word);
+}
+
+//! Adds sums of 4 u8 x s8 products to each int32 lane of acc
+//! maddubs sums pairs of products to int16, and madd sums pairs of int16
+__m256i MultiplyAdd(__m256i acc, __m256i input, __m256i weight)
+{
+    return _mm256_add_epi32(
+        acc, _mm256_madd_epi16(_mm256_maddubs_epi16(input, weight),
+                               _mm256_set1_epi16(1)));
+}
+
+//! Computes MR x NR tile of quantized input * packed weight using AVX2
+void ComputeTileAvx2(const std::uint8_t* const* inputRows,
+                     const std::int8_t* packedWeight, std::size_t numGroups,
+                     std::size_t groupStride, std::int32_t* tile)
+{
+    __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+    __m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+    __m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+    __m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+
+    for (std::size_t group = 0; group < numGroups; ++group)
+    {
+        const auto* weight = packedWeight + group * groupStride;
+        const auto b0 =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weight));
+        const auto b1 =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weight + 32));
+        const auto offset = group * GroupSize;
+
+        auto a = Broadcast(inputRows[0] + offset);
+        c00 = MultiplyAdd(c00, a, b0);
+        c01 = MultiplyAdd(c01, a, b1);
+        a = Broadcast(inputRows[1] + offset);
+        c10 = MultiplyAdd(c10, a, b0);
+        c11 = MultiplyAdd(c11, a, b1);
+        a = Broadcast(inputRows[2] + offset);
+        c20 = MultiplyAdd(c20, a, b0);
+        c21 = MultiplyAdd(c21, a, b1);
+        a = Broadcast(inputRows[3] + offset);
+        c30 = MultiplyAdd(c30, a, b0);
+        c31 = MultiplyAdd(c31, a, b1);
+    }
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 0 * NR), c00);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 0 * NR + 8), c01);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 1 * NR), c10);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 1 * NR + 8), c11);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 2 * NR), c20);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 2 * NR + 8), c21);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 3 * NR), c30);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tile + 3 * NR + 8), c31);
+}
+
+//! Converts mr x nr part of the tile to float and writes
+//! activation(tile * scale + offset) to out
+//! Rows of the tile are nrTile elements apart
+void StoreTile(const std::int32_t* tile, std::size_t nrTile, float* out,
+               std::size_t ldc, std::size_t mr, std::size_t nr,
+               const float* scale, const float* offset, Activation activation)
+{
+    for (std::size_t r = 0; r < mr; ++r)
+    {
+        const auto* src = tile + r * nrTile;
+        auto* dest = out + r * ldc;
+
+        std::size_t c = 0;
+        for (; c + 8 <= nr; c += 8)
+        {
+            const auto value = _mm256_fmadd_ps(
+                _mm256_cvtepi32_ps(_mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(src + c))),
+                _mm256_loadu_ps(scale + c), _mm256_loadu_ps(offset + c));
+            _mm256_storeu_ps(dest + c, ApplyActivation(value, activation));
+        }
+        for (; c < nr; ++c)
+            dest[c] = ApplyActivation(
+                static_cast<float>(src[c]) * scale[c] + offset[c],
+                activation);
+    }
+}
+
+//! Micro kernel of the instruction set
+const MicroKernel& GetMicroKernel(InstructionSet instructionSet)
+{
+    static const MicroKernel avx2Kernel = GetAvx2MicroKernel();
+    static const MicroKernel avx512VnniKernel = GetAvx512VnniMicroKernel();
+
+    //! AVX512 without VNNI has no faster int8 product than maddubs
+    return instructionSet == InstructionSet::AVX512VNNI ? avx512VnniKernel
+                                                        : avx2Kernel;
+}
+} // namespace
+
+MicroKernel GetAvx2MicroKernel()
+{
+    return { MR, NR, ComputeTileAvx2 };
+}
+
+QuantizationRange ComputeInputRange(float min, float max)
+{
+    min = std::min(min, 0.0f);
+    max = std::max(max, 0.0f);
+
+    QuantizationRange range;
+    if (max - min <= 0.0f)
+        return range;
+
+    range.Scale = (max - min) / static_cast<float>(MaxInputValue);
+    range.ZeroPoint = std::clamp(
+        static_cast<std::int32_t>(std::nearbyint(-min / range.Scale)), 0,
+        MaxInputValue);
+    return range;
+}
+
+QuantizedMatrix QuantizeMatrix(const Span<float> matrix, std::size_t k,
+                               std::size_t n, std::size_t ld)
+{
+    QuantizedMatrix quantized;
+    quantized.NumRow = k;
+    quantized.NumCol = n;
+    quantized.PaddedNumRow = RoundUp(k, GroupSize);
+    quantized.PaddedNumCol = RoundUp(n, ColumnAlignment);
+    quantized.Data.assign(quantized.PaddedNumRow * quantized.PaddedNumCol, 0);
+    quantized.Scale.assign(quantized.PaddedNumCol, 0.0f);
+    quantized.ColumnSum.assign(quantized.PaddedNumCol, 0);
+
+    const auto* data = matrix.Base();
+
+#pragma omp parallel for schedule(static)
+    for (long colIdx = 0; colIdx < static_cast<long>(n); ++colIdx)
+    {
+        float maxMagnitude = 0.0f;
+        for (std::size_t rowIdx = 0; rowIdx < k; ++rowIdx)
+            maxMagnitude =
+                std::max(maxMagnitude, std::abs(data[rowIdx * ld + colIdx]));
+
+        const auto scale = maxMagnitude > 0.0f
+                               ? maxMagnitude / MaxWeightValue
+                               : 1.0f;
+        std::int32_t columnSum = 0;
+        for (std::size_t rowIdx = 0; rowIdx < k; ++rowIdx)
+        {
+            const auto value = std::clamp(
+                static_cast<std::int32_t>(
+                    std::nearbyint(data[rowIdx * ld + colIdx] / scale)),
+                -MaxWeightValue, MaxWeightValue);
+            const auto group = rowIdx / GroupSize;
+            quantized.Data[(group * quantized.PaddedNumCol + colIdx) *
+                           GroupSize +
+                           rowIdx % GroupSize] =
+                static_cast<std::int8_t>(value);
+            columnSum += value;
+        }
+        quantized.Scale[colIdx] = scale;
+        quantized.ColumnSum[colIdx] = columnSum;
+    }
+
+    return quantized;
+}
+
+void QuantizedGemmBiasActivationCpu(const Span<float> input,
+                                    const QuantizedMatrix& weight,
+                                    QuantizationRange inputRange,
+                                    const Span<float> bias, Span<float> out,
+                                    std::size_t m, std::size_t lda,
+                                    std::size_t ldc, Activation activation,
+                                    InstructionSet instructionSet)
+{
+    if (activation != Activation::Linear &&
+        activation != Activation::Relu && activation != Activation::Sigmoid)
+        throw std::invalid_argument(
+            "Unsupported activation for quantized GEMM epilogue");
+
+    if (m == 0 || weight.NumCol == 0)
+        return;
+
+    const auto k = weight.NumRow;
+    const auto n = weight.NumCol;
+    const auto paddedK = weight.PaddedNumRow;
+    const auto paddedN = weight.PaddedNumCol;
+    const auto& kernel = GetMicroKernel(instructionSet);
+    const auto mr = kernel.MR;
+    const auto nr = kernel.NR;
+
+    //! Zero point of the input is folded into the bias, since
+    //! sum((a - zeroPoint) * w) = sum(a * w) - zeroPoint * ColumnSum
+    std::vector<float> outputScale(paddedN, 0.0f);
+    std::vector<float> outputOffset(paddedN, 0.0f);
+    for (std::size_t colIdx = 0; colIdx < n; ++colIdx)
+    {
+        outputScale[colIdx] = inputRange.Scale * weight.Scale[colIdx];
+        outputOffset[colIdx] =
+            bias.Base()[colIdx] -
+            outputScale[colIdx] *
+                static_cast<float>(inputRange.ZeroPoint *
+                                   weight.ColumnSum[colIdx]);
+    }
+
+    //! Reused between calls on the same thread
+    thread_local std::vector<std::uint8_t> quantizedInput;
+    if (quantizedInput.size() < m * paddedK)
+        quantizedInput.resize(m * paddedK);
+    auto* quantizedData = quantizedInput.data();
+
+    const auto inverseScale = 1.0f / inputRange.Scale;
+    const auto* inputData = input.Base();
+
+#pragma omp parallel for schedule(static)
+    for (long rowIdx = 0; rowIdx < static_cast<long>(m); ++rowIdx)
+    {
+        auto* row = quantizedData + rowIdx * paddedK;
+        QuantizeRow(inputData + rowIdx * lda, k, inverseScale,
+                    inputRange.ZeroPoint, row);
+        //! Padded weights are zero, so padding only needs a defined value
+        std::fill(row + k, row + paddedK, static_cast<std::uint8_t>(0));
+    }
+
+    //! Blocks of the same columns are consecutive, so each thread reuses
+    //! K x NR panel of the weight from cache while sweeping the rows
+    const auto numRowBlocks = (m + mr - 1) / mr;
+    const auto numColBlocks = paddedN / nr;
+    auto* outData = out.Begin();
+
+#pragma omp parallel for schedule(static)
+    for (long blockIdx = 0;
+         blockIdx < static_cast<long>(numRowBlocks * numColBlocks); ++blockIdx)
+    {
+        const auto rowBegin = (blockIdx % numRowBlocks) * mr;
+        const auto colBegin = (blockIdx / numRowBlocks) * nr;
+        const auto numRows = std::min(mr, m - rowBegin);
+        if (colBegin >= n)
+            continue;
+
+        //! Rows beyond m repeat the last row and are not stored
+        const std::uint8_t* inputRows[MaxTileSize];
+        for (std::size_t r = 0; r < mr; ++r)
+            inputRows[r] = quantizedData +
+                           (rowBegin + std::min(r, numRows - 1)) * paddedK;
+
+        alignas(64) std::int32_t tile[MaxTileSize];
+        kernel.ComputeTile(inputRows,
+                           weight.Data.data() + colBegin * GroupSize,
+                           paddedK / GroupSize, paddedN * GroupSize, tile);
+        StoreTile(tile, nr, outData + rowBegin * ldc + colBegin, ldc,
+                  numRows, std::min(nr, n - colBegin),
+                  outputScale.data() + colBegin,
+                  outputOffset.data() + colBegin, activation);
+    }
+}
+} // namespace Takion::Compute::CPU::Int8
@@ -0,0 +1,102 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+//! This translation unit is compiled with AVX-512 VNNI enabled
+//! Only headers without inline functions may be included, otherwise the
+//! linker could pick their AVX-512 copies for machines without AVX-512
+
+#include <Takion/Computations/GEMM/MicroKernel.hpp>
+#include <immintrin.h>
+#include <cstring>
+
+namespace Takion::Compute::CPU::Int8
+{
+namespace
+{
+//! 8 x 32 tile keeps 16 accumulators + 2 weight vectors + 1 broadcast
+//! input in the 32 zmm registers
+constexpr std::size_t MR = 8;
+constexpr std::size_t NR = 32;
+
+//! Broadcasts 4 quantized inputs to every 32 bit lane
+__m512i Broadcast(const std::uint8_t* input)
+{
+    std::int32_t word;
+    std::memcpy(&word, input, sizeof(word));
+    return _mm512_set1_epi32(word);
+}
+
+void ComputeTile(const std::uint8_t* const* inputRows,
+                 const std::int8_t* packedWeight, std::size_t numGroups,
+                 std::size_t groupStride, std::int32_t* tile)
+{
+    __m512i c00 = _mm512_setzero_si512(), c01 = _mm512_setzero_si512();
+    __m512i c10 = _mm512_setzero_si512(), c11 = _mm512_setzero_si512();
+    __m512i c20 = _mm512_setzero_si512(), c21 = _mm512_setzero_si512();
+    __m512i c30 = _mm512_setzero_si512(), c31 = _mm512_setzero_si512();
+    __m512i c40 = _mm512_setzero_si512(), c41 = _mm512_setzero_si512();
+    __m512i c50 = _mm512_setzero_si512(), c51 = _mm512_setzero_si512();
+    __m512i c60 = _mm512_setzero_si512(), c61 = _mm512_setzero_si512();
+    __m512i c70 = _mm512_setzero_si512(), c71 = _mm512_setzero_si512();
+
+    //! dpbusd sums 4 u8 x s8 products into each int32 lane in one step
+    for (std::size_t group = 0; group < numGroups; ++group)
+    {
+        const auto* weight = packedWeight + group * groupStride;
+        const auto b0 = _mm512_loadu_si512(weight);
+        const auto b1 = _mm512_loadu_si512(weight + 64);
+        const auto offset = group * 4;
+
+        auto a = Broadcast(inputRows[0] + offset);
+        c00 = _mm512_dpbusd_epi32(c00, a, b0);
+        c01 = _mm512_dpbusd_epi32(c01, a, b1);
+        a = Broadcast(inputRows[1] + offset);
+        c10 = _mm512_dpbusd_epi32(c10, a, b0);
+        c11 = _mm512_dpbusd_epi32(c11, a, b1);
+        a = Broadcast(inputRows[2] + offset);
+        c20 = _mm512_dpbusd_epi32(c20, a, b0);
+        c21 = _mm512_dpbusd_epi32(c21, a, b1);
+        a = Broadcast(inputRows[3] + offset);
+        c30 = _mm512_dpbusd_epi32(c30, a, b0);
+        c31 = _mm512_dpbusd_epi32(c31, a, b1);
+        a = Broadcast(inputRows[4] + offset);
+        c40 = _mm512_dpbusd_epi32(c40, a, b0);
+        c41 = _mm512_dpbusd_epi32(c41, a, b1);
+        a = Broadcast(inputRows[5] + offset);
+        c50 = _mm512_dpbusd_epi32(c50, a, b0);
+        c51 = _mm512_dpbusd_epi32(c51, a, b1);
+        a = Broadcast(inputRows[6] + offset);
+        c60 = _mm512_dpbusd_epi32(c60, a, b0);
+        c61 = _mm512_dpbusd_epi32(c61, a, b1);
+        a = Broadcast(inputRows[7] + offset);
+        c70 = _mm512_dpbusd_epi32(c70, a, b0);
+        c71 = _mm512_dpbusd_epi32(c71, a, b1);
+    }
+
+    _mm512_store_si512(tile + 0 * NR, c00);
+    _mm512_store_si512(tile + 0 * NR + 16, c01);
+    _mm512_store_si512(tile + 1 * NR, c10);
+    _mm512_store_si512(tile + 1 * NR + 16, c11);
+    _mm512_store_si512(tile + 2 * NR, c20);
+    _mm512_store_si512(tile + 2 * NR + 16, c21);
+    _mm512_store_si512(tile + 3 * NR, c30);
+    _mm512_store_si512(tile + 3 * NR + 16, c31);
+    _mm512_store_si512(tile + 4 * NR, c40);
+    _mm512_store_si512(tile + 4 * NR + 16, c41);
+    _mm512_store_si512(tile + 5 * NR, c50);
+    _mm512_store_si512(tile + 5 * NR + 16, c51);
+    _mm512_store_si512(tile + 6 * NR, c60);
+    _mm512_store_si512(tile + 6 * NR + 16, c61);
+    _mm512_store_si512(tile + 7 * NR, c70);
+    _mm512_store_si512(tile + 7 * NR + 16, c71);
+}
+} // namespace
+
+MicroKernel GetAvx512VnniMicroKernel()
+{
+    return { MR, NR, ComputeTile };
+}
+} // namespace Takion::Compute::CPU::Int8
@@ -0,0 +1,183 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <Takion/Computations/InstructionSet.hpp>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace Takion::Compute
+{
+namespace
+{
+struct CpuIdResult
+{
+    unsigned int Eax = 0;
+    unsigned int Ebx = 0;
+    unsigned int Ecx = 0;
+    unsigned int Edx = 0;
+};
+
+CpuIdResult CpuId(unsigned int leaf, unsigned int subLeaf)
+{
+    CpuIdResult result;
+#ifdef _MSC_VER
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+    result.Eax = static_cast<unsigned int>(info[0]);
+    result.Ebx = static_cast<unsigned int>(info[1]);
+    result.Ecx = static_cast<unsigned int>(info[2]);
+    result.Edx = static_cast<unsigned int>(info[3]);
+#else
+    __cpuid_count(leaf, subLeaf, result.Eax, result.Ebx, result.Ecx,
+                  result.Edx);
+#endif
+    return result;
+}
+
+//! Reads XCR0, which tells which register states the operating system
+//! saves on context switches
+unsigned long long ReadXcr0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+struct CpuFeature
+{
+    bool Avx2 = false;
+    bool Avx512 = false;
+    bool Avx512Vnni = false;
+};
+
+CpuFeature DetectCpuFeature()
+{
+    CpuFeature feature;
+    if (CpuId(0, 0).Eax < 7)
+        return feature;
+
+    const auto leaf1 = CpuId(1, 0);
+    const auto hasFma = (leaf1.Ecx & (1u << 12)) != 0;
+    const auto hasOsXsave = (leaf1.Ecx & (1u << 27)) != 0;
+    const auto hasAvx = (leaf1.Ecx & (1u << 28)) != 0;
+    if (!hasOsXsave || !hasAvx)
+        return feature;
+
+    const auto xcr0 = ReadXcr0();
+    //! SSE and AVX states for ymm, plus opmask and upper zmm states
+    const auto hasYmmState = (xcr0 & 0x6) == 0x6;
+    const auto hasZmmState = (xcr0 & 0xe6) == 0xe6;
+
+    const auto leaf7 = CpuId(7, 0);
+    const auto hasAvx2 = (leaf7.Ebx & (1u << 5)) != 0;
+    const auto hasAvx512F = (leaf7.Ebx & (1u << 16)) != 0;
+    const auto hasAvx512Vnni = (leaf7.Ecx & (1u << 11)) != 0;
+
+    feature.Avx2 = hasYmmState && hasAvx2 && hasFma;
+    feature.Avx512 = feature.Avx2 && hasZmmState && hasAvx512F;
+    feature.Avx512Vnni = feature.Avx512 && hasAvx512Vnni;
+    return feature;
+}
+
+const CpuFeature& GetCpuFeature()
+{
+    static const CpuFeature feature = DetectCpuFeature();
+    return feature;
+}
+} // namespace
+
+bool IsSupported(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::AVX2:
+            return GetCpuFeature().Avx2;
+        case InstructionSet::AVX512:
+            return GetCpuFeature().Avx512;
+        case InstructionSet::AVX512VNNI:
+            return GetCpuFeature().Avx512Vnni;
+    }
+    return false;
+}
+
+InstructionSet GetNativeInstructionSet()
+{
+    if (IsSupported(InstructionSet::AVX512VNNI))
+        return InstructionSet::AVX512VNNI;
+    if (IsSupported(InstructionSet::AVX512))
+        return InstructionSet::AVX512;
+    if (IsSupported(InstructionSet::AVX2))
+        return InstructionSet::AVX2;
+
+    throw std::runtime_error(
+        "Takion requires processor with AVX2 and FMA support");
+}
+
+std::size_t VectorByteSize(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::AVX2:
+            return 32;
+        case InstructionSet::AVX512:
+        case InstructionSet::AVX512VNNI:
+            return 64;
+    }
+    throw std::invalid_argument("Unknown instruction set");
+}
+
+std::string ToString(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::AVX512:
+            return "AVX512";
+        case InstructionSet::AVX512VNNI:
+            return "AVX512VNNI";
+    }
+    throw std::invalid_argument("Unknown instruction set");
+}
+
+std::string GetProcessorName()
+{
+    if (CpuId(0x80000000u, 0).Eax < 0x80000004u)
+        return "Unknown";
+
+    //! 48 characters are returned in 3 leaves, padded with null characters
+    std::string name;
+    for (unsigned int leaf = 0x80000002u; leaf <= 0x80000004u; ++leaf)
+    {
+        const auto result = CpuId(leaf, 0);
+        for (const auto reg :
+             { result.Eax, result.Ebx, result.Ecx, result.Edx })
+            for (std::size_t byteIdx = 0; byteIdx < 4; ++byteIdx)
+            {
+                const auto c = static_cast<char>((reg >> (8 * byteIdx)) & 0xff);
+                if (c != '\0')
+                    name.push_back(c);
+            }
+    }
+
+    const auto begin = name.find_first_not_of(' ');
+    if (begin == std::string::npos)
+        return "Unknown";
+    const auto end = name.find_last_not_of(' ');
+    return name.substr(begin, end - begin + 1);
+}
+} // namespace Takion::Compute
@@ -0,0 +1,182 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <Takion/Engine/TaskExecutor.hpp>
+#include <omp.h>
+#include <stdexcept>
+
+namespace Takion::Engine
+{
+TaskExecutor::TaskExecutor(std::size_t numWorkers,
+                           std::size_t numThreadsPerWorker)
+{
+    if (numWorkers == 0)
+        throw std::invalid_argument("TaskExecutor requires at least 1 worker");
+
+    for (std::size_t workerIdx = 0; workerIdx < numWorkers; ++workerIdx)
+        m_queueVector.emplace_back(std::make_unique<WorkQueue>());
+
+    for (std::size_t workerIdx = 0; workerIdx < numWorkers; ++workerIdx)
+        m_workerVector.emplace_back(&TaskExecutor::m_workerLoop, this,
+                                    workerIdx, numThreadsPerWorker);
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_workCondition.notify_all();
+
+    for (auto& worker : m_workerVector)
+        worker.join();
+}
+
+void TaskExecutor::Run(
+    const std::function<void(std::size_t)>& task,
+    const std::vector<std::vector<std::size_t>>& successorVector,
+    const std::vector<std::size_t>& numDependencyVector)
+{
+    const auto numTasks = numDependencyVector.size();
+    if (successorVector.size() != numTasks)
+        throw std::invalid_argument(
+            "Number of successors and dependencies should be identical");
+    if (numTasks == 0)
+        return;
+
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+
+    m_task = &task;
+    m_successorVector = &successorVector;
+    m_exception = nullptr;
+    m_dependencyCount =
+        std::make_unique<std::atomic<std::size_t>[]>(numTasks);
+    for (std::size_t taskIdx = 0; taskIdx < numTasks; ++taskIdx)
+        m_dependencyCount[taskIdx] = numDependencyVector[taskIdx];
+    m_numRemainingTasks = numTasks;
+
+    //! Initial tasks are distributed round robin between the workers
+    std::size_t workerIdx = 0;
+    for (std::size_t taskIdx = 0; taskIdx < numTasks; ++taskIdx)
+        if (numDependencyVector[taskIdx] == 0)
+        {
+            m_push(workerIdx, taskIdx);
+            workerIdx = (workerIdx + 1) % m_queueVector.size();
+        }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() {
+            return m_numRemainingTasks.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    m_task = nullptr;
+    m_successorVector = nullptr;
+
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+}
+
+void TaskExecutor::m_workerLoop(std::size_t workerIdx, std::size_t numThreads)
+{
+    //! Tasks are parallelized internally with OpenMP, so each worker only
+    //! uses its share of the threads to avoid oversubscription
+    omp_set_num_threads(static_cast<int>(numThreads));
+
+    while (true)
+    {
+        std::size_t taskIdx = 0;
+        if (m_pop(workerIdx, taskIdx) || m_steal(workerIdx, taskIdx))
+        {
+            m_execute(workerIdx, taskIdx);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_workCondition.wait(lock, [this]() {
+            return m_stop || m_numQueuedTasks.load() > 0;
+        });
+        if (m_stop)
+            return;
+    }
+}
+
+void TaskExecutor::m_push(std::size_t workerIdx, std::size_t taskIdx)
+{
+    {
+        auto& queue = *m_queueVector[workerIdx];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.Deque.emplace_back(taskIdx);
+    }
+
+    //! Counter is updated under m_mutex so sleeping workers cannot miss it
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_numQueuedTasks.fetch_add(1);
+    }
+    m_workCondition.notify_one();
+}
+
+bool TaskExecutor::m_pop(std::size_t workerIdx, std::size_t& taskIdx)
+{
+    auto& queue = *m_queueVector[workerIdx];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    if (queue.Deque.empty())
+        return false;
+
+    taskIdx = queue.Deque.back();
+    queue.Deque.pop_back();
+    m_numQueuedTasks.fetch_sub(1);
+    return true;
+}
+
+bool TaskExecutor::m_steal(std::size_t workerIdx, std::size_t& taskIdx)
+{
+    const auto numWorkers = m_queueVector.size();
+    for (std::size_t offset = 1; offset < numWorkers; ++offset)
+    {
+        auto& queue = *m_queueVector[(workerIdx + offset) % numWorkers];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (queue.Deque.empty())
+            continue;
+
+        taskIdx = queue.Deque.front();
+        queue.Deque.pop_front();
+        m_numQueuedTasks.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void TaskExecutor::m_execute(std::size_t workerIdx, std::size_t taskIdx)
+{
+    try
+    {
+        (*m_task)(taskIdx);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exception)
+            m_exception = std::current_exception();
+    }
+
+    //! Successors are released even if the task failed, so Run always
+    //! drains the graph before reporting the exception
+    for (const auto successorIdx : (*m_successorVector)[taskIdx])
+        if (m_dependencyCount[successorIdx].fetch_sub(
+                1, std::memory_order_acq_rel) == 1)
+            m_push(workerIdx, successorIdx);
+
+    if (m_numRemainingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_doneCondition.notify_all();
+    }
+}
+} // namespace Takion::Engine
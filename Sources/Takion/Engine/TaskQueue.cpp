@@ -0,0 +1,87 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include <Takion/Engine/TaskQueue.hpp>
+#include <omp.h>
+
+namespace Takion::Engine
+{
+TaskQueue::TaskQueue(std::size_t numThreads)
+    : m_worker(&TaskQueue::m_workerLoop, this, numThreads)
+{
+}
+
+TaskQueue::~TaskQueue()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_numPendingTasks == 0; });
+        m_stop = true;
+    }
+    m_workCondition.notify_one();
+    m_worker.join();
+}
+
+void TaskQueue::Push(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_taskDeque.emplace_back(std::move(task));
+        ++m_numPendingTasks;
+    }
+    m_workCondition.notify_one();
+}
+
+void TaskQueue::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this]() { return m_numPendingTasks == 0; });
+
+    if (m_exception)
+    {
+        auto exception = m_exception;
+        m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskQueue::m_workerLoop(std::size_t numThreads)
+{
+    omp_set_num_threads(static_cast<int>(numThreads));
+
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workCondition.wait(
+                lock, [this]() { return m_stop || !m_taskDeque.empty(); });
+            if (m_taskDeque.empty())
+                return;
+            task = std::move(m_taskDeque.front());
+            m_taskDeque.pop_front();
+        }
+
+        std::exception_ptr exception;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (exception && !m_exception)
+                m_exception = exception;
+            --m_numPendingTasks;
+        }
+        m_doneCondition.notify_all();
+    }
+}
+} // namespace Takion::Engine
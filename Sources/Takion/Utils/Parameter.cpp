@@ -37,11 +37,24 @@ int Parameter::GetIntegerParam(const std::string& name) const
     return m_integerParameters.at(name);
 }
 
+int Parameter::GetIntegerParam(const std::string& name, int defaultValue) const
+{
+    const auto itr = m_integerParameters.find(name);
+    return itr == m_integerParameters.end() ? defaultValue : itr->second;
+}
+
 float Parameter::GetFloatingPointParam(const std::string& name) const
 {
     return m_floatingPointParameters.at(name);
 }
 
+float Parameter::GetFloatingPointParam(const std::string& name,
+                                       float defaultValue) const
+{
+    const auto itr = m_floatingPointParameters.find(name);
+    return itr == m_floatingPointParameters.end() ? defaultValue : itr->second;
+}
+
 std::string Parameter::GetStringParam(const std::string& name) const
 {
     return m_stringParameters.at(name);
@@ -0,0 +1,70 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+//! Measures throughput of compute kernels
+//! Kept out of UnitTests, since it only prints timings and takes seconds
+
+#include <Takion/Computations/GEMM/MathKernel.hpp>
+#include <Takion/Computations/Device.hpp>
+#include <Takion/Computations/Initializers/InitializerType.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace Takion::Benchmark
+{
+template <typename T>
+void BenchmarkMultiply(Compute::Device device, std::size_t numRow,
+                       std::size_t numMiddle, std::size_t numCol)
+{
+    const std::size_t numRepeat = 10;
+
+    Shape shapeA({ numRow, numMiddle });
+    Shape shapeB({ numMiddle, numCol });
+    Shape shapeOut({ numRow, numCol });
+
+    Tensor<T> A(shapeA, device);
+    Tensor<T> B(shapeB, device);
+    Tensor<T> result(shapeOut, device);
+
+    Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(0),
+                                                     static_cast<T>(1));
+    randomNormalInitializer.Initialize(A);
+    randomNormalInitializer.Initialize(B);
+
+    //! Warm up packing buffers and caches
+    Compute::Multiply(A, B, result);
+
+    const auto t1 = std::chrono::system_clock::now();
+    for (std::size_t i = 0; i < numRepeat; ++i)
+        Compute::Multiply(A, B, result);
+    const auto t2 = std::chrono::system_clock::now();
+
+    const auto elapsedTime =
+        std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+    const auto flops = 2.0 * static_cast<double>(numRow * numMiddle * numCol) *
+                       static_cast<double>(numRepeat);
+    const auto gFlops =
+        flops / (static_cast<double>(std::max<long long>(elapsedTime, 1)) *
+                 1e3);
+
+    std::cout << "Multiply (" << numRow << " x " << numMiddle << ") * ("
+        << numMiddle << " x " << numCol << ") : " << gFlops << " GFLOPS"
+        << std::endl;
+}
+} // namespace Takion::Benchmark
+
+int main()
+{
+    using namespace Takion;
+    using namespace Takion::Benchmark;
+
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    BenchmarkMultiply<float>(device, 256, 256, 256);
+    BenchmarkMultiply<float>(device, 1024, 1024, 1024);
+    BenchmarkMultiply<float>(device, 64, 784, 512);
+    return 0;
+}
@@ -11,8 +11,13 @@
 //TODO : Move Device.hpp to Util folder
 #include <Takion/Computations/Device.hpp>
 #include <Takion/Computations/Initializers/InitializerType.hpp>
+#include <Takion/Computations/Optimizers/Optimizer.hpp>
 #include "SolidComputations.hpp"
+#include <omp.h>
 #include <doctest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <type_traits>
 #include <iostream>
 
@@ -72,7 +77,10 @@ void TestMultiply(Compute::Device device)
     {
         const auto func = result.At(idx);
         const auto ans = truth.At(idx);
-        CHECK(func == ans);
+        if constexpr (std::is_floating_point_v<T>)
+            CHECK(func == doctest::Approx(ans).epsilon(1e-4));
+        else
+            CHECK(func == ans);
     }
 
     const auto optimizedMulElapsedTime =
@@ -133,7 +141,10 @@ void TestBroadcastMultiply1(Compute::Device device)
     {
         const auto func = result.At(idx);
         const auto ans = truth.At(idx);
-        CHECK(func == ans);
+        if constexpr (std::is_floating_point_v<T>)
+            CHECK(func == doctest::Approx(ans).epsilon(1e-4));
+        else
+            CHECK(func == ans);
     }
 
     const auto optimizedMulElapsedTime =
@@ -194,7 +205,10 @@ void TestBroadcastMultiply2(Compute::Device device)
     {
         const auto func = result.At(idx);
         const auto ans = truth.At(idx);
-        CHECK(func == ans);
+        if constexpr (std::is_floating_point_v<T>)
+            CHECK(func == doctest::Approx(ans).epsilon(1e-4));
+        else
+            CHECK(func == ans);
     }
 
     const auto optimizedMulElapsedTime =
@@ -207,6 +221,713 @@ void TestBroadcastMultiply2(Compute::Device device)
         << optimizedMulElapsedTime << std::endl;
 }
 
+template <typename T>
+void TestBatchReducedMultiply(Compute::Device device)
+{
+    const std::size_t batchSize = 37;
+    const std::size_t numInput = 53;
+    const std::size_t numOutput = 29;
+
+    Tensor<T> input(Shape({ numInput }), batchSize, device);
+    Tensor<T> delta(Shape({ numOutput }), batchSize, device);
+    Tensor<T> inputTranspose(Shape({ numInput, batchSize }), device);
+    Tensor<T> result(Shape({ numInput, numOutput }), device);
+
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(0),
+                                                         static_cast<T>(1));
+        randomNormalInitializer.Initialize(input);
+        randomNormalInitializer.Initialize(delta);
+    }
+    else
+    {
+        Compute::Ones<T> onesInitializer;
+        onesInitializer.Initialize(input);
+        onesInitializer.Initialize(delta);
+    }
+
+    Compute::Transpose(input, inputTranspose);
+    Compute::Multiply(inputTranspose, delta, result);
+
+    for (std::size_t rowIdx = 0; rowIdx < numInput; ++rowIdx)
+        for (std::size_t colIdx = 0; colIdx < numOutput; ++colIdx)
+        {
+            T sum = static_cast<T>(0);
+            for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+                sum += input.At(batchIdx, { rowIdx }) *
+                    delta.At(batchIdx, { colIdx });
+
+            const auto func = result.At(0, { rowIdx, colIdx });
+            if constexpr (std::is_floating_point_v<T>)
+                CHECK(func == doctest::Approx(sum).epsilon(1e-4));
+            else
+                CHECK(func == sum);
+        }
+}
+
+template <typename T>
+void TestTransposedMultiply(Compute::Device device)
+{
+    const std::size_t batchSize = 3;
+    const std::size_t m = 13;
+    const std::size_t k = 21;
+    const std::size_t n = 19;
+
+    Tensor<T> A(Shape({ m, k }), batchSize, device);
+    Tensor<T> transposedA(Shape({ k, m }), batchSize, device);
+    Tensor<T> B(Shape({ k, n }), batchSize, device);
+    Tensor<T> transposedB(Shape({ n, k }), batchSize, device);
+    Tensor<T> broadcastB(Shape({ n, k }), device);
+    Tensor<T> result(Shape({ m, n }), batchSize, device);
+    Tensor<T> reducedResult(Shape({ m, n }), device);
+
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(0),
+                                                         static_cast<T>(1));
+        randomNormalInitializer.Initialize(A);
+        randomNormalInitializer.Initialize(B);
+        randomNormalInitializer.Initialize(broadcastB);
+    }
+    else
+    {
+        Compute::Ones<T> onesInitializer;
+        onesInitializer.Initialize(A);
+        onesInitializer.Initialize(B);
+        onesInitializer.Initialize(broadcastB);
+    }
+
+    Compute::Transpose(A, transposedA);
+    Compute::Transpose(B, transposedB);
+
+    const auto check = [&](const Tensor<T>& out, std::size_t batchIdx,
+                           std::size_t rowIdx, std::size_t colIdx, T ans) {
+        const auto func = out.At(batchIdx, { rowIdx, colIdx });
+        if constexpr (std::is_floating_point_v<T>)
+            CHECK(func == doctest::Approx(ans).epsilon(1e-4));
+        else
+            CHECK(func == ans);
+    };
+
+    const auto product = [&](const Tensor<T>& rhs, std::size_t batchIdx,
+                             std::size_t rowIdx, std::size_t colIdx) {
+        T sum = static_cast<T>(0);
+        for (std::size_t idx = 0; idx < k; ++idx)
+            sum += A.At(batchIdx, { rowIdx, idx }) *
+                rhs.At(rhs.BatchSize == 1 ? 0 : batchIdx, { colIdx, idx });
+        return sum;
+    };
+
+    Compute::Multiply(A, transposedB, result, TransposeOp::NT);
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t rowIdx = 0; rowIdx < m; ++rowIdx)
+            for (std::size_t colIdx = 0; colIdx < n; ++colIdx)
+                check(result, batchIdx, rowIdx, colIdx,
+                      product(transposedB, batchIdx, rowIdx, colIdx));
+
+    Compute::Multiply(A, broadcastB, result, TransposeOp::NT);
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t rowIdx = 0; rowIdx < m; ++rowIdx)
+            for (std::size_t colIdx = 0; colIdx < n; ++colIdx)
+                check(result, batchIdx, rowIdx, colIdx,
+                      product(broadcastB, batchIdx, rowIdx, colIdx));
+
+    Compute::Multiply(transposedA, B, result, TransposeOp::TN);
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t rowIdx = 0; rowIdx < m; ++rowIdx)
+            for (std::size_t colIdx = 0; colIdx < n; ++colIdx)
+                check(result, batchIdx, rowIdx, colIdx,
+                      product(transposedB, batchIdx, rowIdx, colIdx));
+
+    //! Batch of transposedA and B is stacked along k and reduced
+    Compute::Multiply(transposedA, B, reducedResult, TransposeOp::TN);
+    for (std::size_t rowIdx = 0; rowIdx < m; ++rowIdx)
+        for (std::size_t colIdx = 0; colIdx < n; ++colIdx)
+        {
+            T sum = static_cast<T>(0);
+            for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+                sum += product(transposedB, batchIdx, rowIdx, colIdx);
+            check(reducedResult, 0, rowIdx, colIdx, sum);
+        }
+}
+
+template <typename T>
+void TestMultiplyBiasActivation(Compute::Device device, Activation activation)
+{
+    const std::size_t batchSize = 37;
+    const std::size_t numInput = 300;
+    const std::size_t numOutput = 45;
+
+    Tensor<T> input(Shape({ numInput }), batchSize, device);
+    Tensor<T> weight(Shape({ numInput, numOutput }), device);
+    Tensor<T> bias(Shape({ numOutput }), device);
+    Tensor<T> result(Shape({ numOutput }), batchSize, device);
+    Tensor<T> truth(Shape({ numOutput }), batchSize, device);
+
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(0),
+                                                         static_cast<T>(1));
+        randomNormalInitializer.Initialize(input);
+        randomNormalInitializer.Initialize(weight);
+        randomNormalInitializer.Initialize(bias);
+    }
+    else
+    {
+        Compute::Ones<T> onesInitializer;
+        onesInitializer.Initialize(input);
+        onesInitializer.Initialize(weight);
+        onesInitializer.Initialize(bias);
+    }
+
+    Compute::MultiplyBiasActivation(input, weight, bias, result, activation);
+
+    Compute::Multiply(input, weight, truth);
+    Compute::Add(bias, truth, truth);
+    Compute::Apply(truth, truth, [activation](T val) {
+        return Compute::ActivationForward(val, activation);
+    });
+
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t idx = 0; idx < numOutput; ++idx)
+        {
+            const auto func = result.At(batchIdx, { idx });
+            const auto ans = truth.At(batchIdx, { idx });
+            if constexpr (std::is_floating_point_v<T>)
+                CHECK(func == doctest::Approx(ans).epsilon(1e-4));
+            else
+                CHECK(func == ans);
+        }
+}
+
+//! Compares int8 quantized product with float product
+//! Error of quantized output is bounded relative to magnitude of the output
+inline void TestQuantizedMultiplyBiasActivation(Compute::Device device,
+                                                Activation activation)
+{
+    const std::size_t batchSize = 37;
+    const std::size_t numInput = 301;
+    const std::size_t numOutput = 45;
+
+    Tensor<float> input(Shape({ numInput }), batchSize, device);
+    Tensor<float> weight(Shape({ numInput, numOutput }), device);
+    Tensor<float> bias(Shape({ numOutput }), device);
+    Tensor<float> result(Shape({ numOutput }), batchSize, device);
+    Tensor<float> truth(Shape({ numOutput }), batchSize, device);
+
+    Compute::RandomNormal<float> randomNormalInitializer(0.0f, 1.0f);
+    randomNormalInitializer.Initialize(input);
+    randomNormalInitializer.Initialize(weight);
+    randomNormalInitializer.Initialize(bias);
+
+    const auto [min, max] = Compute::MinMax(input);
+    const auto quantizedWeight = Compute::CPU::Int8::QuantizeMatrix(
+        weight.Data, numInput, numOutput, weight.ColumnElementSize());
+    const auto inputRange = Compute::CPU::Int8::ComputeInputRange(min, max);
+
+    Compute::QuantizedMultiplyBiasActivation(input, quantizedWeight,
+                                             inputRange, bias, result,
+                                             activation);
+    Compute::MultiplyBiasActivation(input, weight, bias, truth, activation);
+
+    double squaredError = 0;
+    double squaredTruth = 0;
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t idx = 0; idx < numOutput; ++idx)
+        {
+            const double error =
+                result.At(batchIdx, { idx }) - truth.At(batchIdx, { idx });
+            squaredError += error * error;
+            squaredTruth += truth.At(batchIdx, { idx }) *
+                            truth.At(batchIdx, { idx });
+        }
+
+    //! Quantization error is about 2% of the output for this size, while
+    //! errors of the kernel (wrong column or zero point) exceed 50%
+    CHECK(std::sqrt(squaredError / squaredTruth) < 0.05);
+}
+
+inline void TestBFloat16MultiplyBiasActivation(Compute::Device device,
+                                               Activation activation)
+{
+    const std::size_t batchSize = 37;
+    const std::size_t numInput = 301;
+    const std::size_t numOutput = 45;
+
+    Tensor<float> input(Shape({ numInput }), batchSize, device);
+    Tensor<float> weight(Shape({ numInput, numOutput }), device);
+    Tensor<Compute::BFloat16> bFloat16Weight(Shape({ numInput, numOutput }),
+                                             device);
+    Tensor<float> roundedWeight(Shape({ numInput, numOutput }), device);
+    Tensor<float> bias(Shape({ numOutput }), device);
+    Tensor<float> result(Shape({ numOutput }), batchSize, device);
+    Tensor<float> truth(Shape({ numOutput }), batchSize, device);
+
+    Compute::RandomNormal<float> randomNormalInitializer(0.0f, 1.0f);
+    randomNormalInitializer.Initialize(input);
+    randomNormalInitializer.Initialize(weight);
+    randomNormalInitializer.Initialize(bias);
+
+    Compute::Convert(weight, bFloat16Weight);
+    Compute::Convert(bFloat16Weight, roundedWeight);
+
+    for (std::size_t row = 0; row < numInput; ++row)
+        for (std::size_t col = 0; col < numOutput; ++col)
+        {
+            const auto value = weight.At(0, { row, col });
+            const auto rounded = roundedWeight.At(0, { row, col });
+            CHECK(rounded == static_cast<float>(Compute::BFloat16(value)));
+            CHECK(std::abs(rounded - value) <= std::abs(value) / 256);
+        }
+
+    //! Products are accumulated in float, so the only difference from float
+    //! GEMM with rounded weights is the order of additions
+    Compute::MultiplyBiasActivation(input, bFloat16Weight, bias, result,
+                                    activation);
+    Compute::MultiplyBiasActivation(input, roundedWeight, bias, truth,
+                                    activation);
+
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t idx = 0; idx < numOutput; ++idx)
+            CHECK(result.At(batchIdx, { idx }) ==
+                  doctest::Approx(truth.At(batchIdx, { idx })).epsilon(1e-4));
+}
+
+inline void TestGemmTuning(Compute::Device device)
+{
+    using namespace Compute::CPU::Float;
+
+    const std::size_t batchSize = 3;
+    const std::size_t numRow = 131;
+    const std::size_t numCol = 70;
+    const std::size_t numMiddle = 300;
+
+    Tensor<float> A(Shape({ numRow, numMiddle }), batchSize, device);
+    Tensor<float> B(Shape({ numMiddle, numCol }), batchSize, device);
+    Tensor<float> result(Shape({ numRow, numCol }), batchSize, device);
+    Tensor<float> truth(Shape({ numRow, numCol }), batchSize, device);
+
+    Compute::RandomNormal<float> randomNormalInitializer(-10.0f, 10.0f);
+    randomNormalInitializer.Initialize(A);
+    randomNormalInitializer.Initialize(B);
+    Test::Multiply(A, B, truth);
+
+    const auto check = [&]() {
+        Compute::Multiply(A, B, result);
+        for (std::size_t idx = 0; idx < batchSize * numRow * numCol; ++idx)
+            CHECK(result.At(idx) ==
+                  doctest::Approx(truth.At(idx)).epsilon(1e-4));
+    };
+
+    ClearGemmBlocking();
+    Compute::TuneMultiply(A, B, result, TransposeOp::NN);
+    check();
+
+    //! Every block is smaller than the operands, and the partition differs
+    //! from the default
+    const auto shapeClass =
+        ClassifyGemm(numRow, result.ColumnElementSize(), numMiddle, batchSize,
+                     TransposeOp::NN, device.InstructionSet());
+    CHECK(IsGemmTuned(shapeClass));
+    GemmBlocking blocking;
+    blocking.MC = 48;
+    blocking.KC = 64;
+    blocking.NC = 32;
+    blocking.ParallelOverMatrices =
+        !DefaultGemmBlocking(batchSize).ParallelOverMatrices;
+    SetGemmBlocking(shapeClass, blocking);
+    check();
+
+    //! Blocking the micro kernel cannot use falls back to the default
+    SetGemmBlocking(shapeClass, GemmBlocking{ 50, 64, 512, false });
+    check();
+
+    const std::string path = "GemmTuningCacheTest.txt";
+    SetGemmBlocking(shapeClass, blocking);
+    SaveGemmTuningCache(path);
+    ClearGemmBlocking();
+    CHECK(!IsGemmTuned(shapeClass));
+    CHECK(LoadGemmTuningCache(path) == 1);
+
+    const auto loaded = GetGemmBlocking(shapeClass, batchSize);
+    CHECK(loaded.MC == blocking.MC);
+    CHECK(loaded.KC == blocking.KC);
+    CHECK(loaded.NC == blocking.NC);
+    CHECK(loaded.ParallelOverMatrices == blocking.ParallelOverMatrices);
+
+    std::remove(path.c_str());
+    ClearGemmBlocking();
+    CHECK(LoadGemmTuningCache(path) == 0);
+}
+
+//! Compares fused float update of the optimizer with its scalar double
+//! update over several steps
+template <template <typename> class TOptimizer, typename... Args>
+void TestOptimizer(Compute::Device device, Args... args)
+{
+    const std::size_t numSteps = 5;
+    const Shape shape({ 13, 37 });
+
+    TOptimizer<float> optimizer(args...);
+    TOptimizer<double> truthOptimizer(args...);
+
+    Tensor<float> tensor(shape, device);
+    Tensor<float> update(shape, device);
+    Tensor<double> truthTensor(shape, device);
+    Tensor<double> truthUpdate(shape, device);
+
+    const Compute::Zeros<float> zeroInitializer;
+    const Compute::Zeros<double> truthZeroInitializer;
+    Compute::OptimizerState<float> state;
+    Compute::OptimizerState<double> truthState;
+    for (std::size_t idx = 0; idx < optimizer.NumMoments(); ++idx)
+    {
+        state.MomentVector.emplace_back(shape, device);
+        truthState.MomentVector.emplace_back(shape, device);
+        zeroInitializer.Initialize(state.MomentVector.back());
+        truthZeroInitializer.Initialize(truthState.MomentVector.back());
+    }
+
+    Compute::RandomNormal<float> randomNormalInitializer(0.0f, 1.0f);
+    randomNormalInitializer.Initialize(tensor);
+    for (std::size_t idx = 0; idx < shape.Size(); ++idx)
+        truthTensor.At(idx) = tensor.At(idx);
+
+    for (std::size_t step = 0; step < numSteps; ++step)
+    {
+        randomNormalInitializer.Initialize(update);
+        for (std::size_t idx = 0; idx < shape.Size(); ++idx)
+            truthUpdate.At(idx) = update.At(idx);
+
+        optimizer.Optimize(tensor, update, state);
+        truthOptimizer.Optimize(truthTensor, truthUpdate, truthState);
+    }
+
+    CHECK(state.Step == numSteps);
+    for (std::size_t idx = 0; idx < shape.Size(); ++idx)
+        CHECK(tensor.At(idx) ==
+              doctest::Approx(truthTensor.At(idx)).epsilon(1e-4));
+}
+
+inline void TestConv2D(Compute::Device device, std::size_t stride,
+                       std::size_t padding, std::size_t dilation)
+{
+    const std::size_t batchSize = 3;
+    const std::size_t numFilter = 5;
+
+    Compute::Conv2DGeometry geometry;
+    geometry.InputChannels = 3;
+    geometry.InputHeight = 11;
+    geometry.InputWidth = 13;
+    geometry.KernelHeight = 3;
+    geometry.KernelWidth = 2;
+    geometry.StrideHeight = geometry.StrideWidth = stride;
+    geometry.PaddingHeight = geometry.PaddingWidth = padding;
+    geometry.DilationHeight = geometry.DilationWidth = dilation;
+
+    const auto numChannel = geometry.InputChannels;
+    const auto outputHeight = geometry.OutputHeight();
+    const auto outputWidth = geometry.OutputWidth();
+    const Shape inputShape(
+        { numChannel, geometry.InputHeight, geometry.InputWidth });
+    const Shape outputShape({ numFilter, outputHeight, outputWidth });
+
+    Tensor<float> input(inputShape, batchSize, device);
+    Tensor<float> weight(Shape({ numFilter, geometry.PatchSize() }), device);
+    Tensor<float> bias(Shape({ numFilter }), device);
+    Tensor<float> output(outputShape, batchSize, device);
+    Tensor<float> delta(outputShape, batchSize, device);
+    Tensor<float> column(
+        Shape({ geometry.PatchSize(),
+                outputHeight * output.ColumnElementSize() }),
+        batchSize, device);
+    Tensor<float> columnGradient(column);
+    Tensor<float> inputGradient(inputShape, batchSize, device);
+    Tensor<float> weightGradient(weight.TensorShape, device);
+    Tensor<float> biasGradient(bias.TensorShape, device);
+
+    Compute::RandomNormal<float> randomNormalInitializer(0.0f, 1.0f);
+    randomNormalInitializer.Initialize(input);
+    randomNormalInitializer.Initialize(weight);
+    randomNormalInitializer.Initialize(bias);
+    randomNormalInitializer.Initialize(delta);
+    Compute::CPU::Float::ClearPaddingCpu(
+        delta.Data, batchSize * numFilter * outputHeight, outputWidth,
+        delta.ColumnElementSize());
+
+    Compute::Conv2D(input, weight, bias, column, output, geometry,
+                    Activation::Linear);
+    Compute::Conv2DInputGradient(delta, weight, columnGradient,
+                                 inputGradient, geometry);
+    Compute::Conv2DWeightGradient(delta, column, weightGradient, biasGradient,
+                                  geometry);
+
+    //! Calls visitor with every (filter, output pixel, input pixel,
+    //! weight column) the convolution multiplies
+    const auto forEachTap = [&](std::size_t filterIdx, std::size_t outRow,
+                                std::size_t outCol, auto visitor) {
+        for (std::size_t channelIdx = 0; channelIdx < numChannel;
+             ++channelIdx)
+            for (std::size_t kRow = 0; kRow < geometry.KernelHeight; ++kRow)
+                for (std::size_t kCol = 0; kCol < geometry.KernelWidth;
+                     ++kCol)
+                {
+                    const auto row = static_cast<long>(
+                        outRow * stride + kRow * dilation) -
+                                     static_cast<long>(padding);
+                    const auto col = static_cast<long>(
+                        outCol * stride + kCol * dilation) -
+                                     static_cast<long>(padding);
+                    if (row < 0 || col < 0 ||
+                        row >= static_cast<long>(geometry.InputHeight) ||
+                        col >= static_cast<long>(geometry.InputWidth))
+                        continue;
+                    const auto weightCol =
+                        (channelIdx * geometry.KernelHeight + kRow) *
+                        geometry.KernelWidth + kCol;
+                    visitor(channelIdx, static_cast<std::size_t>(row),
+                            static_cast<std::size_t>(col),
+                            weight.At(0, { filterIdx, weightCol }),
+                            weightCol);
+                }
+    };
+
+    Tensor<float> inputGradientTruth(inputShape, batchSize, device);
+    Tensor<float> weightGradientTruth(weight.TensorShape, device);
+    Compute::Zeros<float> zeroInitializer;
+    zeroInitializer.Initialize(inputGradientTruth);
+    zeroInitializer.Initialize(weightGradientTruth);
+
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t filterIdx = 0; filterIdx < numFilter; ++filterIdx)
+            for (std::size_t outRow = 0; outRow < outputHeight; ++outRow)
+                for (std::size_t outCol = 0; outCol < outputWidth; ++outCol)
+                {
+                    const auto gradient =
+                        delta.At(batchIdx, { filterIdx, outRow, outCol });
+                    auto sum = bias.At(0, { filterIdx });
+                    forEachTap(filterIdx, outRow, outCol,
+                               [&](std::size_t channelIdx, std::size_t row,
+                                   std::size_t col, float weightValue,
+                                   std::size_t weightCol) {
+                                   const auto inputValue = input.At(
+                                       batchIdx, { channelIdx, row, col });
+                                   sum += weightValue * inputValue;
+                                   inputGradientTruth.At(
+                                       batchIdx, { channelIdx, row, col }) +=
+                                       weightValue * gradient;
+                                   weightGradientTruth.At(
+                                       0, { filterIdx, weightCol }) +=
+                                       inputValue * gradient /
+                                       static_cast<float>(batchSize);
+                               });
+                    CHECK(output.At(batchIdx, { filterIdx, outRow, outCol }) ==
+                          doctest::Approx(sum).epsilon(1e-4));
+                }
+
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t channelIdx = 0; channelIdx < numChannel;
+             ++channelIdx)
+            for (std::size_t row = 0; row < geometry.InputHeight; ++row)
+                for (std::size_t col = 0; col < geometry.InputWidth; ++col)
+                    CHECK(inputGradient.At(batchIdx,
+                                           { channelIdx, row, col }) ==
+                          doctest::Approx(inputGradientTruth.At(
+                                              batchIdx,
+                                              { channelIdx, row, col }))
+                              .epsilon(1e-4));
+
+    for (std::size_t filterIdx = 0; filterIdx < numFilter; ++filterIdx)
+    {
+        auto biasTruth = 0.0f;
+        for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+            for (std::size_t outRow = 0; outRow < outputHeight; ++outRow)
+                for (std::size_t outCol = 0; outCol < outputWidth; ++outCol)
+                    biasTruth +=
+                        delta.At(batchIdx, { filterIdx, outRow, outCol });
+        CHECK(biasGradient.At(0, { filterIdx }) ==
+              doctest::Approx(biasTruth / static_cast<float>(batchSize))
+                  .epsilon(1e-4));
+
+        for (std::size_t colIdx = 0; colIdx < geometry.PatchSize(); ++colIdx)
+            CHECK(weightGradient.At(0, { filterIdx, colIdx }) ==
+                  doctest::Approx(
+                      weightGradientTruth.At(0, { filterIdx, colIdx }))
+                      .epsilon(1e-4));
+    }
+}
+
+template <typename T>
+void TestTranscendental(Compute::Device device)
+{
+    const std::size_t batchSize = 7;
+    const std::size_t size = 1029;
+
+    Tensor<T> input(Shape({ size }), batchSize, device);
+    Tensor<T> positiveInput(Shape({ size }), batchSize, device);
+    Tensor<T> result(Shape({ size }), batchSize, device);
+
+    Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(0),
+                                                     static_cast<T>(10));
+    randomNormalInitializer.Initialize(input);
+    Compute::Apply(input, positiveInput,
+                   [](T value) { return std::abs(value) + T(1e-3); });
+
+    const auto check = [&](const Tensor<T>& source, const auto& function) {
+        for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+            for (std::size_t idx = 0; idx < size; ++idx)
+            {
+                const auto ans = function(
+                    static_cast<double>(source.At(batchIdx, { idx })));
+                CHECK(result.At(batchIdx, { idx }) ==
+                      doctest::Approx(ans).epsilon(1e-6).scale(0));
+            }
+    };
+
+    Compute::Exp(input, result);
+    check(input, [](double value) { return std::exp(value); });
+
+    Compute::Log(positiveInput, result);
+    check(positiveInput, [](double value) { return std::log(value); });
+
+    Compute::Sigmoid(input, result);
+    check(input, [](double value) { return 1 / (1 + std::exp(-value)); });
+
+    Compute::Tanh(input, result);
+    check(input, [](double value) { return std::tanh(value); });
+
+    Compute::SoftMax(input, result);
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+    {
+        double max = input.At(batchIdx, { 0 });
+        for (std::size_t idx = 0; idx < size; ++idx)
+            max = std::max(
+                max, static_cast<double>(input.At(batchIdx, { idx })));
+
+        double expSum = 0;
+        for (std::size_t idx = 0; idx < size; ++idx)
+            expSum += std::exp(input.At(batchIdx, { idx }) - max);
+
+        for (std::size_t idx = 0; idx < size; ++idx)
+            CHECK(result.At(batchIdx, { idx }) ==
+                  doctest::Approx(std::exp(input.At(batchIdx, { idx }) - max) /
+                                  expSum)
+                      .epsilon(1e-5));
+    }
+}
+
+template <typename T>
+void TestMapReduce(Compute::Device device)
+{
+    const std::size_t batchSize = 5;
+    const std::size_t numRow = 13;
+    const std::size_t numCol = 37;
+
+    Tensor<T> label(Shape({ numRow, numCol }), batchSize, device);
+    Tensor<T> prediction(Shape({ numRow, numCol }), batchSize, device);
+    Tensor<T> result(Shape({ numRow, numCol }), batchSize, device);
+
+    Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(0),
+                                                     static_cast<T>(10));
+    randomNormalInitializer.Initialize(label);
+    randomNormalInitializer.Initialize(prediction);
+
+    Compute::Map(
+        [](auto lhs, auto rhs) {
+            using Value = decltype(lhs);
+            return Compute::Vector::Select(lhs > rhs, lhs - rhs,
+                                           Compute::Vector::Tanh(rhs)) *
+                   Value(3);
+        },
+        result, label, prediction);
+
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+            for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+            {
+                const double lhs = label.At(batchIdx, { rowIdx, colIdx });
+                const double rhs = prediction.At(batchIdx, { rowIdx, colIdx });
+                const auto ans = (lhs > rhs ? lhs - rhs : std::tanh(rhs)) * 3;
+                CHECK(result.At(batchIdx, { rowIdx, colIdx }) ==
+                      doctest::Approx(ans).epsilon(1e-5));
+            }
+
+    const auto sum = Compute::MapReduce(
+        [](auto lhs, auto rhs) {
+            const auto diff = lhs - rhs;
+            return diff * diff / 2;
+        },
+        result, label, prediction);
+
+    double ansSum = 0;
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+            for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+            {
+                const double diff = label.At(batchIdx, { rowIdx, colIdx }) -
+                                    prediction.At(batchIdx, { rowIdx, colIdx });
+                ansSum += diff * diff / 2;
+                CHECK(result.At(batchIdx, { rowIdx, colIdx }) ==
+                      doctest::Approx(diff * diff / 2).epsilon(1e-5));
+            }
+
+    CHECK(sum == doctest::Approx(ansSum).epsilon(1e-5));
+}
+
+template <typename T>
+void TestSoftMaxCrossEntropy(Compute::Device device)
+{
+    const std::size_t batchSize = 5;
+    const std::size_t numClass = 1003;
+
+    Tensor<T> logit(Shape({ numClass }), batchSize, device);
+    Tensor<T> label(Shape({ numClass }), batchSize, device);
+    Tensor<T> probability(Shape({ numClass }), batchSize, device);
+    Tensor<T> gradient(Shape({ numClass }), batchSize, device);
+
+    //! Logits large enough to overflow exp without max subtraction
+    Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(0),
+                                                     static_cast<T>(100));
+    randomNormalInitializer.Initialize(logit);
+    Compute::Zeros<T> zeroInitializer;
+    zeroInitializer.Initialize(label);
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        label.At(batchIdx, { (batchIdx * 211) % numClass }) = 1;
+
+    const auto loss =
+        Compute::SoftMaxCrossEntropy(logit, label, probability);
+    Compute::SoftMaxCrossEntropyGradient(probability, label, gradient);
+
+    double truthLoss = 0;
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+    {
+        double max = logit.At(batchIdx, { 0 });
+        for (std::size_t idx = 0; idx < numClass; ++idx)
+            max = std::max(
+                max, static_cast<double>(logit.At(batchIdx, { idx })));
+
+        double expSum = 0;
+        for (std::size_t idx = 0; idx < numClass; ++idx)
+            expSum += std::exp(logit.At(batchIdx, { idx }) - max);
+
+        for (std::size_t idx = 0; idx < numClass; ++idx)
+        {
+            const auto z = static_cast<double>(logit.At(batchIdx, { idx }));
+            const auto y = static_cast<double>(label.At(batchIdx, { idx }));
+            const auto p = std::exp(z - max) / expSum;
+            truthLoss -= y * (z - max - std::log(expSum));
+
+            CHECK(probability.At(batchIdx, { idx }) ==
+                  doctest::Approx(p).epsilon(1e-5));
+            CHECK(gradient.At(batchIdx, { idx }) ==
+                  doctest::Approx(y - p).epsilon(1e-5));
+        }
+    }
+
+    CHECK(loss == doctest::Approx(truthLoss).epsilon(1e-5));
+}
+
 template <typename T>
 void TestTranspose(Compute::Device device)
 {
@@ -248,9 +969,34 @@ void TestTranspose(Compute::Device device)
                 {
                     CHECK(result.At(batchIdx, { idx, colIdx, rowIdx }) ==
                         truth.At(batchIdx, { idx, colIdx, rowIdx }));
+                    CHECK(result.At(batchIdx, { idx, colIdx, rowIdx }) ==
+                        in.At(batchIdx, { idx, rowIdx, colIdx }));
                 }
 }
 
+template <typename T>
+void TestTransposeBatchFold(Compute::Device device)
+{
+    const std::size_t batchSize = 6;
+    const std::size_t numRow = 13;
+    const std::size_t numCol = 29;
+
+    Tensor<T> in(Shape({ numRow, numCol }), batchSize, device);
+    Tensor<T> result(Shape({ numCol, numRow * batchSize }), device);
+
+    for (std::size_t idx = 0; idx < numRow * numCol * batchSize; ++idx)
+        in.At(idx) = static_cast<T>(idx);
+
+    //! Batches are stacked along the rows before transposing
+    Compute::Transpose(in, result);
+
+    for (std::size_t batchIdx = 0; batchIdx < batchSize; ++batchIdx)
+        for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
+            for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
+                CHECK(result.At(0, { colIdx, batchIdx * numRow + rowIdx }) ==
+                      in.At(batchIdx, { rowIdx, colIdx }));
+}
+
 template <typename T>
 void TestShrink(Compute::Device device)
 {
@@ -293,7 +1039,11 @@ void TestShrink(Compute::Device device)
             {
                 const auto resultVal = result.At(0, { idx, rowIdx, colIdx });
                 const auto truthVal = truth.At(0, { idx, rowIdx, colIdx });
-                CHECK(resultVal == truthVal);
+                //! Batch may be summed in different order from the truth
+                if constexpr (std::is_floating_point_v<T>)
+                    CHECK(resultVal == doctest::Approx(truthVal));
+                else
+                    CHECK(resultVal == truthVal);
             }
 
     const auto optimizedMulElapsedTime =
@@ -306,6 +1056,40 @@ void TestShrink(Compute::Device device)
         << optimizedMulElapsedTime << std::endl;
 }
 
+template <typename T>
+void TestShrinkDeterministic(Compute::Device device)
+{
+    const std::size_t batchSize = 1000;
+    const std::size_t size = 37;
+
+    Tensor<T> in(Shape({ size }), batchSize, device);
+    Tensor<T> truth(Shape({ size }), device);
+    Tensor<T> result(Shape({ size }), device);
+    Tensor<T> resultSingleThread(Shape({ size }), device);
+
+    Compute::RandomNormal<T> randomNormalInitializer(static_cast<T>(-10),
+                                                     static_cast<T>(10));
+    randomNormalInitializer.Initialize(in);
+    Compute::Zeros<T>().Initialize(truth);
+    Test::Shrink(in, truth);
+
+    //! Previous contents of the output should be overwritten
+    Compute::Ones<T>().Initialize(result);
+    Compute::Ones<T>().Initialize(resultSingleThread);
+
+    const auto numThreads = omp_get_max_threads();
+    Compute::Shrink(in, result, true);
+    omp_set_num_threads(1);
+    Compute::Shrink(in, resultSingleThread, true);
+    omp_set_num_threads(numThreads);
+
+    for (std::size_t idx = 0; idx < size; ++idx)
+    {
+        CHECK(result.At(0, { idx }) == doctest::Approx(truth.At(0, { idx })));
+        CHECK(result.At(0, { idx }) == resultSingleThread.At(0, { idx }));
+    }
+}
+
 template <typename T>
 void TestAdd(Compute::Device device)
 {
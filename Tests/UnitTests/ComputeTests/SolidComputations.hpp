@@ -96,8 +96,8 @@ void Transpose(const Tensor<T>& in, Tensor<T>& out)
         for (std::size_t rowIdx = 0; rowIdx < numRow; ++rowIdx)
             for (std::size_t colIdx = 0; colIdx < numCol; ++colIdx)
             {
-                out.At(matOffset + numCol * rowIdx + colIdx) =
-                    in.At(matOffset + numRow * colIdx + rowIdx);
+                out.At(matOffset + numRow * colIdx + rowIdx) =
+                    in.At(matOffset + numCol * rowIdx + colIdx);
             }
     }
 }
@@ -0,0 +1,1001 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include "EngineTest.hpp"
+#include <Takion/Computations/GEMM/GemmTuner.hpp>
+#include <Takion/FrontEnd/Model.hpp>
+#include <doctest.h>
+#include <omp.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace Takion::Test
+{
+using namespace FrontEnd;
+
+namespace
+{
+std::vector<float> RandomVector(std::size_t size, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<float> vector(size);
+    for (auto& elem : vector)
+        elem = normal(engine);
+    return vector;
+}
+
+//! Returns consecutive batches of the data set, starting over at its end
+//! Number of calls is counted in numCalls if it is given
+class BatchLoader : public Util::Loader<float>
+{
+public:
+    BatchLoader(Shape shape, std::size_t batchSize, std::vector<float> dataSet,
+                std::shared_ptr<std::atomic<std::size_t>> numCalls = nullptr)
+        : Util::Loader<float>(shape, batchSize),
+          m_dataSet(std::move(dataSet)),
+          m_batchElementSize(shape.Size() * batchSize),
+          m_numCalls(std::move(numCalls))
+    {
+    }
+
+    std::vector<float> operator()() override
+    {
+        if (m_numCalls)
+            m_numCalls->fetch_add(1);
+
+        const auto numBatches = m_dataSet.size() / m_batchElementSize;
+        const auto begin = m_dataSet.begin() + static_cast<long>(
+                               (m_cycle++ % numBatches) * m_batchElementSize);
+        return std::vector<float>(begin,
+                                  begin + static_cast<long>(
+                                      m_batchElementSize));
+    }
+
+private:
+    std::vector<float> m_dataSet;
+    std::size_t m_batchElementSize;
+    std::shared_ptr<std::atomic<std::size_t>> m_numCalls;
+    std::size_t m_cycle = 0;
+};
+
+//! Fetcher feeding two dense units, each of them trained by its own loss
+struct BranchGraph
+{
+    AbsTensor<float> Input;
+    AbsTensor<float> Label;
+    AbsTensor<float> Left;
+    AbsTensor<float> Right;
+    AbsTensor<float> LeftLoss;
+    AbsTensor<float> RightLoss;
+};
+
+//! Adds the branch graph to the model
+//! Fetchers load dataSetSize samples in batches of the model's batch size
+BranchGraph AddBranchGraph(
+    Model<float>& model, std::size_t batchSize, std::size_t dataSetSize,
+    std::shared_ptr<std::atomic<std::size_t>> numCalls = nullptr)
+{
+    const Shape inputShape({ 12 });
+    const Shape labelShape({ 4 });
+
+    const auto input = model.Fetcher(
+        inputShape,
+        std::make_unique<BatchLoader>(inputShape, batchSize,
+                                      RandomVector(dataSetSize * 12, 3),
+                                      std::move(numCalls)),
+        "input");
+    const auto label = model.Fetcher(
+        labelShape,
+        std::make_unique<BatchLoader>(labelShape, batchSize,
+                                      RandomVector(dataSetSize * 4, 4)),
+        "label");
+    const auto left = model.Dense(input, 4);
+    const auto right = model.Dense(input, 4);
+    const auto leftLoss = model.MSE(left, label, "leftLoss");
+    const auto rightLoss = model.MSE(right, label, "rightLoss");
+
+    return BranchGraph{ input, label, left, right, leftLoss, rightLoss };
+}
+
+Parameter SgdParameter()
+{
+    return Parameter({}, { { "LearningRate", 0.01f } }, {});
+}
+
+//! Trainable tensors of the branch graph without padding of the slab
+std::vector<float> BranchGraphParameters(Model<float>& model,
+                                         const BranchGraph& graph)
+{
+    std::vector<float> parameters;
+    for (const auto& unit : { graph.Left, graph.Right })
+        for (const auto* key : { "weight", "bias" })
+        {
+            const auto tensor = model.TrainableTensor(unit, key);
+            parameters.insert(parameters.end(), tensor.Data.begin(),
+                              tensor.Data.end());
+        }
+    return parameters;
+}
+
+void CheckApproxEqual(const std::vector<float>& lhs,
+                      const std::vector<float>& rhs)
+{
+    CHECK(lhs.size() == rhs.size());
+    for (std::size_t idx = 0; idx < std::min(lhs.size(), rhs.size()); ++idx)
+        CHECK(lhs[idx] == doctest::Approx(rhs[idx]));
+}
+} // namespace
+
+void TestFusedActivationOutput()
+{
+    const std::size_t batchSize = 4;
+    Model<float> model(Compute::Device(0, Compute::DeviceType::CPU, "device0"),
+                       batchSize);
+
+    const auto input = model.Constant(
+        Shape({ 12 }), RandomVector(batchSize * 12, 1), "input");
+    const auto label = model.Constant(
+        Shape({ 3 }), RandomVector(batchSize * 3, 2), "label");
+    const auto dense = model.Dense(input, 8);
+    const auto relu = model.ReLU(dense);
+    const auto output = model.Dense(relu, 3);
+    model.MSE(output, label, "loss");
+
+    model.Compile("SGD", Parameter({}, { { "LearningRate", 0.01f } }, {}));
+    model.Predict();
+
+    CHECK_THROWS(model.Output(dense));
+
+    //! Kept dense unit computes its own output, and ReLU runs separately
+    Model<float> keptModel(
+        Compute::Device(0, Compute::DeviceType::CPU, "device0"), batchSize);
+
+    const auto keptInput = keptModel.Constant(
+        Shape({ 12 }), RandomVector(batchSize * 12, 1), "input");
+    const auto keptLabel = keptModel.Constant(
+        Shape({ 3 }), RandomVector(batchSize * 3, 2), "label");
+    const auto keptDense = keptModel.Dense(keptInput, 8);
+    const auto keptRelu = keptModel.ReLU(keptDense);
+    const auto keptOutput = keptModel.Dense(keptRelu, 3);
+    keptModel.MSE(keptOutput, keptLabel, "loss");
+    keptModel.KeepOutput(keptDense);
+
+    keptModel.Compile("SGD",
+                      Parameter({}, { { "LearningRate", 0.01f } }, {}));
+    CHECK(keptModel.ForwardSchedule().size() ==
+          model.ForwardSchedule().size() + 1);
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  keptModel.ParameterSlab());
+    keptModel.Predict();
+
+    const auto keptDenseOutput = keptModel.Output(keptDense);
+    const auto keptReluOutput = keptModel.Output(keptRelu);
+    CHECK(keptReluOutput.Data == model.Output(relu).Data);
+    for (std::size_t idx = 0; idx < keptDenseOutput.Data.size(); ++idx)
+    {
+        const auto elem = keptDenseOutput.Data[idx];
+        CHECK(keptReluOutput.Data[idx] ==
+              doctest::Approx(elem > 0.0f ? elem : elem * 0.1f));
+    }
+
+    //! Dense unit with more than one consumer keeps its own output
+    Model<float> branchModel(
+        Compute::Device(0, Compute::DeviceType::CPU, "device0"), batchSize);
+
+    const auto branchInput = branchModel.Constant(
+        Shape({ 12 }), RandomVector(batchSize * 12, 1), "input");
+    const auto branchLabel = branchModel.Constant(
+        Shape({ 8 }), RandomVector(batchSize * 8, 2), "label");
+    const auto branchDense = branchModel.Dense(branchInput, 8);
+    const auto branchRelu = branchModel.ReLU(branchDense);
+    branchModel.MSE(branchRelu, branchLabel, "reluLoss");
+    branchModel.MSE(branchDense, branchLabel, "denseLoss");
+
+    branchModel.Compile("SGD",
+                        Parameter({}, { { "LearningRate", 0.01f } }, {}));
+    branchModel.Predict();
+
+    const auto denseOutput = branchModel.Output(branchDense);
+    const auto reluOutput = branchModel.Output(branchRelu);
+    CHECK(denseOutput.Data != reluOutput.Data);
+    for (std::size_t idx = 0; idx < denseOutput.Data.size(); ++idx)
+    {
+        const auto elem = denseOutput.Data[idx];
+        CHECK(reluOutput.Data[idx] ==
+              doctest::Approx(elem > 0.0f ? elem : elem * 0.1f));
+    }
+}
+
+void TestRecompile()
+{
+    const std::size_t batchSize = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    //! Dense -> ReLU -> Sigmoid fuses only the ReLU, and Dense -> ReLU ->
+    //! SoftMax -> CrossEntropy fuses both pairs
+    struct RecompileGraph
+    {
+        AbsTensor<float> Sigmoid;
+        AbsTensor<float> SoftMax;
+        AbsTensor<float> MseLoss;
+        AbsTensor<float> CrossEntropyLoss;
+    };
+    const auto addGraph = [batchSize](Model<float>& model) {
+        const auto input = model.Constant(
+            Shape({ 12 }), RandomVector(batchSize * 12, 1), "input");
+        const auto label = model.Constant(
+            Shape({ 4 }), RandomVector(batchSize * 4, 2), "label");
+        const auto sigmoid = model.Sigmoid(model.ReLU(model.Dense(input, 4)));
+        const auto softMax = model.SoftMax(model.ReLU(model.Dense(input, 4)));
+        return RecompileGraph{ sigmoid, softMax, model.MSE(sigmoid, label, "mse"),
+                      model.CrossEntropy(softMax, label, "crossEntropy") };
+    };
+
+    Model<float> model(device, batchSize);
+    const auto graph = addGraph(model);
+    model.Compile("SGD", SgdParameter());
+    const auto schedule = model.ForwardSchedule();
+    model.Compile("SGD", SgdParameter());
+    CHECK(model.ForwardSchedule() == schedule);
+
+    Model<float> referenceModel(device, batchSize);
+    const auto referenceGraph = addGraph(referenceModel);
+    referenceModel.Compile("SGD", SgdParameter());
+    CHECK(referenceModel.ParameterSlab().TotalElementSize() ==
+          model.ParameterSlab().TotalElementSize());
+    Tensor<float>::CopyTensorData(referenceModel.ParameterSlab(),
+                                  model.ParameterSlab());
+
+    model.Predict();
+    referenceModel.Predict();
+    CHECK(model.Output(graph.Sigmoid).Data ==
+          referenceModel.Output(referenceGraph.Sigmoid).Data);
+    CHECK(model.Output(graph.SoftMax).Data ==
+          referenceModel.Output(referenceGraph.SoftMax).Data);
+    CHECK(model.GetLoss(graph.MseLoss) ==
+          doctest::Approx(referenceModel.GetLoss(referenceGraph.MseLoss)));
+    CHECK(model.GetLoss(graph.CrossEntropyLoss) ==
+          doctest::Approx(
+              referenceModel.GetLoss(referenceGraph.CrossEntropyLoss)));
+}
+
+void TestExecutionPlan()
+{
+    Model<float> model(Compute::Device(0, Compute::DeviceType::CPU, "device0"),
+                       4);
+    const auto graph = AddBranchGraph(model, 4, 4);
+    model.Compile("SGD", SgdParameter());
+
+    //! Sources run first, and each unit waits for every unit it reads
+    const std::vector<std::pair<UnitId, std::size_t>> forwardSchedule = {
+        { graph.Input.GetPrevOutput(), 0 },
+        { graph.Label.GetPrevOutput(), 0 },
+        { graph.Left.GetPrevOutput(), 1 },
+        { graph.Right.GetPrevOutput(), 1 },
+        { graph.LeftLoss.GetPrevOutput(), 2 },
+        { graph.RightLoss.GetPrevOutput(), 2 },
+    };
+    CHECK(model.ForwardSchedule() == forwardSchedule);
+
+    //! Back propagation runs in reverse, and sources are not scheduled
+    const std::vector<std::pair<UnitId, std::size_t>> backwardSchedule = {
+        { graph.RightLoss.GetPrevOutput(), 0 },
+        { graph.LeftLoss.GetPrevOutput(), 0 },
+        { graph.Right.GetPrevOutput(), 1 },
+        { graph.Left.GetPrevOutput(), 1 },
+    };
+    CHECK(model.BackwardSchedule() == backwardSchedule);
+}
+
+void TestAsyncTrainEquivalence()
+{
+    const std::size_t batchSize = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    Model<float> model(device, batchSize);
+    const auto graph = AddBranchGraph(model, batchSize, batchSize * 3);
+    model.Compile("SGD", SgdParameter());
+
+    Model<float> asyncModel(device, batchSize);
+    const auto asyncGraph = AddBranchGraph(asyncModel, batchSize,
+                                           batchSize * 3);
+    asyncModel.Compile("SGD", SgdParameter());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  asyncModel.ParameterSlab());
+
+    for (std::size_t cycle = 0; cycle < 10; ++cycle)
+    {
+        model.Train();
+        asyncModel.AsyncTrain();
+        CHECK(asyncModel.GetLoss(asyncGraph.LeftLoss) ==
+              doctest::Approx(model.GetLoss(graph.LeftLoss)));
+        CHECK(asyncModel.GetLoss(asyncGraph.RightLoss) ==
+              doctest::Approx(model.GetLoss(graph.RightLoss)));
+    }
+
+    CheckApproxEqual(BranchGraphParameters(asyncModel, asyncGraph),
+                     BranchGraphParameters(model, graph));
+}
+
+void TestPrefetchedFit()
+{
+    const std::size_t batchSize = 4;
+    const std::size_t epochs = 7;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    const auto numCalls = std::make_shared<std::atomic<std::size_t>>(0);
+    Model<float> model(device, batchSize);
+    const auto graph = AddBranchGraph(model, batchSize, batchSize * 3,
+                                      numCalls);
+    model.Compile("SGD", SgdParameter());
+
+    const auto numPrefetchedCalls =
+        std::make_shared<std::atomic<std::size_t>>(0);
+    Model<float> prefetchedModel(device, batchSize);
+    const auto prefetchedGraph = AddBranchGraph(
+        prefetchedModel, batchSize, batchSize * 3, numPrefetchedCalls);
+    prefetchedModel.Compile("SGD", SgdParameter());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  prefetchedModel.ParameterSlab());
+
+    model.Fit(epochs, 0);
+    prefetchedModel.Fit(epochs, 2);
+
+    CHECK(*numCalls == epochs);
+    CHECK(*numPrefetchedCalls == epochs);
+    CHECK(BranchGraphParameters(prefetchedModel, prefetchedGraph) ==
+          BranchGraphParameters(model, graph));
+}
+
+void TestArenaPlanning()
+{
+    const std::size_t batchSize = 8;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    //! Trunk feeding a short and a long branch, so gradients of one branch
+    //! can reuse memory of the other only where the plan orders them
+    const auto addGraph = [batchSize](Model<float>& model) {
+        const Shape inputShape({ 32 });
+        const Shape labelShape({ 4 });
+        const auto input = model.Fetcher(
+            inputShape,
+            std::make_unique<BatchLoader>(inputShape, batchSize,
+                                          RandomVector(batchSize * 2 * 32, 5)),
+            "input");
+        const auto label = model.Fetcher(
+            labelShape,
+            std::make_unique<BatchLoader>(labelShape, batchSize,
+                                          RandomVector(batchSize * 2 * 4, 6)),
+            "label");
+        const auto trunk = model.Dense(input, 64);
+        const auto trunkRelu = model.ReLU(trunk);
+        const auto shortBranch = model.Dense(trunkRelu, 4);
+        const auto longBranch = model.Dense(trunkRelu, 64);
+        const auto longBranchRelu = model.ReLU(longBranch);
+        const auto longBranchOutput = model.Dense(longBranchRelu, 32);
+        const auto longBranchSigmoid = model.Sigmoid(longBranchOutput);
+        const auto longBranchLast = model.Dense(longBranchSigmoid, 4);
+        const auto shortLoss = model.MSE(shortBranch, label, "shortLoss");
+        const auto longLoss = model.MSE(longBranchLast, label, "longLoss");
+        return std::vector<AbsTensor<float>>{ trunk,
+                                              shortBranch,
+                                              longBranch,
+                                              longBranchOutput,
+                                              longBranchLast,
+                                              shortLoss,
+                                              longLoss };
+    };
+    const auto parameters = [](Model<float>& model,
+                               const std::vector<AbsTensor<float>>& units) {
+        std::vector<float> parameterVector;
+        for (std::size_t idx = 0; idx < 5; ++idx)
+            for (const auto* key : { "weight", "bias" })
+            {
+                const auto tensor = model.TrainableTensor(units[idx], key);
+                parameterVector.insert(parameterVector.end(),
+                                       tensor.Data.begin(), tensor.Data.end());
+            }
+        return parameterVector;
+    };
+
+    Model<float> model(device, batchSize);
+    const auto units = addGraph(model);
+    model.Compile("SGD", SgdParameter());
+    CHECK(model.ArenaByteSize() > 0);
+    CHECK(model.ArenaByteSize() < model.PlannedTensorByteSize());
+
+    //! Worker pool runs branches concurrently, which is only safe if tensors
+    //! sharing memory are ordered by the plan
+    Model<float> asyncModel(device, batchSize);
+    const auto asyncUnits = addGraph(asyncModel);
+    asyncModel.Compile("SGD", SgdParameter());
+    CHECK(asyncModel.ArenaByteSize() == model.ArenaByteSize());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  asyncModel.ParameterSlab());
+
+    //! Reference where every tensor has its own memory
+    Model<float> referenceModel(device, batchSize);
+    const auto referenceUnits = addGraph(referenceModel);
+    referenceModel.SetMemorySharing(false);
+    referenceModel.Compile("SGD", SgdParameter());
+    CHECK(referenceModel.ArenaByteSize() >= model.PlannedTensorByteSize());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  referenceModel.ParameterSlab());
+
+    for (std::size_t cycle = 0; cycle < 10; ++cycle)
+    {
+        model.Train();
+        asyncModel.AsyncTrain();
+        referenceModel.Train();
+        for (const auto lossIdx : { 5, 6 })
+        {
+            const auto loss = referenceModel.GetLoss(referenceUnits[lossIdx]);
+            CHECK(model.GetLoss(units[lossIdx]) == doctest::Approx(loss));
+            CHECK(asyncModel.GetLoss(asyncUnits[lossIdx]) ==
+                  doctest::Approx(loss));
+        }
+    }
+
+    const auto referenceParameters =
+        parameters(referenceModel, referenceUnits);
+    CheckApproxEqual(parameters(model, units), referenceParameters);
+    CheckApproxEqual(parameters(asyncModel, asyncUnits), referenceParameters);
+}
+
+void TestConv2DTraining()
+{
+    const std::size_t batchSize = 4;
+    const std::size_t dataSetSize = batchSize * 3;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    //! (2, 6, 6) -> Conv2D -> ReLU -> (4, 6, 6) -> Conv2D -> Sigmoid ->
+    //! (3, 2, 2), where both activations are fused into the convolutions
+    struct ConvGraph
+    {
+        AbsTensor<float> First;
+        AbsTensor<float> Second;
+        AbsTensor<float> Loss;
+    };
+    const auto addGraph = [&](Model<float>& model) {
+        const Shape inputShape({ 2, 6, 6 });
+        const Shape labelShape({ 3, 2, 2 });
+        const auto input = model.Fetcher(
+            inputShape,
+            std::make_unique<BatchLoader>(
+                inputShape, batchSize,
+                RandomVector(dataSetSize * inputShape.Size(), 3)),
+            "input");
+        const auto label = model.Fetcher(
+            labelShape,
+            std::make_unique<BatchLoader>(
+                labelShape, batchSize,
+                RandomVector(dataSetSize * labelShape.Size(), 4)),
+            "label");
+        const auto first = model.Conv2D(input, 4, 3, 3, 1, 1);
+        const auto second = model.Conv2D(model.ReLU(first), 3, 3, 3, 2);
+        const auto loss = model.MSE(model.Sigmoid(second), label, "loss");
+        return ConvGraph{ first, second, loss };
+    };
+
+    Model<float> model(device, batchSize);
+    const auto graph = addGraph(model);
+    model.Compile("SGD", SgdParameter());
+    for (const auto& [unitId, numDependencies] : model.ForwardSchedule())
+    {
+        CHECK(unitId.Type.Name() != "ReLU");
+        CHECK(unitId.Type.Name() != "Sigmoid");
+    }
+
+    //! Every tensor, including scratch tensors of back propagation, gets
+    //! its own range of the arena
+    Model<float> unsharedModel(device, batchSize);
+    const auto unsharedGraph = addGraph(unsharedModel);
+    unsharedModel.SetMemorySharing(false);
+    unsharedModel.Compile("SGD", SgdParameter());
+    CHECK(model.ArenaByteSize() < unsharedModel.ArenaByteSize());
+
+    CHECK(unsharedModel.ParameterSlab().TotalElementSize() ==
+          model.ParameterSlab().TotalElementSize());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  unsharedModel.ParameterSlab());
+
+    for (std::size_t cycle = 0; cycle < 10; ++cycle)
+    {
+        model.Train();
+        unsharedModel.Train();
+        CHECK(model.GetLoss(graph.Loss) ==
+              doctest::Approx(unsharedModel.GetLoss(unsharedGraph.Loss)));
+    }
+
+    for (const auto& [unit, unsharedUnit] :
+         { std::pair{ graph.First, unsharedGraph.First },
+           std::pair{ graph.Second, unsharedGraph.Second } })
+        for (const auto* key : { "weight", "bias" })
+            CheckApproxEqual(
+                model.TrainableTensor(unit, key).Data,
+                unsharedModel.TrainableTensor(unsharedUnit, key).Data);
+}
+
+void TestGemmTuningCompile()
+{
+    using namespace Compute::CPU::Float;
+
+    const std::size_t batchSize = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+    const std::string path = "GemmTuningCompileTest.txt";
+    std::remove(path.c_str());
+    ClearGemmBlocking();
+
+    //! First compilation benchmarks shapes of forward and back propagation
+    //! and saves them
+    Model<float> model(device, batchSize);
+    AddBranchGraph(model, batchSize, batchSize);
+    model.EnableGemmTuning(path);
+    model.Compile("SGD", SgdParameter());
+
+    ClearGemmBlocking();
+    const auto numEntries = LoadGemmTuningCache(path);
+    CHECK(numEntries >= 3);
+
+    //! Entries are replaced by a blocking no benchmark picks, so the file
+    //! only keeps it if the next compilation does not benchmark again
+    const std::string blocking = "42 40 48 0";
+    const auto rewriteEntries = [&path](const std::string& newBlocking) {
+        std::ifstream input(path);
+        std::ostringstream stream;
+        std::size_t numRewritten = 0;
+        for (std::string line; std::getline(input, line);)
+        {
+            if (line.empty() || line.front() == '#' || line.front() == '[')
+            {
+                stream << line << "\n";
+                continue;
+            }
+
+            //! Instruction set, op and the four dimensions are kept
+            std::istringstream lineStream(line);
+            std::string token;
+            for (std::size_t idx = 0; idx < 6 && lineStream >> token; ++idx)
+                stream << token << " ";
+            stream << newBlocking << "\n";
+            ++numRewritten;
+        }
+        input.close();
+        std::ofstream(path, std::ios::trunc) << stream.str();
+        return numRewritten;
+    };
+    CHECK(rewriteEntries(blocking) == numEntries);
+
+    //! Second compilation loads every shape from the cache
+    ClearGemmBlocking();
+    Model<float> cachedModel(device, batchSize);
+    AddBranchGraph(cachedModel, batchSize, batchSize);
+    cachedModel.EnableGemmTuning(path);
+    cachedModel.Compile("SGD", SgdParameter());
+
+    ClearGemmBlocking();
+    CHECK(LoadGemmTuningCache(path) == numEntries);
+    std::ifstream input(path);
+    for (std::string line; std::getline(input, line);)
+        if (!line.empty() && line.front() != '#' && line.front() != '[')
+            CHECK(line.substr(line.size() - blocking.size()) == blocking);
+    input.close();
+
+    std::remove(path.c_str());
+    ClearGemmBlocking();
+}
+
+void TestInferenceCompile()
+{
+    const std::size_t batchSize = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    //! Data set of a single batch, so both models predict the same batch
+    Model<float> model(device, batchSize);
+    const auto graph = AddBranchGraph(model, batchSize, batchSize);
+    model.Compile("SGD", SgdParameter());
+    for (std::size_t cycle = 0; cycle < 3; ++cycle)
+        model.Train();
+
+    Model<float> inferenceModel(device, batchSize);
+    const auto inferenceGraph =
+        AddBranchGraph(inferenceModel, batchSize, batchSize);
+    inferenceModel.CompileForInference();
+    CHECK(inferenceModel.ArenaByteSize() < model.ArenaByteSize());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  inferenceModel.ParameterSlab());
+
+    //! Losses are reduced by OpenMP threads in no particular order
+    model.Predict();
+    inferenceModel.Predict();
+    CHECK(inferenceModel.Output(inferenceGraph.Left).Data ==
+          model.Output(graph.Left).Data);
+    CHECK(inferenceModel.Output(inferenceGraph.Right).Data ==
+          model.Output(graph.Right).Data);
+    CHECK(inferenceModel.GetLoss(inferenceGraph.LeftLoss) ==
+          doctest::Approx(model.GetLoss(graph.LeftLoss)));
+    CHECK(inferenceModel.GetLoss(inferenceGraph.RightLoss) ==
+          doctest::Approx(model.GetLoss(graph.RightLoss)));
+
+    CHECK_THROWS(inferenceModel.Train());
+}
+
+void TestQuantizedInference()
+{
+    const std::size_t batchSize = 8;
+    const std::size_t numCalibrationBatches = 3;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    //! Data set of the calibration batches, so loaders of both models start
+    //! over at the first batch after calibration
+    const auto addGraph = [batchSize](Model<float>& model) {
+        const Shape inputShape({ 32 });
+        const auto input = model.Fetcher(
+            inputShape,
+            std::make_unique<BatchLoader>(
+                inputShape, batchSize,
+                RandomVector(batchSize * numCalibrationBatches * 32, 3)),
+            "input");
+        const auto hidden = model.ReLU(model.Dense(input, 32));
+        return model.Dense(hidden, 8);
+    };
+
+    Model<float> quantizedModel(device, batchSize);
+    const auto quantizedOutput = addGraph(quantizedModel);
+    CHECK_THROWS(quantizedModel.CompileForQuantizedInference(0));
+    quantizedModel.CompileForQuantizedInference(numCalibrationBatches);
+
+    Model<float> model(device, batchSize);
+    const auto output = addGraph(model);
+    model.CompileForInference();
+    Tensor<float>::CopyTensorData(quantizedModel.ParameterSlab(),
+                                  model.ParameterSlab());
+
+    for (std::size_t batchIdx = 0; batchIdx < numCalibrationBatches;
+         ++batchIdx)
+    {
+        quantizedModel.Predict();
+        model.Predict();
+        const auto quantized = quantizedModel.Output(quantizedOutput).Data;
+        const auto truth = model.Output(output).Data;
+
+        double squaredError = 0.0;
+        double squaredTruth = 0.0;
+        for (std::size_t idx = 0; idx < truth.size(); ++idx)
+        {
+            const auto error = static_cast<double>(quantized[idx] - truth[idx]);
+            squaredError += error * error;
+            squaredTruth += static_cast<double>(truth[idx]) * truth[idx];
+        }
+
+        //! Both layers run on int8, while uncalibrated input range or
+        //! quantization skipped altogether would give no error or errors
+        //! far beyond the bound
+        CHECK(squaredError > 0.0);
+        CHECK(std::sqrt(squaredError / squaredTruth) < 0.05);
+    }
+}
+
+void TestParameterSlab()
+{
+    const std::size_t batchSize = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+    const auto sgdParameter = Parameter(
+        {}, { { "LearningRate", 0.01f }, { "Momentum", 0.9f },
+              { "WeightDecay", 0.01f } },
+        {});
+
+    Model<float> model(device, batchSize);
+    const auto graph = AddBranchGraph(model, batchSize, batchSize);
+    model.Compile("SGD", sgdParameter);
+
+    //! Checkpoint restored with single copy predicts the same
+    Model<float> restoredModel(device, batchSize);
+    const auto restoredGraph =
+        AddBranchGraph(restoredModel, batchSize, batchSize);
+    restoredModel.Compile("SGD", sgdParameter);
+    CHECK(restoredModel.ParameterSlab().TotalElementSize() ==
+          model.ParameterSlab().TotalElementSize());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  restoredModel.ParameterSlab());
+
+    model.Predict();
+    restoredModel.Predict();
+    CHECK(restoredModel.Output(restoredGraph.Left).Data ==
+          model.Output(graph.Left).Data);
+    CHECK(restoredModel.Output(restoredGraph.Right).Data ==
+          model.Output(graph.Right).Data);
+
+    //! Updates over the slab match the optimizer applied to each tensor
+    //! with its own moments
+    std::vector<std::pair<AbsTensor<float>, std::string>> keyVector;
+    std::vector<Tensor<float>> referenceVector;
+    std::vector<Compute::OptimizerState<float>> stateVector(4);
+    referenceVector.reserve(4);
+    for (const auto& unit : { graph.Left, graph.Right })
+        for (const auto* key : { "weight", "bias" })
+        {
+            const auto tensorData = model.TrainableTensor(unit, key);
+            auto& state = stateVector[keyVector.size()];
+            keyVector.emplace_back(unit, key);
+            referenceVector.emplace_back(tensorData.TensorShape, 1, device,
+                                         tensorData.Data);
+            state.MomentVector.reserve(1);
+            state.MomentVector.emplace_back(tensorData.TensorShape, 1, device);
+            Compute::Zeros<float>().Initialize(state.MomentVector.back());
+        }
+
+    Compute::SGD<float> optimizer(0.01f, 0.9f, false, 0.01f);
+    for (std::size_t cycle = 0; cycle < 2; ++cycle)
+    {
+        model.Train();
+        for (std::size_t idx = 0; idx < keyVector.size(); ++idx)
+        {
+            const auto& [unit, key] = keyVector[idx];
+            const auto update = model.GradientTensor(unit, key);
+            const Tensor<float> updateTensor(update.TensorShape, 1, device,
+                                             update.Data);
+            optimizer.Optimize(referenceVector[idx], updateTensor,
+                               stateVector[idx]);
+
+            const auto parameters = model.TrainableTensor(unit, key);
+            for (std::size_t elemIdx = 0; elemIdx < parameters.Data.size();
+                 ++elemIdx)
+                CHECK(parameters.Data[elemIdx] ==
+                      doctest::Approx(referenceVector[idx].At(elemIdx)));
+        }
+    }
+}
+
+void TestQueuedParameterUpdates()
+{
+    const std::size_t batchSize = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    //! Updates run inline on a single thread
+    const auto numThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    Model<float> model(device, batchSize);
+    const auto graph = AddBranchGraph(model, batchSize, batchSize * 3);
+    model.Compile("SGD", SgdParameter());
+
+    //! Update queue is created by compilation with more than one thread,
+    //! and workers of the pool push to it concurrently
+    omp_set_num_threads(4);
+    Model<float> queuedModel(device, batchSize);
+    const auto queuedGraph =
+        AddBranchGraph(queuedModel, batchSize, batchSize * 3);
+    queuedModel.Compile("SGD", SgdParameter());
+
+    Model<float> asyncModel(device, batchSize);
+    const auto asyncGraph =
+        AddBranchGraph(asyncModel, batchSize, batchSize * 3);
+    asyncModel.Compile("SGD", SgdParameter());
+    omp_set_num_threads(numThreads);
+
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  queuedModel.ParameterSlab());
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  asyncModel.ParameterSlab());
+
+    for (std::size_t cycle = 0; cycle < 10; ++cycle)
+    {
+        model.Train();
+        queuedModel.Train();
+        asyncModel.AsyncTrain();
+    }
+
+    //! Slabs are compared without padding, which holds whatever the
+    //! loaders left in padding of the inputs
+    const auto parameters = BranchGraphParameters(model, graph);
+    CheckApproxEqual(BranchGraphParameters(queuedModel, queuedGraph),
+                     parameters);
+    CheckApproxEqual(BranchGraphParameters(asyncModel, asyncGraph),
+                     parameters);
+}
+
+void TestBFloat16Training()
+{
+    const std::size_t batchSize = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+    const auto numThreads = omp_get_max_threads();
+
+    //! Inline updates, updates on the update queue and updates after
+    //! accumulating two micro batches
+    for (const auto& [numCompileThreads, numMicroBatches] :
+         { std::pair<int, std::size_t>{ 1, 1 }, { 4, 1 }, { 1, 2 } })
+    {
+        //! Data set is a single batch, so predictions between the cycles do
+        //! not shift the batches the model trains on
+        omp_set_num_threads(numCompileThreads);
+        Model<float> model(device, batchSize);
+        const auto graph = AddBranchGraph(model, batchSize, batchSize);
+        model.SetStorageType(Compute::StorageType::BFloat16);
+        model.EnableGradientAccumulation(numMicroBatches);
+        model.Compile("SGD", SgdParameter());
+
+        Model<float> floatModel(device, batchSize);
+        const auto floatGraph = AddBranchGraph(floatModel, batchSize,
+                                               batchSize);
+        floatModel.EnableGradientAccumulation(numMicroBatches);
+        floatModel.Compile("SGD", SgdParameter());
+        omp_set_num_threads(numThreads);
+
+        Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                      floatModel.ParameterSlab());
+
+        for (std::size_t cycle = 0; cycle < 10; ++cycle)
+        {
+            model.Train();
+            floatModel.Train();
+
+            //! Products read the master weight rounded to bfloat16 with
+            //! float bias
+            model.Predict();
+            const auto input = model.Output(graph.Input).Data;
+            for (const auto& unit : { graph.Left, graph.Right })
+            {
+                const auto weight = model.TrainableTensor(unit, "weight").Data;
+                const auto bias = model.TrainableTensor(unit, "bias").Data;
+                const auto output = model.Output(unit).Data;
+                const auto numInputs = input.size() / batchSize;
+                const auto numOutputs = bias.size();
+                std::vector<float> expected(output.size());
+                for (std::size_t batchIdx = 0; batchIdx < batchSize;
+                     ++batchIdx)
+                    for (std::size_t col = 0; col < numOutputs; ++col)
+                    {
+                        auto sum = bias[col];
+                        for (std::size_t row = 0; row < numInputs; ++row)
+                            sum += input[batchIdx * numInputs + row] *
+                                   Compute::BFloat16(
+                                       weight[row * numOutputs + col]);
+                        expected[batchIdx * numOutputs + col] = sum;
+                    }
+                CheckApproxEqual(output, expected);
+            }
+        }
+
+        //! Master weights follow the float model up to rounding of the
+        //! products
+        const auto parameters = BranchGraphParameters(model, graph);
+        const auto floatParameters =
+            BranchGraphParameters(floatModel, floatGraph);
+        CHECK(parameters.size() == floatParameters.size());
+        for (std::size_t idx = 0; idx < parameters.size(); ++idx)
+            CHECK(parameters[idx] ==
+                  doctest::Approx(floatParameters[idx]).epsilon(1e-2));
+    }
+}
+
+void TestSoftMaxCrossEntropyFusion()
+{
+    const std::size_t batchSize = 4;
+    const std::size_t dataSetSize = batchSize * 3;
+    const std::size_t numClasses = 4;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    //! SoftMax and CrossEntropy only compute the same gradient as the fused
+    //! unit when each label sums up to 1
+    std::vector<float> labelDataSet(dataSetSize * numClasses, 0.0f);
+    std::mt19937 engine(5);
+    for (std::size_t sampleIdx = 0; sampleIdx < dataSetSize; ++sampleIdx)
+        labelDataSet[sampleIdx * numClasses + engine() % numClasses] = 1.0f;
+
+    struct ClassifierGraph
+    {
+        AbsTensor<float> Label;
+        AbsTensor<float> Dense;
+        AbsTensor<float> SoftMax;
+        AbsTensor<float> Loss;
+    };
+    const auto addGraph = [&](Model<float>& model) {
+        const Shape inputShape({ 12 });
+        const Shape labelShape({ numClasses });
+        const auto input = model.Fetcher(
+            inputShape,
+            std::make_unique<BatchLoader>(inputShape, batchSize,
+                                          RandomVector(dataSetSize * 12, 3)),
+            "input");
+        const auto label = model.Fetcher(
+            labelShape,
+            std::make_unique<BatchLoader>(labelShape, batchSize,
+                                          labelDataSet),
+            "label");
+        const auto dense = model.Dense(input, numClasses);
+        const auto softMax = model.SoftMax(dense);
+        const auto loss = model.CrossEntropy(softMax, label, "loss");
+        return ClassifierGraph{ label, dense, softMax, loss };
+    };
+
+    Model<float> model(device, batchSize);
+    const auto graph = addGraph(model);
+    model.Compile("SGD", SgdParameter());
+
+    //! Twin whose loss is kept runs SoftMax and CrossEntropy separately
+    Model<float> unfusedModel(device, batchSize);
+    const auto unfusedGraph = addGraph(unfusedModel);
+    unfusedModel.KeepOutput(unfusedGraph.Loss);
+    unfusedModel.Compile("SGD", SgdParameter());
+    CHECK(unfusedModel.ForwardSchedule().size() ==
+          model.ForwardSchedule().size() + 1);
+
+    Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                  unfusedModel.ParameterSlab());
+
+    for (std::size_t cycle = 0; cycle < 10; ++cycle)
+    {
+        model.Train();
+        unfusedModel.Train();
+        CHECK(model.GetLoss(graph.Loss) ==
+              doctest::Approx(unfusedModel.GetLoss(unfusedGraph.Loss)));
+    }
+
+    for (const auto* key : { "weight", "bias" })
+        CheckApproxEqual(model.TrainableTensor(graph.Dense, key).Data,
+                         unfusedModel.TrainableTensor(unfusedGraph.Dense, key)
+                         .Data);
+
+    //! Output of the fused loss is the probability, while the kept loss
+    //! outputs -label * log(probability) for each element
+    model.Predict();
+    unfusedModel.Predict();
+    const auto probability = unfusedModel.Output(unfusedGraph.SoftMax).Data;
+    const auto label = unfusedModel.Output(unfusedGraph.Label).Data;
+    const auto lossOutput = unfusedModel.Output(unfusedGraph.Loss).Data;
+    CheckApproxEqual(model.Output(graph.Loss).Data, probability);
+    CheckApproxEqual(model.Output(graph.SoftMax).Data, probability);
+    for (std::size_t idx = 0; idx < lossOutput.size(); ++idx)
+        CHECK(lossOutput[idx] ==
+              doctest::Approx(-label[idx] * std::log(probability[idx])));
+}
+
+void TestGradientAccumulation()
+{
+    const std::size_t batchSize = 8;
+    const std::size_t numSteps = 5;
+    const auto device = Compute::Device(0, Compute::DeviceType::CPU, "device0");
+
+    for (const auto* optimizerName : { "SGD", "Adam" })
+        for (const std::size_t numMicroBatches : { 2, 4 })
+        {
+            //! Data set is a single batch, which the accumulating model
+            //! loads in numMicroBatches consecutive micro batches
+            Model<float> model(device, batchSize);
+            const auto graph = AddBranchGraph(model, batchSize, batchSize);
+            model.Compile(optimizerName, SgdParameter());
+
+            const auto microBatchSize = batchSize / numMicroBatches;
+            Model<float> accumulatingModel(device, microBatchSize);
+            const auto accumulatingGraph =
+                AddBranchGraph(accumulatingModel, microBatchSize, batchSize);
+            accumulatingModel.EnableGradientAccumulation(numMicroBatches);
+            accumulatingModel.Compile(optimizerName, SgdParameter());
+
+            CHECK(accumulatingModel.ParameterSlab().TotalElementSize() ==
+                  model.ParameterSlab().TotalElementSize());
+            Tensor<float>::CopyTensorData(model.ParameterSlab(),
+                                          accumulatingModel.ParameterSlab());
+
+            for (std::size_t step = 0; step < numSteps; ++step)
+            {
+                model.Train();
+                for (std::size_t idx = 0; idx < numMicroBatches; ++idx)
+                    accumulatingModel.Train();
+            }
+
+            CheckApproxEqual(
+                BranchGraphParameters(accumulatingModel, accumulatingGraph),
+                BranchGraphParameters(model, graph));
+        }
+}
+} // namespace Takion::Test
@@ -0,0 +1,76 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_TEST_ENGINETEST_HPP
+#define TAKION_TEST_ENGINETEST_HPP
+
+namespace Takion::Test
+{
+//! Output of dense unit fused with its activation is not observable unless
+//! it is kept, while dense unit which is kept or not fused has its own output
+void TestFusedActivationOutput();
+
+//! Compiling the model again fuses the graph the user built, and predicts
+//! the same as the model compiled once with the same parameters
+void TestRecompile();
+
+//! Order of the execution plan and number of dependencies of each step on
+//! graph with two branches
+void TestExecutionPlan();
+
+//! Training on the worker pool gives the same losses and parameters as
+//! sequential training
+void TestAsyncTrainEquivalence();
+
+//! Fit loading cycles in advance trains the same parameters and calls the
+//! loaders once per cycle
+void TestPrefetchedFit();
+
+//! Arena of compiled model is smaller than tensors it holds, and training
+//! through it, sequentially or on the worker pool, matches training without
+//! memory sharing
+void TestArenaPlanning();
+
+//! Convolutions with fused activations train the same parameters with and
+//! without memory sharing in the arena
+void TestConv2DTraining();
+
+//! Compilation with GEMM tuning saves the shapes of dense units in the
+//! cache, and the next compilation loads them without benchmarking again
+void TestGemmTuningCompile();
+
+//! Model compiled for inference predicts the same as the model compiled for
+//! training with the same parameters, in a smaller arena, and cannot train
+void TestInferenceCompile();
+
+//! Copy of the parameter slab restores a model, and optimizer applied over
+//! the slab matches the optimizer applied to each trainable tensor
+void TestParameterSlab();
+
+//! Model calibrated and quantized through CompileForQuantizedInference
+//! predicts close to the float model with the same parameter slab
+void TestQuantizedInference();
+
+//! Updates applied on the update queue, from back propagation on the caller
+//! or on the worker pool, match updates applied inline
+void TestQueuedParameterUpdates();
+
+//! Bfloat16 copy of dense weights is refreshed after every optimizer step,
+//! applied inline, on the update queue or after accumulated micro batches,
+//! and master weights train like the float model
+void TestBFloat16Training();
+
+//! SoftMax -> CrossEntropy fused into single unit trains the same losses and
+//! parameters as the twin whose loss is kept out of fusion, and its output
+//! is the SoftMax probability
+void TestSoftMaxCrossEntropyFusion();
+
+//! Model accumulating gradients of micro batches trains the same parameters
+//! as the model propagating the whole batch at once
+void TestGradientAccumulation();
+}
+
+#endif
@@ -10,8 +10,10 @@
 #include "UtilTests/SharedPtrTests.hpp"
 #include "UtilTests/WeakPtrTests.hpp"
 #include "UtilTests/TensorTest.hpp"
+#include "UtilTests/TaskExecutorTest.hpp"
 #include "ComputeTests/ComputeTest.hpp"
 #include "GraphTest/SimpleGraphTest.hpp"
+#include "GraphTest/EngineTest.hpp"
 #include <doctest.h>
 #include <iostream>
 
@@ -186,6 +188,217 @@ namespace Takion::Test
 //     }
 // }
 
+TEST_CASE("Tensor data sharing")
+{
+    TensorShareData<float>();
+    TensorShareData<int>();
+}
+
+TEST_CASE("Gemm test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    SUBCASE("Batch reduced multiply")
+    {
+        TestBatchReducedMultiply<float>(device);
+        TestBatchReducedMultiply<int>(device);
+    }
+    SUBCASE("Transposed multiply")
+    {
+        TestTransposedMultiply<float>(device);
+        TestTransposedMultiply<int>(device);
+    }
+    SUBCASE("Fused bias and activation")
+    {
+        TestMultiplyBiasActivation<float>(device, Activation::Linear);
+        TestMultiplyBiasActivation<float>(device, Activation::Relu);
+        TestMultiplyBiasActivation<float>(device, Activation::Sigmoid);
+        TestMultiplyBiasActivation<int>(device, Activation::Relu);
+    }
+}
+
+TEST_CASE("Instruction set dispatch test")
+{
+    for (const auto instructionSet :
+         { Compute::InstructionSet::AVX2, Compute::InstructionSet::AVX512,
+           Compute::InstructionSet::AVX512VNNI })
+    {
+        Compute::Device device(0, Compute::DeviceType::CPU, "device");
+        if (!Compute::IsSupported(instructionSet))
+        {
+            CHECK_THROWS(device.SetInstructionSet(instructionSet));
+            continue;
+        }
+
+        device.SetInstructionSet(instructionSet);
+        CHECK(device.InstructionSet() == instructionSet);
+        CHECK(device.PadByteSize() ==
+              Compute::VectorByteSize(instructionSet));
+
+        TestMultiply<float>(device);
+        TestTransposedMultiply<float>(device);
+        TestMultiplyBiasActivation<float>(device, Activation::Relu);
+        TestMultiplyBiasActivation<float>(device, Activation::Sigmoid);
+        TestQuantizedMultiplyBiasActivation(device, Activation::Relu);
+    }
+}
+
+TEST_CASE("Transpose test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestTranspose<float>(device);
+    TestTranspose<int>(device);
+    TestTransposeBatchFold<float>(device);
+    TestTransposeBatchFold<int>(device);
+    TestTransposeBatchFold<double>(device);
+}
+
+TEST_CASE("Shrink test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestShrink<float>(device);
+    TestShrink<int>(device);
+    TestShrinkDeterministic<float>(device);
+}
+
+TEST_CASE("Quantized multiply test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestQuantizedMultiplyBiasActivation(device, Activation::Linear);
+    TestQuantizedMultiplyBiasActivation(device, Activation::Relu);
+    TestQuantizedMultiplyBiasActivation(device, Activation::Sigmoid);
+}
+
+TEST_CASE("GEMM tuning test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestGemmTuning(device);
+}
+
+TEST_CASE("Optimizer test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestOptimizer<Compute::SGD>(device, 0.1f);
+    TestOptimizer<Compute::SGD>(device, 0.1f, 0.9f, false, 0.01f);
+    TestOptimizer<Compute::SGD>(device, 0.1f, 0.9f, true, 0.0f);
+    TestOptimizer<Compute::Adam>(device, 0.01f, 0.9f, 0.999f, 1e-8f, 0.01f,
+                                 false);
+    TestOptimizer<Compute::Adam>(device, 0.01f, 0.9f, 0.999f, 1e-8f, 0.01f,
+                                 true);
+}
+
+TEST_CASE("Conv2D test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestConv2D(device, 1, 0, 1);
+    TestConv2D(device, 2, 1, 1);
+    TestConv2D(device, 1, 2, 2);
+}
+
+TEST_CASE("BFloat16 multiply test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestBFloat16MultiplyBiasActivation(device, Activation::Linear);
+    TestBFloat16MultiplyBiasActivation(device, Activation::Relu);
+}
+
+TEST_CASE("Transcendental function test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestTranscendental<float>(device);
+    TestTranscendental<double>(device);
+}
+
+TEST_CASE("Element wise map reduce test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestMapReduce<float>(device);
+    TestMapReduce<double>(device);
+}
+
+TEST_CASE("SoftMax cross entropy test")
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device");
+    TestSoftMaxCrossEntropy<float>(device);
+    TestSoftMaxCrossEntropy<double>(device);
+}
+
+TEST_CASE("TaskExecutor test")
+{
+    for (const std::size_t numWorkers : { 1, 2, 4 })
+    {
+        TestTaskExecutorDependency(numWorkers);
+        TestTaskExecutorException(numWorkers);
+        TestTaskExecutorManyTasks(numWorkers);
+    }
+}
+
+TEST_CASE("Engine test")
+{
+    SUBCASE("Fused activation output")
+    {
+        TestFusedActivationOutput();
+    }
+    SUBCASE("Recompile")
+    {
+        TestRecompile();
+    }
+    SUBCASE("Execution plan")
+    {
+        TestExecutionPlan();
+    }
+    SUBCASE("Async train equivalence")
+    {
+        TestAsyncTrainEquivalence();
+    }
+    SUBCASE("Prefetched fit")
+    {
+        TestPrefetchedFit();
+    }
+    SUBCASE("Arena planning")
+    {
+        TestArenaPlanning();
+    }
+    SUBCASE("Conv2D training")
+    {
+        TestConv2DTraining();
+    }
+    SUBCASE("GEMM tuning compile")
+    {
+        TestGemmTuningCompile();
+    }
+    SUBCASE("Inference compile")
+    {
+        TestInferenceCompile();
+    }
+    SUBCASE("Parameter slab")
+    {
+        TestParameterSlab();
+    }
+    SUBCASE("Quantized inference")
+    {
+        TestQuantizedInference();
+    }
+    SUBCASE("Queued parameter updates")
+    {
+        TestQueuedParameterUpdates();
+    }
+
+    SUBCASE("BFloat16 training")
+    {
+        TestBFloat16Training();
+    }
+
+    SUBCASE("SoftMax cross entropy fusion")
+    {
+        TestSoftMaxCrossEntropyFusion();
+    }
+
+    SUBCASE("Gradient accumulation")
+    {
+        TestGradientAccumulation();
+    }
+}
+
 TEST_CASE("GraphTest")
 {
     // SUBCASE("SimpleGraph - ReLU")
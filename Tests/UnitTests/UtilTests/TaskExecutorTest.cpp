@@ -0,0 +1,109 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#include "TaskExecutorTest.hpp"
+#include <Takion/Engine/TaskExecutor.hpp>
+#include <doctest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace Takion::Test
+{
+using Engine::TaskExecutor;
+
+void TestTaskExecutorDependency(std::size_t numWorkers)
+{
+    TaskExecutor executor(numWorkers, 1);
+
+    //! 0 -> (1, 2) -> 3
+    const std::vector<std::vector<std::size_t>> successorVector = {
+        { 1, 2 }, { 3 }, { 3 }, {}
+    };
+    const std::vector<std::size_t> numDependencyVector = { 0, 1, 1, 2 };
+
+    for (std::size_t iteration = 0; iteration < 100; ++iteration)
+    {
+        std::atomic<std::size_t> counter = 0;
+        std::vector<std::size_t> orderVector(4, 0);
+        executor.Run(
+            [&counter, &orderVector](std::size_t taskIdx) {
+                orderVector[taskIdx] = counter.fetch_add(1);
+            },
+            successorVector, numDependencyVector);
+
+        CHECK(counter == 4);
+        CHECK(orderVector[0] == 0);
+        CHECK(orderVector[1] < orderVector[3]);
+        CHECK(orderVector[2] < orderVector[3]);
+        CHECK(orderVector[3] == 3);
+    }
+}
+
+void TestTaskExecutorException(std::size_t numWorkers)
+{
+    TaskExecutor executor(numWorkers, 1);
+
+    //! 0 -> (1, 2) -> 3, where 1 throws
+    const std::vector<std::vector<std::size_t>> successorVector = {
+        { 1, 2 }, { 3 }, { 3 }, {}
+    };
+    const std::vector<std::size_t> numDependencyVector = { 0, 1, 1, 2 };
+
+    std::vector<std::atomic<std::size_t>> numRunVector(4);
+    const auto task = [&numRunVector](std::size_t taskIdx) {
+        numRunVector[taskIdx].fetch_add(1);
+        if (taskIdx == 1)
+            throw std::runtime_error("Task failed");
+    };
+
+    CHECK_THROWS(executor.Run(task, successorVector, numDependencyVector));
+    for (const auto& numRun : numRunVector)
+        CHECK(numRun == 1);
+
+    std::atomic<std::size_t> counter = 0;
+    executor.Run([&counter](std::size_t) { counter.fetch_add(1); },
+                 successorVector, numDependencyVector);
+    CHECK(counter == 4);
+}
+
+void TestTaskExecutorManyTasks(std::size_t numWorkers)
+{
+    TaskExecutor executor(numWorkers, 1);
+
+    //! Independent tasks released by single root, each followed by a chain
+    //! of 3 tasks, so workers have to steal
+    const std::size_t numChains = 256;
+    const std::size_t chainLength = 3;
+    const auto numTasks = 1 + numChains * chainLength;
+    std::vector<std::vector<std::size_t>> successorVector(numTasks);
+    std::vector<std::size_t> numDependencyVector(numTasks, 1);
+    numDependencyVector[0] = 0;
+    for (std::size_t chainIdx = 0; chainIdx < numChains; ++chainIdx)
+    {
+        const auto begin = 1 + chainIdx * chainLength;
+        successorVector[0].emplace_back(begin);
+        for (std::size_t idx = begin; idx + 1 < begin + chainLength; ++idx)
+            successorVector[idx].emplace_back(idx + 1);
+    }
+
+    std::vector<std::atomic<std::size_t>> numRunVector(numTasks);
+    std::atomic<bool> isOrdered = true;
+    executor.Run(
+        [&numRunVector, &isOrdered](std::size_t taskIdx) {
+            //! Previous task of the chain has to be finished
+            if (taskIdx > 0 && (taskIdx - 1) % chainLength != 0 &&
+                numRunVector[taskIdx - 1] != 1)
+                isOrdered = false;
+            numRunVector[taskIdx].fetch_add(1);
+        },
+        successorVector, numDependencyVector);
+
+    CHECK(isOrdered);
+    for (const auto& numRun : numRunVector)
+        CHECK(numRun == 1);
+}
+} // namespace Takion::Test
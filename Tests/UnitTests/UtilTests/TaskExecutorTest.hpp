@@ -0,0 +1,25 @@
+// Copyright (c) 2020, Jaewoo Kim
+
+// We are making my contributions/submissions to this project solely in our
+// personal capacity and are not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef TAKION_TEST_TASKEXECUTORTEST_HPP
+#define TAKION_TEST_TASKEXECUTORTEST_HPP
+
+#include <cstddef>
+
+namespace Takion::Test
+{
+//! Diamond shaped graph runs each task after the tasks it depends on
+void TestTaskExecutorDependency(std::size_t numWorkers);
+
+//! Exception of a task is rethrown after every other task of the graph
+//! finished, and the executor can run graphs afterwards
+void TestTaskExecutorException(std::size_t numWorkers);
+
+//! Graph with far more tasks than workers runs every task exactly once
+void TestTaskExecutorManyTasks(std::size_t numWorkers);
+}
+
+#endif
@@ -202,6 +202,66 @@ void TensorMoveData()
         CHECK(static_cast<T>(i) == destTensor.At(i));
     }
 }
+
+template <typename T>
+void TensorShareData()
+{
+    Compute::Device device(0, Compute::DeviceType::CPU, "device0");
+
+    const Shape shape({ 5, 3 });
+    const auto batchSize = 4;
+    const auto totalSize = shape.Size() * batchSize;
+    std::vector<T> vector(totalSize);
+
+    for (std::size_t i = 0; i < totalSize; ++i)
+    {
+        vector.at(i) = static_cast<T>(i);
+    }
+
+    Tensor<T> sourceTensor(shape, batchSize, device, vector);
+    Tensor<T> destTensor(shape, batchSize, device);
+
+    Tensor<T>::ShareTensorData(sourceTensor, destTensor);
+    CHECK(destTensor.Data.Base() == sourceTensor.Data.Base());
+
+    //! Writes to the source are visible through the destination
+    for (std::size_t i = 0; i < totalSize; ++i)
+        sourceTensor.At(i) = static_cast<T>(2 * i);
+    for (std::size_t i = 0; i < totalSize; ++i)
+        CHECK(static_cast<T>(2 * i) == destTensor.At(i));
+
+    //! Shared tensor can be the source of a copy
+    Tensor<T> copiedTensor(shape, batchSize, device);
+    Tensor<T>::CopyTensorData(destTensor, copiedTensor);
+    for (std::size_t i = 0; i < totalSize; ++i)
+        CHECK(static_cast<T>(2 * i) == copiedTensor.At(i));
+
+    //! Copying into the destination allocates its own buffer
+    Tensor<T> otherTensor(shape, batchSize, device, vector);
+    Tensor<T>::CopyTensorData(otherTensor, destTensor);
+    CHECK(destTensor.Data.Base() != sourceTensor.Data.Base());
+    for (std::size_t i = 0; i < totalSize; ++i)
+    {
+        CHECK(static_cast<T>(i) == destTensor.At(i));
+        CHECK(static_cast<T>(2 * i) == sourceTensor.At(i));
+    }
+
+    //! Resizing the destination does not deallocate buffer of the source
+    Tensor<T>::ShareTensorData(sourceTensor, destTensor);
+    destTensor.ChangeBatchSize(batchSize * 2);
+    CHECK(destTensor.Data.Base() != sourceTensor.Data.Base());
+    for (std::size_t i = 0; i < totalSize; ++i)
+        CHECK(static_cast<T>(2 * i) == sourceTensor.At(i));
+
+    //! Tensor of different layout can refer to part of the source
+    const Shape subShape({ 8 });
+    const std::size_t offset = 16;
+    Tensor<T> subTensor(subShape, 2, device);
+    Tensor<T>::ShareTensorData(sourceTensor, subTensor, offset);
+    CHECK(subTensor.Data.Base() == sourceTensor.Data.Base() + offset);
+    CHECK_THROWS(Tensor<T>::ShareTensorData(
+        sourceTensor, subTensor, sourceTensor.TotalElementSize()));
+}
 }
 
 